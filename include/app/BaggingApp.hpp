@@ -14,6 +14,14 @@ struct BaggingOptions {
     std::string prunerType;      
     double      prunerParam;     
     uint32_t    seed;           
+    double      oobStopTol = 0.0;   // > 0: stop once the OOB curve flattens
+    int         oobWindow  = 10;    // Trees per OOB check
+    double      anytimeTol = 0.0;   // > 0: also report anytime prediction at this std. error
+    std::string pruneMethod;        // "greedy": prune the forest on a held-out 20% of train
+    double      pruneTol   = 0.01;
+    int         distillTrees   = 0;   // > 0: distill the forest into a GBRT student of this many trees
+    int         distillDepth   = 4;
+    int         distillAugment = 2;   // Leaf-box samples per training row
 };
 
 void runBaggingApp(const BaggingOptions& opts);
\ No newline at end of file
@@ -39,6 +39,10 @@ struct RegressionBoostingOptions {
     bool dartSkipDropForPrediction = false;
     std::string dartStrategy = "uniform";
     uint32_t dartSeed = 42;        
+    
+    // Post-training ensemble pruning on a held-out valSplit ("greedy"/"omp")
+    std::string pruneMethod;
+    double pruneTol = 0.01;
 };
 
 void runRegressionBoostingApp(const RegressionBoostingOptions& options);
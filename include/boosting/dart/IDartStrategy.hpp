@@ -3,17 +3,18 @@
 #include "boosting/model/RegressionBoostingModel.hpp"
 #include <vector>
 #include <memory>
-#include <random>
+#include "functions/random/CounterRng.hpp"
 
 class IDartStrategy {
 public:
     virtual ~IDartStrategy() = default;
     
-    // Select trees to drop during training
+    // Select trees to drop during training; rng is the iteration's own
+    // DartDrop stream, so the drop set depends only on (seed, iteration)
     virtual std::vector<int> selectDroppedTrees(
         int totalTrees, 
         double dropRate,
-        std::mt19937& gen) const = 0;
+        CounterRng& rng) const = 0;
     
     // Compute prediction with dropout
     virtual double computeDropoutPrediction(
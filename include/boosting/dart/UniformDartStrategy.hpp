@@ -21,7 +21,7 @@ public:
     
     // Original interface methods
     std::vector<int> selectDroppedTrees(int totalTrees, double dropRate, 
-                                       std::mt19937& gen) const override;
+                                       CounterRng& rng) const override;
     
     double computeDropoutPrediction(
         const std::vector<RegressionBoostingModel::RegressionTree>& trees,
@@ -90,7 +90,7 @@ public:
     std::vector<int> selectDroppedTreesAdaptive(
         const std::vector<RegressionBoostingModel::RegressionTree>& trees,
         double dropRate,
-        std::mt19937& gen) const;
+        CounterRng& rng) const;
 
 private:
     bool normalizeWeights_;
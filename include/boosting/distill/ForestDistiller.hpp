@@ -0,0 +1,85 @@
+// =============================================================================
+// include/boosting/distill/ForestDistiller.hpp - Forest -> small GBRT student
+// =============================================================================
+#pragma once
+
+#include "boosting/trainer/GBRTTrainer.hpp"
+#include "tree/Node.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Student settings: a few dozen shallow trees fitted to the teacher's outputs
+struct DistillConfig {
+    int         numTrees       = 30;
+    int         maxDepth       = 4;
+    double      learningRate   = 0.2;
+    int         minSamplesLeaf = 5;
+    std::string splitMethod    = "exhaustive";
+    int         augmentFactor  = 2;      // Leaf-box samples per training row
+    uint32_t    seed           = 42;
+};
+
+// Fidelity of a student to its teacher on a held-out set
+struct DistillReport {
+    double teacherMSE   = 0.0;   // Teacher vs labels
+    double studentMSE   = 0.0;   // Student vs labels
+    double fidelityMSE  = 0.0;   // Student vs teacher
+    double fidelityR2   = 0.0;   // 1 - fidelityMSE / Var(teacher)
+    long long teacherPredictUs = 0;
+    long long studentPredictUs = 0;
+};
+
+/**
+ * Compresses a tree-averaging teacher (bagging / MPI bagging forest) into a
+ * small GBRT student. The student is trained on the training rows plus
+ * augmented rows, all labelled by the teacher:
+ *
+ *   augmented row i: draw a training row x and a teacher tree t from the
+ *   row's own counter-based stream, find x's leaf in t, and redraw every
+ *   feature that leaf's path constrains uniformly inside the leaf's box
+ *   (clipped to the feature's training range); other features keep x's value.
+ *
+ * Samples therefore stay on the data manifold but cover the regions between
+ * training points where the teacher's trees disagree.
+ */
+class ForestDistiller {
+public:
+    // Teacher prediction over row-major rows
+    using Teacher = std::function<void(const std::vector<double>& X,
+                                       int rowLength,
+                                       std::vector<double>& predictions)>;
+
+    explicit ForestDistiller(const DistillConfig& config = DistillConfig());
+
+    // Fills augmentFactor augmented rows per row of X into `out` (row-major).
+    // trees[k] is global tree treeIds[k] of a forest of `totalTrees`; only
+    // rows that drew one of them are written (others are zeroed), so ranks
+    // holding disjoint sets of trees can sum their buffers into the full,
+    // rank-independent set.
+    void sampleLeafBoxes(const std::vector<const Node*>& trees,
+                         const std::vector<int>& treeIds,
+                         int totalTrees,
+                         const std::vector<double>& X,
+                         int rowLength,
+                         std::vector<double>& out) const;
+
+    // Trains the student on X plus `augmented`, labelled by `teacher`
+    std::unique_ptr<GBRTTrainer> train(const Teacher& teacher,
+                                       const std::vector<double>& X,
+                                       int rowLength,
+                                       const std::vector<double>& augmented) const;
+
+    static DistillReport evaluate(const Teacher& teacher,
+                                  const GBRTTrainer& student,
+                                  const std::vector<double>& X,
+                                  int rowLength,
+                                  const std::vector<double>& y);
+
+    const DistillConfig& config() const { return config_; }
+
+private:
+    DistillConfig config_;
+};
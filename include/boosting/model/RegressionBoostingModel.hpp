@@ -1,6 +1,8 @@
 #pragma once
 
 #include "tree/Node.hpp"
+#include "ensemble/PermutationImportance.hpp"
+#include "ensemble/EnsemblePruner.hpp"
 #include <vector>
 #include <memory>
 
@@ -103,6 +105,48 @@ public:
         return importance;
     }
     
+    // Increase in MSE on (X, y) - typically held-out rows - when each
+    // feature is permuted; only rows whose paths test it are re-routed
+    std::vector<double> getPermutationImportance(const std::vector<double>& X,
+                                                 int rowLength,
+                                                 const std::vector<double>& y,
+                                                 uint32_t seed = 42) const {
+        PermutationImportance::Ensemble ensemble;
+        for (const auto& regTree : trees_) {
+            ensemble.trees.push_back(regTree.tree.get());
+            ensemble.treeWeights.push_back(regTree.learningRate * regTree.weight);
+        }
+        ensemble.rowScale.assign(y.size(), 1.0);
+        return PermutationImportance::compute(ensemble, X, rowLength, y,
+                                              predictBatch(X, rowLength), seed);
+    }
+    
+    // Keeps the trees the pruner selects on (X_val, y_val); their weights are
+    // replaced by the selection's (learning rate folded in) and the base
+    // score by its intercept
+    EnsembleSelection pruneTrees(const EnsemblePruner& pruner,
+                                 const std::vector<double>& X_val,
+                                 int rowLength,
+                                 const std::vector<double>& y_val) {
+        // Nothing to select on: leave the model as it is
+        if (y_val.empty() || trees_.empty()) return EnsembleSelection();
+        std::vector<const Node*> roots;
+        std::vector<double> factors;
+        for (const auto& regTree : trees_) {
+            roots.push_back(regTree.tree.get());
+            factors.push_back(regTree.learningRate * regTree.weight);
+        }
+        EnsembleSelection sel = pruner.selectAdditive(roots, factors, baseScore_, X_val, rowLength, y_val);
+        std::vector<RegressionTree> kept;
+        kept.reserve(sel.trees.size());
+        for (size_t k = 0; k < sel.trees.size(); ++k) {
+            kept.emplace_back(std::move(trees_[sel.trees[k]].tree), sel.weights[k], 1.0);
+        }
+        trees_ = std::move(kept);
+        baseScore_ = sel.baseScore;
+        return sel;
+    }
+    
     // Clean up resources
     void clear() {
         trees_.clear();
@@ -10,7 +10,6 @@
 #include <memory>
 #include <iostream>
 #include <vector>
-#include <random>
 
 struct GBRTConfig {
     // Basic parameters
@@ -46,8 +45,8 @@ struct GBRTConfig {
     std::string dartWeightStrategy = "mild";
     
     // Enhanced: Parallel optimization parameters
-    int parallelThreshold = 1000;      // Minimum samples for parallel execution
-    int chunkSize = 2048;              // Parallel chunk size
+    int parallelThreshold = 0;         // Minimum samples for parallel execution (0 = calibrated profile)
+    int chunkSize = 0;                 // Parallel chunk size (0 = calibrated profile)
     bool enableVectorization = true;   // Enable vectorization optimization
     bool enableMemoryPool = true;      // Enable memory pool
 };
@@ -61,6 +60,10 @@ public:
                int rowLength,
                const std::vector<double>& y);
     
+    // Trains on a prebuilt column-major matrix
+    void train(const FeatureMatrix& X,
+               const std::vector<double>& y);
+    
     double predict(const double* sample, int rowLength) const;
     
     std::vector<double> predictBatch(
@@ -74,6 +77,14 @@ public:
                   double& mae);
     
     const RegressionBoostingModel* getModel() const { return &model_; }
+    
+    // Post-training ensemble pruning on a validation set (see EnsemblePruner)
+    EnsembleSelection pruneEnsemble(const EnsemblePruner& pruner,
+                                    const std::vector<double>& X_val,
+                                    int rowLength,
+                                    const std::vector<double>& y_val) {
+        return model_.pruneTrees(pruner, X_val, rowLength, y_val);
+    }
     std::string name() const { return "GBRT_Optimized"; }
     
     const std::vector<double>& getTrainingLoss() const { return trainingLoss_; }
@@ -82,6 +93,12 @@ public:
         return model_.getFeatureImportance(numFeatures);
     }
     
+    std::vector<double> getPermutationImportance(const std::vector<double>& X,
+                                                 int rowLength,
+                                                 const std::vector<double>& y) const {
+        return model_.getPermutationImportance(X, rowLength, y);
+    }
+    
     void setValidationData(const std::vector<double>& X_val,
                           const std::vector<double>& y_val,
                           int rowLength) {
@@ -106,17 +123,34 @@ private:
     
     // DART components
     std::unique_ptr<IDartStrategy> dartStrategy_;
-    mutable std::mt19937 dartGen_;
+    
+    // Parallel granularity resolved from config or the calibrated profile
+    size_t parallelThreshold_ = 1000;
+    int chunkSize_ = 2048;
+    size_t traversalThreshold_ = 500;
+    int traversalChunk_ = 512;
     
     // Core optimization methods
+    // `presort` is the per-feature row order of `columns`, built once in
+    // train() and shared by every round (empty when the finder does not sort)
     void trainStandardOptimized(const std::vector<double>& X,
+                               const FeatureMatrix& columns,
+                               const PresortedIndex& presort,
                                int rowLength,
                                const std::vector<double>& y);
     
     void trainWithDartOptimized(const std::vector<double>& X,
+                               const FeatureMatrix& columns,
+                               const PresortedIndex& presort,
                                int rowLength,
                                const std::vector<double>& y);
     
+    // One round's tree on the current residuals
+    void fitTree(SingleTreeTrainer& treeTrainer,
+                 const FeatureMatrix& columns,
+                 const PresortedIndex& presort,
+                 const std::vector<double>& residuals) const;
+    
     // Parallel computation methods
     double computeBaseScoreParallel(const std::vector<double>& y) const;
     
@@ -127,6 +161,9 @@ private:
                                  const std::vector<double>& pred,
                                  std::vector<double>& residuals) const;
     
+    // New tree's output on every training row, gathered from the trainer's
+    // row -> leaf record; traverses only rows without one. Call before the
+    // tree is released into the model.
     void batchTreePredictOptimized(const SingleTreeTrainer* trainer,
                                   const std::vector<double>& X,
                                   int rowLength,
@@ -6,4 +6,9 @@ class MSECriterion : public ISplitCriterion {
 public:
     double nodeMetric(const std::vector<double>& labels,
                       const std::vector<int>& indices) const override;
+
+    // Weighted sums instead of expanding duplicate rows
+    double nodeMetric(const std::vector<double>& labels,
+                      const std::vector<int>& indices,
+                      const std::vector<int>& counts) const override;
 };
@@ -5,9 +5,25 @@
 #include "../tree/ISplitCriterion.hpp"
 #include "../tree/IPruner.hpp"
 #include "tree/trainer/SingleTreeTrainer.hpp"
+#include "ensemble/EnsemblePruner.hpp"
 #include <vector>
 #include <memory>
-#include <random>
+#include <cstdint>
+#include <functional>
+
+// Anytime prediction: trees are visited in a fixed random order and the
+// running mean stops once its standard error is within `tolerance`
+struct AnytimeOptions {
+    double tolerance = 1e-3;   // Target standard error of the running mean
+    int    maxTrees  = 0;      // Tree budget; 0 = all trees
+    int    minTrees  = 5;      // Trees evaluated before the first check
+};
+
+struct AnytimePrediction {
+    double prediction = 0.0;   // Mean over the trees used
+    int    treesUsed  = 0;
+    double variance   = 0.0;   // Estimated variance of that mean (stdError^2)
+};
 
 class BaggingTrainer : public ITreeTrainer {
 public:
@@ -23,10 +39,24 @@ public:
                    uint32_t seed = 42);
 
     // ITreeTrainer interface
+    using ITreeTrainer::train;
     void train(const std::vector<double>& data,
                int rowLength,
                const std::vector<double>& labels) override;
 
+    // Supplies chunks of global tree ids [first, first + count) to
+    // trainDynamic; returns false once no trees are left
+    using TreeChunkSource = std::function<bool(int& first, int& count)>;
+    
+    // Grows trees chunk by chunk as `next` hands out global ids (e.g. an MPI
+    // work queue), OpenMP-parallel within a chunk. Ids key the random streams
+    // as in train(), so tree g is the same whichever process grows it. The
+    // "forest" split method and OOB stopping do not apply here.
+    void trainDynamic(const std::vector<double>& data,
+                      int rowLength,
+                      const std::vector<double>& labels,
+                      const TreeChunkSource& next);
+
     double predict(const double* sample,
                    int rowLength) const override;
 
@@ -35,18 +65,83 @@ public:
                   const std::vector<double>& y,
                   double& mse,
                   double& mae) override;
+    
+    AnytimePrediction predictAnytime(const double* sample,
+                                     int rowLength,
+                                     const AnytimeOptions& options) const;
+    
+    // Row-major batch; rows are processed in blocks, each block walking the
+    // tree order once and dropping rows from its active set as they converge
+    std::vector<AnytimePrediction> predictAnytime(const std::vector<double>& X,
+                                                  int rowLength,
+                                                  const AnytimeOptions& options) const;
 
     // Accessors
     int getNumTrees() const { return numTrees_; }
     double getSampleRatio() const { return sampleRatio_; }
     
+    // Global id of this trainer's first tree. Random streams are keyed by
+    // (seed, global tree id), so a tree is identical whichever thread or
+    // MPI rank grows it.
+    void setTreeIdOffset(int offset) { treeIdOffset_ = offset; }
+    
+    // Stop adding trees once the OOB error flattens: trees are grown in
+    // waves of `window`, and training ends when two consecutive waves each
+    // improve the OOB MSE by less than `tolerance` (relative). numTrees is
+    // then an upper bound. tolerance <= 0 disables stopping.
+    void setOOBStopping(double tolerance, int window = 10) {
+        oobStopTol_ = tolerance;
+        oobWindow_ = window > 0 ? window : 1;
+    }
+    
+    // Running OOB prediction sums and counts per training row (empty before
+    // training and after pruning); summed over processes holding disjoint
+    // trees they give the OOB error of the whole forest
+    const std::vector<double>& getOOBSums() const { return oobSum_; }
+    const std::vector<int>& getOOBCounts() const { return oobCount_; }
+    
+    // OOB MSE after each wave of trees, as maintained during training
+    const std::vector<double>& getOOBCurve() const { return oobCurve_; }
+    int getOOBWindow() const { return oobWindow_; }
+    int getTrainedTrees() const { return static_cast<int>(trees_.size()); }
+    int getTreeIdOffset() const { return treeIdOffset_; }
+    
+    // Global id of each trained tree (treeIdOffset + index after train())
+    const std::vector<int>& getTreeIds() const { return treeIds_; }
+    
+    // Roots of the trained trees, in training order
+    std::vector<const Node*> getTreeRoots() const {
+        std::vector<const Node*> roots;
+        roots.reserve(trees_.size());
+        for (const auto& tree : trees_) roots.push_back(tree->getRoot());
+        return roots;
+    }
+    
+    // Keeps the trees the pruner selects on (X_val, y_val); the forest stays
+    // an unweighted mean, so the method is always greedy. Running OOB sums
+    // are dropped and recomputed on demand.
+    EnsembleSelection pruneEnsemble(const EnsemblePruner& pruner,
+                                    const std::vector<double>& X_val,
+                                    int rowLength,
+                                    const std::vector<double>& y_val);
+    
     // Feature importance
     std::vector<double> getFeatureImportance(int numFeatures) const;
+    
+    // OOB permutation importance: increase in OOB MSE when each feature is
+    // permuted. `data`/`labels` must be the training set passed to train().
+    std::vector<double> getPermutationImportance(const std::vector<double>& data,
+                                                 int rowLength,
+                                                 const std::vector<double>& labels) const;
 
-    // Out-of-bag error estimation
+    // Out-of-bag error estimation over the rows train() was given (OOB
+    // indices are training row ids). With trainingSet, `labels` are the
+    // training labels and the running OOB sums answer directly while they
+    // are current; otherwise the trees' OOB rows are re-scored.
     double getOOBError(const std::vector<double>& data,
                        int rowLength,
-                       const std::vector<double>& labels) const;
+                       const std::vector<double>& labels,
+                       bool trainingSet = false) const;
 
 private:
     // Configuration parameters
@@ -59,35 +154,78 @@ private:
     std::string prunerType_;
     double prunerParam_;
     
-    // Random number generator
-    mutable std::mt19937 gen_;
+    // Key of every random stream; see CounterRng
+    uint32_t seed_;
+    int treeIdOffset_ = 0;
     
     // Trained trees and OOB indices
     std::vector<std::unique_ptr<SingleTreeTrainer>> trees_;
     std::vector<std::vector<int>> oobIndices_;  // Out-of-bag indices for each tree
+    std::vector<int> treeOrder_;                // Fixed random visiting order for anytime prediction
+    std::vector<int> treeIds_;                  // Global id of each tree
+    
+    // Running OOB prediction sums and counts per training row, updated as
+    // each wave of trees finishes
+    std::vector<double> oobSum_;
+    std::vector<int> oobCount_;
+    std::vector<double> oobCurve_;
+    double oobStopTol_ = 0.0;
+    int oobWindow_ = 10;
     
     // Factory methods
-    std::unique_ptr<ISplitFinder> createSplitFinder() const;
+    std::unique_ptr<ISplitFinder> createSplitFinder(int treeId = 0) const;
     std::unique_ptr<ISplitCriterion> createCriterion() const;
     std::unique_ptr<IPruner> createPruner(const std::vector<double>& X_val,
                                          int rowLength,
                                          const std::vector<double>& y_val) const;
     
-    // Bootstrap sampling
-    void bootstrapSample(int dataSize,
-                        std::vector<int>& sampleIndices,
-                        std::vector<int>& oobIndices) const;
-    
-    // Optimized data extraction
-    void extractSubsetOptimized(const std::vector<double>& originalData,
-                               int rowLength,
-                               const std::vector<double>& originalLabels,
-                               const std::vector<int>& indices,
-                               std::vector<double>& subData,
-                               std::vector<double>& subLabels) const;
-    
-    void bootstrapSample(int dataSize,
-                        std::vector<int>& sampleIndices,
-                        std::vector<int>& oobIndices,
-                        std::mt19937& localGen) const;  
+    // Bootstrap replica of tree `treeId` as per-row multiplicities over the
+    // shared training matrix (counts[row] = times drawn); rows never drawn
+    // are out-of-bag. Drawn from the tree's own counter-based stream.
+    void bootstrapCounts(int dataSize,
+                         std::vector<int>& counts,
+                         std::vector<int>& oobIndices,
+                         int treeId) const;
+
+    // Grows tree `treeId` (keyed treeIdOffset_ + treeId) on its bootstrap
+    // replica; counts/oobIndices are the caller's buffers
+    std::unique_ptr<SingleTreeTrainer> growTree(int treeId,
+                                                const FeatureMatrix& X,
+                                                const std::vector<double>& labels,
+                                                const PresortedIndex& presort,
+                                                std::vector<int>& counts,
+                                                std::vector<int>& oobIndices) const;
+
+    // splitMethod "forest[:bins[:batch]]": trees grow level-synchronously in
+    // batches (default: as many trees as ForestHistogramBuilder::maxBatch
+    // allows) with one histogram pass per level. MSE only: train() grows
+    // other criteria per tree with exhaustive splits
+    void trainForest(const FeatureMatrix& X,
+                     const std::vector<double>& data,
+                     int rowLength,
+                     const std::vector<double>& labels);
+    
+    // Draws treeOrder_ once the final set of trees is known
+    void shuffleTreeOrder();
+    
+    // Adds tree t's predictions for its OOB rows to a thread's buffers
+    void addOOBPredictions(int t,
+                           const std::vector<double>& data,
+                           int rowLength,
+                           std::vector<double>& sum,
+                           std::vector<int>& count) const;
+    
+    // OOB prediction sums and counts of every tree over `dataSize` rows,
+    // accumulated in per-thread buffers and folded row-parallel
+    void accumulateOOB(const std::vector<double>& data,
+                       int rowLength,
+                       int dataSize,
+                       std::vector<double>& sum,
+                       std::vector<int>& count) const;
+    
+    // Folds the per-thread buffers into the running sums (row-parallel, no
+    // atomics), records the OOB MSE and returns true once it has flattened
+    bool mergeOOBWave(std::vector<std::vector<double>>& threadSum,
+                      std::vector<std::vector<int>>& threadCount,
+                      const std::vector<double>& labels);
 };
\ No newline at end of file
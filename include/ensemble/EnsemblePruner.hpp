@@ -0,0 +1,75 @@
+// =============================================================================
+// include/ensemble/EnsemblePruner.hpp - Post-training tree subset selection
+// =============================================================================
+#pragma once
+
+#include "tree/Node.hpp"
+#include <string>
+#include <vector>
+
+// Trees kept by an EnsemblePruner and how to combine them
+struct EnsembleSelection {
+    std::vector<int>    trees;        // Kept tree indices, ascending
+    std::vector<double> weights;      // Multiplier of each kept tree's raw output
+    double baseScore  = 0.0;          // Additive models: new intercept
+    double fullMSE    = 0.0;          // Validation MSE of the whole ensemble
+    double prunedMSE  = 0.0;          // Validation MSE of the selection
+};
+
+/**
+ * Picks a small subset of a trained ensemble from per-tree predictions on a
+ * validation set, cached once as a trees x rows matrix. Trees are added one
+ * at a time until the validation MSE is within (1 + tolerance) of the full
+ * ensemble's (or maxTrees is reached).
+ *
+ *   greedy: add the tree that lowers the validation MSE most, keeping the
+ *           ensemble's own combination (original factors, or the plain mean)
+ *   omp:    orthogonal matching pursuit - add the tree most correlated with
+ *           the residual, then refit all kept weights and the intercept by
+ *           least squares (additive models only)
+ *
+ * Inference cost is linear in the number of trees, so the kept fraction is
+ * the inference speed-up.
+ */
+class EnsemblePruner {
+public:
+    enum class Method { Greedy, OMP };
+
+    explicit EnsemblePruner(Method method = Method::Greedy,
+                            double tolerance = 0.01,
+                            int maxTrees = 0);
+
+    // "greedy" or "omp"; anything else falls back to greedy
+    static Method parseMethod(const std::string& name);
+
+    // pred(x) = baseScore + sum_t factors[t] * tree_t(x)
+    EnsembleSelection selectAdditive(const std::vector<const Node*>& trees,
+                                     const std::vector<double>& factors,
+                                     double baseScore,
+                                     const std::vector<double>& X_val,
+                                     int rowLength,
+                                     const std::vector<double>& y_val) const;
+
+    // pred(x) = mean_t tree_t(x); always greedy, kept trees stay unweighted
+    EnsembleSelection selectAveraging(const std::vector<const Node*>& trees,
+                                      const std::vector<double>& X_val,
+                                      int rowLength,
+                                      const std::vector<double>& y_val) const;
+
+private:
+    Method method_;
+    double tolerance_;
+    int    maxTrees_;
+
+    // Raw tree outputs, tree-major: P[t * n + i]
+    static std::vector<double> cachePredictions(const std::vector<const Node*>& trees,
+                                                const std::vector<double>& X,
+                                                int rowLength,
+                                                size_t n);
+
+    EnsembleSelection greedyAdditive(const std::vector<double>& P, int T, size_t n,
+                                     const std::vector<double>& factors, double baseScore,
+                                     const std::vector<double>& y, double target) const;
+    EnsembleSelection ompAdditive(const std::vector<double>& P, int T, size_t n,
+                                  const std::vector<double>& y, double target) const;
+};
@@ -0,0 +1,69 @@
+// =============================================================================
+// include/ensemble/FlatForest.hpp - Pointer-free forest for shipping and scoring
+// =============================================================================
+#pragma once
+
+#include "tree/Node.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * A tree-averaging forest flattened into one node array: each tree is stored
+ * in preorder, so a node's left child is the next node and only the right
+ * child's index is kept. Indices are relative to the tree's first node, so
+ * forests are merged by concatenating node arrays (e.g. the buffers of MPI
+ * ranks holding consecutive tree ranges) without rewriting any node.
+ *
+ * 16 bytes per node; the node array can be sent over MPI as raw bytes and
+ * saved as-is.
+ */
+class FlatForest {
+public:
+    struct FlatNode {
+        std::int32_t feature;   // -1: leaf
+        std::int32_t right;     // Right child, relative to the tree's first node
+        double       value;     // Threshold, or the leaf prediction
+    };
+
+    FlatForest() = default;
+
+    // Appends `root` as the next tree; a null root or child scores 0 as in
+    // SingleTreeTrainer::predict
+    void appendTree(const Node* root);
+
+    // Appends every tree of `other`, in order
+    void append(const FlatForest& other);
+
+    // Appends trees given as node counts over a contiguous node array
+    void appendRaw(const FlatNode* nodes, const std::int64_t* treeSizes, std::size_t numTrees);
+
+    double predict(const double* sample) const;
+
+    void predictBatch(const std::vector<double>& X,
+                      int rowLength,
+                      std::vector<double>& predictions) const;
+
+    std::size_t numTrees() const { return treeStart_.empty() ? 0 : treeStart_.size() - 1; }
+    std::size_t numNodes() const { return nodes_.size(); }
+    const std::vector<FlatNode>& nodes() const { return nodes_; }
+    std::vector<std::int64_t> treeSizes() const;
+
+    // "DTFOR01" header (trees, nodes), per-tree node counts, node array
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+private:
+    std::vector<FlatNode> nodes_;
+    std::vector<std::int64_t> treeStart_;   // numTrees + 1 offsets into nodes_
+
+    double predictTree(std::size_t t, const double* sample) const {
+        const FlatNode* base = nodes_.data() + treeStart_[t];
+        const FlatNode* n = base;
+        while (n->feature >= 0) {
+            n = (sample[n->feature] <= n->value) ? n + 1 : base + n->right;
+        }
+        return n->value;
+    }
+};
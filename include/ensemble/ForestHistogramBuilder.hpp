@@ -0,0 +1,50 @@
+// =============================================================================
+// include/ensemble/ForestHistogramBuilder.hpp - Level-synchronous forest growth
+// =============================================================================
+#pragma once
+
+#include "tree/FeatureMatrix.hpp"
+#include "tree/Node.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Grows a whole batch of regression trees together, one level at a time.
+ *
+ * Features are binned once (exact bins for features with at most maxBins
+ * distinct values, equal-frequency cuts otherwise). At every level a single
+ * pass over each bin column accumulates the (weight, sum, sumSq) histograms
+ * of every open node of every tree, with the trees' bootstrap multiplicities
+ * as weights, so the data is streamed depth times instead of
+ * trees x depth times. Splits minimise weighted MSE and respect the
+ * weighted min-samples-per-leaf bound.
+ */
+class ForestHistogramBuilder {
+public:
+    ForestHistogramBuilder(int maxBins, int maxDepth, int minSamplesLeaf,
+                           double minGain = 0.0);
+
+    // One tree per entry of `counts` (multiplicity of each row in that tree's
+    // bootstrap sample); returns the roots in the same order.
+    std::vector<std::unique_ptr<Node>>
+    build(const FeatureMatrix& X,
+          const std::vector<double>& labels,
+          const std::vector<std::vector<int>>& counts) const;
+
+    // Largest batch whose per-(row, tree) state (bootstrap counts and active
+    // pairs) fits the builder's memory budget for `rows` rows; at least 1
+    static int maxBatch(std::size_t rows);
+
+private:
+    // Bin codes stored column-major (feature f at codes[f * N]); code b
+    // goes left of cut b, i.e. x <= cuts[f][b] exactly when code <= b
+    void binFeatures(const FeatureMatrix& X,
+                     AlignedVector<std::uint16_t>& codes,
+                     std::vector<std::vector<double>>& cuts) const;
+
+    int    maxBins_;
+    int    maxDepth_;
+    int    minSamplesLeaf_;
+    double minGain_;
+};
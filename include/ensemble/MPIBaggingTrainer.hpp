@@ -1,6 +1,8 @@
 #pragma once
 #include "ensemble/BaggingTrainer.hpp"
+#include "ensemble/FlatForest.hpp"
 #include <mpi.h>
+#include <functional>
 #include <vector>
 #include <memory>
 
@@ -28,12 +30,26 @@ public:
                int numFeatures,
                const std::vector<double>& labels);
     
+    // Gather phase: every rank flattens its trees (FlatForest) and the node
+    // buffers are concatenated in global tree order. root < 0 allgathers, so
+    // every rank holds the whole forest and predict/predictBatch/evaluate run
+    // locally with no collectives; root >= 0 only sends it to that rank
+    // (e.g. to save it) and scoring stays collective.
+    void gatherForest(int root = -1);
+    const FlatForest* getMergedForest() const { return mergedForest_.get(); }
+    
+    // Writes the merged forest (see FlatForest::save) on the rank holding it
+    bool saveForest(const std::string& filename) const;
+    
     // Single prediction - aggregates predictions from all trees
     // numFeatures: actual number of features (without label column)
     double predict(const double* sample, int numFeatures) const;
     
     // Batch prediction - more efficient for multiple predictions
     // numFeatures: actual number of features (without label column)
+    // Without the whole forest on this rank the call is collective and every
+    // process must pass the same X; rows are scored in chunks whose
+    // MPI_Iallreduce overlaps the prediction of the next chunk
     void predictBatch(const std::vector<double>& X,
                       int numFeatures,
                       std::vector<double>& predictions) const;
@@ -49,8 +65,30 @@ public:
     // Get feature importance aggregated from all trees
     std::vector<double> getFeatureImportance(int numFeatures) const;
     
-    // Get OOB error (only available on master process)
-    // numFeatures: actual number of features (without label column)
+    // This process's trees and their global ids in a forest of
+    // getNumTrees(); leaf-box distillation samples from them
+    std::vector<const Node*> getLocalTreeRoots() const {
+        return localBagging_ ? localBagging_->getTreeRoots() : std::vector<const Node*>();
+    }
+    std::vector<int> getLocalTreeIds() const {
+        return localBagging_ ? localBagging_->getTreeIds() : std::vector<int>();
+    }
+    int getNumTrees() const { return numTrees_; }
+    
+    // Dynamic scheduling: instead of a fixed, even split, processes claim
+    // chunks of tree ids from a counter on rank 0 with MPI_Fetch_and_op
+    // (one-sided, rank 0 takes part like any worker). Chunks shrink with the
+    // trees left (guided schedule), so fast processes keep taking work and
+    // the final wait is at most one small chunk. The forest is unchanged.
+    void setDynamicScheduling(bool enabled) { dynamic_ = enabled; }
+    
+    // Rows per chunk of collective scoring (see predictBatch)
+    void setScoringChunkRows(size_t rows) { scoringChunkRows_ = std::max<size_t>(1, rows); }
+    
+    // OOB error of the whole forest, identical on every process: per-row
+    // OOB (sum, count) buffers are summed with one nonblocking allreduce
+    // started as soon as this process's trees are done, and completed here.
+    // `labels` must be the training labels; numFeatures is unused.
     double getOOBError(const std::vector<double>& data,
                        int numFeatures,
                        const std::vector<double>& labels) const;
@@ -77,9 +115,42 @@ private:
     int localNumTrees_;
     int treeOffset_;
     
+    bool dynamic_ = false;
+    size_t scoringChunkRows_ = 4096;
+    
+    // Distributed OOB: local (sums, counts) packed as 2N doubles and their
+    // in-flight global sum
+    std::vector<double> oobLocal_;
+    mutable std::vector<double> oobGlobal_;
+    mutable MPI_Request oobRequest_ = MPI_REQUEST_NULL;
+    
+    void startOOBReduction(size_t numRows);
+    
+    // Whole forest after gatherForest()
+    std::unique_ptr<FlatForest> mergedForest_;
+    bool forestOnAllRanks_ = false;
+    
     // Tree assignment calculation
     std::pair<int, int> calculateTreeAssignment(int rank, int size, int totalTrees) const;
     
+    // Claims chunks from the shared RMA counter until none are left;
+    // returns the seconds spent waiting on the counter
+    double trainDynamicChunks(const std::vector<double>& data,
+                              int numFeatures,
+                              const std::vector<double>& labels);
+    
+    // Per-process trees, busy and idle time, printed by rank 0
+    void reportLoadBalance(double busySeconds, double idleSeconds) const;
+    
+    // Collective scoring pipeline: chunk k's local tree sums are reduced
+    // with MPI_Iallreduce while chunk k + 1 is predicted (polling chunk k
+    // between row blocks so it progresses), then chunk k is scaled to the
+    // forest mean and handed to onChunk(begin, end) while chunk k + 1 reduces
+    void scoreCollective(const std::vector<double>& X,
+                         int numFeatures,
+                         std::vector<double>& predictions,
+                         const std::function<void(size_t, size_t)>& onChunk) const;
+    
     // Collective operations
     void gatherPredictions(const double* localPred, double* globalPred) const;
     void gatherFeatureImportance(const std::vector<double>& localImportance,
@@ -0,0 +1,43 @@
+// =============================================================================
+// include/ensemble/PermutationImportance.hpp - Path-cached permutation importance
+// =============================================================================
+#pragma once
+
+#include "tree/Node.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Permutation importance of an additive tree ensemble scored on a row set:
+ *
+ *   pred[r] = basePred[r] + rowScale[r] * sum_t treeWeights[t] * leaf_t(r)
+ *
+ * where the sum runs over the trees that score row r. Permuting feature f
+ * changes leaf_t(r) only if r's path in tree t tests f, and only below the
+ * first such node. Each tree therefore caches, per feature, the rows whose
+ * path tests it together with that first node and the row's leaf value;
+ * permuting f re-routes just those rows from that node. Caches are built in
+ * parallel over trees, permutations are scored in parallel over features.
+ */
+class PermutationImportance {
+public:
+    struct Ensemble {
+        std::vector<const Node*> trees;
+        std::vector<double> treeWeights;
+        // Rows each tree scores (e.g. its OOB rows); empty: every scored row
+        std::vector<const std::vector<int>*> treeRows;
+        // Per-row factor from the weighted leaf sum to the prediction; rows
+        // with 0 are not scored
+        std::vector<double> rowScale;
+    };
+
+    // Increase in MSE over `labels` when each feature is permuted across the
+    // scored rows (one permutation per feature, keyed by (seed, feature)).
+    // `data` is row-major; basePred[r] is the unpermuted prediction.
+    static std::vector<double> compute(const Ensemble& ensemble,
+                                       const std::vector<double>& data,
+                                       int rowLength,
+                                       const std::vector<double>& labels,
+                                       const std::vector<double>& basePred,
+                                       uint32_t seed);
+};
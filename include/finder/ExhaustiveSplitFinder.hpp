@@ -14,4 +14,32 @@ public:
                   const std::vector<int>&     indices,
                   double                      currentMetric,
                   const ISplitCriterion&      criterion) const override;
-};
\ No newline at end of file
+
+    // Same search over contiguous feature columns
+    std::tuple<int, double, double>
+    findBestSplit(const FeatureMatrix&        X,
+                  const std::vector<double>&  labels,
+                  const std::vector<int>&     indices,
+                  double                      currentMetric,
+                  const ISplitCriterion&      criterion) const override;
+
+    // Weighted prefix sums over distinct rows (bootstrap multiplicities)
+    std::tuple<int, double, double>
+    findBestSplit(const FeatureMatrix&        X,
+                  const std::vector<double>&  labels,
+                  const std::vector<int>&     indices,
+                  const std::vector<int>&     counts,
+                  double                      currentMetric,
+                  const ISplitCriterion&      criterion) const override;
+
+    // Sort-free scan over rows the builder keeps presorted per feature
+    std::tuple<int, double, double>
+    findBestSplit(const FeatureMatrix&        X,
+                  const std::vector<double>&  labels,
+                  const SortedRows&           node,
+                  const std::vector<int>*     counts,
+                  double                      currentMetric,
+                  const ISplitCriterion&      criterion) const override;
+
+    bool usesSortedOrder() const override { return true; }
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "tree/ISplitFinder.hpp"
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+// Extremely randomized trees (Geurts et al. 2006): per feature, one min/max
+// pass over the node, k uniform thresholds in (min, max), and one pass that
+// scores all k at once. O(N log k) per feature, no sorting.
+class ExtraTreesSplitFinder : public ISplitFinder {
+public:
+    explicit ExtraTreesSplitFinder(int k = 1, uint32_t seed = 42)
+      : k_(k > 0 ? k : 1), seed_(seed) {}
+    std::tuple<int, double, double> findBestSplit(
+        const std::vector<double>& data,
+        int rowLen,
+        const std::vector<double>& labels,
+        const std::vector<int>& idx,
+        double parentMetric,
+        const ISplitCriterion& criterion) const override;
+    std::tuple<int, double, double> findBestSplit(
+        const FeatureMatrix& X,
+        const std::vector<double>& labels,
+        const std::vector<int>& idx,
+        double parentMetric,
+        const ISplitCriterion& criterion) const override;
+    std::tuple<int, double, double> findBestSplit(
+        const FeatureMatrix& X,
+        const std::vector<double>& labels,
+        const std::vector<int>& idx,
+        const std::vector<int>& counts,
+        double parentMetric,
+        const ISplitCriterion& criterion) const override;
+private:
+    int               k_;
+    uint32_t          seed_;   // Threshold draws are keyed by (seed, node, feature)
+};
@@ -11,4 +11,22 @@ public:
         const std::vector<int>& idx,
         double parentMetric,
         const ISplitCriterion& criterion) const override;
+
+    std::tuple<int, double, double> findBestSplit(
+        const FeatureMatrix& X,
+        const std::vector<double>& labels,
+        const std::vector<int>& idx,
+        double parentMetric,
+        const ISplitCriterion& criterion) const override;
+
+    // Presorted rows: no per-node sort, weighted quartiles when counts are given
+    std::tuple<int, double, double> findBestSplit(
+        const FeatureMatrix& X,
+        const std::vector<double>& labels,
+        const SortedRows& node,
+        const std::vector<int>* counts,
+        double parentMetric,
+        const ISplitCriterion& criterion) const override;
+
+    bool usesSortedOrder() const override { return true; }
 };
@@ -1,14 +1,14 @@
 #pragma once
 
 #include "tree/ISplitFinder.hpp"
-#include <random>
+#include <cstdint>
 #include <tuple>
 #include <vector>
 
 class RandomSplitFinder : public ISplitFinder {
 public:
     explicit RandomSplitFinder(int k = 10, uint32_t seed = 42)
-      : k_(k), gen_(seed) {}
+      : k_(k), seed_(seed) {}
     std::tuple<int, double, double> findBestSplit(
         const std::vector<double>& data,
         int rowLen,
@@ -16,7 +16,28 @@ public:
         const std::vector<int>& idx,
         double parentMetric,
         const ISplitCriterion& criterion) const override;
+    std::tuple<int, double, double> findBestSplit(
+        const FeatureMatrix& X,
+        const std::vector<double>& labels,
+        const std::vector<int>& idx,
+        double parentMetric,
+        const ISplitCriterion& criterion) const override;
+    std::tuple<int, double, double> findBestSplit(
+        const FeatureMatrix& X,
+        const std::vector<double>& labels,
+        const std::vector<int>& idx,
+        const std::vector<int>& counts,
+        double parentMetric,
+        const ISplitCriterion& criterion) const override;
+    std::tuple<int, double, double> findBestSplit(
+        const FeatureMatrix& X,
+        const std::vector<double>& labels,
+        const SortedRows& node,
+        const std::vector<int>* counts,
+        double parentMetric,
+        const ISplitCriterion& criterion) const override;
+    bool usesSortedOrder() const override { return true; }
 private:
     int               k_;
-    mutable std::mt19937 gen_;  
+    uint32_t          seed_;   // Threshold draws are keyed by (seed, node, feature)
 };
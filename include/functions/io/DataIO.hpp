@@ -42,6 +42,20 @@ public:
                              std::vector<double>& labels,
                              int& rowLength);
 
+    // Binary dataset: a 24-byte header ("DTBIN01", rows, features as uint64),
+    // row-major features, then labels, all native-endian doubles. Reading
+    // maps the file, so ranks or processes on one node share the page cache
+    // and nothing is parsed. rowLength follows readCSV (features + label).
+    bool writeBinary(const std::string& filename,
+                     const std::vector<double>& flattenedFeatures,
+                     const std::vector<double>& labels,
+                     int rowLength) const;
+
+    bool readBinaryMapped(const std::string& filename,
+                          std::vector<double>& flattenedFeatures,
+                          std::vector<double>& labels,
+                          int& rowLength) const;
+
     // Enhanced: Data validation method
     bool validateData(const std::vector<double>& flattenedFeatures,
                       const std::vector<double>& labels,
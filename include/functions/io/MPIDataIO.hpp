@@ -0,0 +1,52 @@
+// =============================================================================
+// include/functions/io/MPIDataIO.hpp - Collective dataset loading over MPI
+// =============================================================================
+#pragma once
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+/**
+ * Loads a dataset onto every rank of `comm` without a rank-0 bottleneck.
+ *
+ * CSV: each rank reads only its 1/P byte range of the file with MPI-IO and
+ * parses the lines that start inside it (the header belongs to rank 0); the
+ * parsed rows are then allgathered as binary doubles in rank order, so the
+ * result matches DataIO::readCSV row for row.
+ *
+ * Binary (".bin", see DataIO::writeBinary): every rank maps the file itself,
+ * so there is no parsing and no communication at all.
+ *
+ * rowLength follows DataIO::readCSV (features + label). Returns false on
+ * every rank if any rank fails.
+ */
+class MPIDataIO {
+public:
+    explicit MPIDataIO(MPI_Comm comm = MPI_COMM_WORLD);
+
+    bool load(const std::string& filename,
+              std::vector<double>& flattenedFeatures,
+              std::vector<double>& labels,
+              int& rowLength) const;
+
+    bool readCSVCollective(const std::string& filename,
+                           std::vector<double>& flattenedFeatures,
+                           std::vector<double>& labels,
+                           int& rowLength) const;
+
+    static bool isBinaryPath(const std::string& filename);
+
+private:
+    MPI_Comm comm_;
+    int rank_ = 0;
+    int size_ = 1;
+
+    // Bytes [begin, end) of the file plus the tail of the last line that
+    // starts before `end`, and the byte before `begin` when begin > 0
+    bool readRange(MPI_File fh, MPI_Offset fileSize,
+                   MPI_Offset begin, MPI_Offset end,
+                   std::string& buffer) const;
+
+    bool allOk(bool ok) const;
+};
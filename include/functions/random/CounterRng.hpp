@@ -0,0 +1,135 @@
+// =============================================================================
+// include/functions/random/CounterRng.hpp - Counter-based (Philox4x32-10) RNG
+// =============================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+// What a stream is used for. Part of the key, so e.g. the bootstrap of tree 3
+// and the row subsample of round 3 never share random numbers.
+enum class RngPurpose : std::uint32_t {
+    Bootstrap      = 1,
+    SplitThreshold = 2,
+    RowSubsample   = 3,
+    GossSample     = 4,
+    DartDrop       = 5,
+    Permutation    = 6,
+    TreeOrder      = 7,
+    Augment        = 8
+};
+
+/**
+ * Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+ * keyed by (seed, purpose, stream, node). Output block k is a pure function of
+ * the key and k, so a stream depends only on what it is for - tree id, round,
+ * node - and never on which thread or MPI rank draws it or in which order.
+ *
+ * Satisfies UniformRandomBitGenerator; below() and uniform() are provided so
+ * results do not depend on the standard library's distribution algorithms.
+ */
+class CounterRng {
+public:
+    using result_type = std::uint32_t;
+
+    CounterRng(std::uint32_t seed, RngPurpose purpose,
+               std::uint32_t stream, std::uint32_t node = 0)
+        : key0_(seed), key1_(static_cast<std::uint32_t>(purpose)),
+          stream_(stream), node_(node) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        if (used_ == 4) refill();
+        return out_[used_++];
+    }
+
+    // Uniform integer in [0, n), unbiased (Lemire's multiply-shift with rejection)
+    std::uint32_t below(std::uint32_t n) {
+        std::uint64_t m = static_cast<std::uint64_t>((*this)()) * n;
+        std::uint32_t low = static_cast<std::uint32_t>(m);
+        if (low < n) {
+            const std::uint32_t threshold = static_cast<std::uint32_t>(-n) % n;
+            while (low < threshold) {
+                m = static_cast<std::uint64_t>((*this)()) * n;
+                low = static_cast<std::uint32_t>(m);
+            }
+        }
+        return static_cast<std::uint32_t>(m >> 32);
+    }
+
+    // Uniform double in [0, 1) with 53 random bits
+    double uniform() {
+        const std::uint64_t hi = (*this)() >> 5;   // 27 bits
+        const std::uint64_t lo = (*this)() >> 6;   // 26 bits
+        return static_cast<double>((hi << 26) | lo) * (1.0 / 9007199254740992.0);
+    }
+
+    // Moves a uniform random sample of k elements to the front of [first, last)
+    // (partial Fisher-Yates; k = size gives a full shuffle)
+    template <typename RandomIt>
+    void sampleToFront(RandomIt first, RandomIt last, std::size_t k) {
+        const auto n = static_cast<std::size_t>(std::distance(first, last));
+        if (k > n) k = n;
+        for (std::size_t i = 0; i < k && i + 1 < n; ++i) {
+            const std::size_t j = i + below(static_cast<std::uint32_t>(n - i));
+            using std::swap;
+            swap(first[i], first[j]);
+        }
+    }
+
+    template <typename RandomIt>
+    void shuffle(RandomIt first, RandomIt last) {
+        sampleToFront(first, last, static_cast<std::size_t>(std::distance(first, last)));
+    }
+
+    // Order-independent 32-bit digest of a set of row ids; keys per-node
+    // streams by the rows a node holds when the builder has no node ids
+    template <typename It>
+    static std::uint32_t digest(It first, It last) {
+        std::uint64_t acc = 0;
+        for (; first != last; ++first) acc += mix64(static_cast<std::uint64_t>(*first));
+        return static_cast<std::uint32_t>(mix64(acc) >> 32);
+    }
+
+private:
+    static std::uint64_t mix64(std::uint64_t z) {   // splitmix64 finalizer
+        z += 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    void refill() {
+        std::uint32_t c0 = static_cast<std::uint32_t>(block_);
+        std::uint32_t c1 = static_cast<std::uint32_t>(block_ >> 32);
+        std::uint32_t c2 = stream_;
+        std::uint32_t c3 = node_;
+        std::uint32_t k0 = key0_, k1 = key1_;
+        for (int r = 0; r < 10; ++r) {
+            const std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53u) * c0;
+            const std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57u) * c2;
+            const std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            const std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c0 = n0;
+            c1 = static_cast<std::uint32_t>(p1);
+            c2 = n2;
+            c3 = static_cast<std::uint32_t>(p0);
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        out_[0] = c0; out_[1] = c1; out_[2] = c2; out_[3] = c3;
+        ++block_;
+        used_ = 0;
+    }
+
+    std::uint32_t key0_, key1_;
+    std::uint32_t stream_, node_;
+    std::uint64_t block_ = 0;
+    std::uint32_t out_[4] = {0, 0, 0, 0};
+    int used_ = 4;
+};
@@ -0,0 +1,38 @@
+// =============================================================================
+// include/histogram/MPIQuantileSketch.hpp - Shared bin cuts for sharded rows
+// =============================================================================
+#pragma once
+
+#include <mpi.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Quantile cut points agreed by every process of a communicator that holds
+ * a shard of the rows. Each process contributes the rows of a fixed-stride
+ * sketch chosen by global row index (shards are taken in rank order), so
+ * the cuts depend on the data but not on the process count.
+ *
+ * Bin b of feature f holds values <= cuts[f][b] and > cuts[f][b - 1]; the
+ * last bin (cuts[f].size()) is open-ended. Splitting after bin b is the
+ * value test x <= cuts[f][b], so binned and raw rows route identically.
+ */
+class MPIQuantileSketch {
+public:
+    // Collective; data is this process's shard (row-major), maxBins <= 256
+    static std::vector<std::vector<double>> computeCuts(MPI_Comm comm,
+                                                        const std::vector<double>& data,
+                                                        std::size_t rows,
+                                                        int numFeatures,
+                                                        int maxBins);
+
+    // Column-major bin codes: bins[f * rows + r]
+    static void binColumns(const std::vector<std::vector<double>>& cuts,
+                           const std::vector<double>& data,
+                           std::size_t rows,
+                           std::vector<std::uint8_t>& bins);
+
+    // offsets[f] = first histogram slot of feature f; offsets.back() = total
+    static std::vector<int> binOffsets(const std::vector<std::vector<double>>& cuts);
+};
@@ -2,6 +2,7 @@
 
 #include "lightgbm/core/LightGBMConfig.hpp"
 #include "lightgbm/trainer/LightGBMTrainer.hpp"
+#include <cstdint>
 #include <string>
 #include <memory>
 
@@ -19,6 +20,7 @@ struct LightGBMAppOptions {
     // GOSS parameters
     double topRate = 0.2;
     double otherRate = 0.1;
+    uint32_t seed = 42;
     
     // Histogram parameters
     int maxBin = 255;
@@ -32,6 +34,10 @@ struct LightGBMAppOptions {
     double tolerance = 1e-7;
     double valSplit = 0.2;
     
+    // Post-training ensemble pruning on a held-out valSplit ("greedy"/"omp")
+    std::string pruneMethod;
+    double pruneTol = 0.01;
+    
     // Regularization
     double lambda = 0.0;
     double minSplitGain = 0.0;
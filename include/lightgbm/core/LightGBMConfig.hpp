@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 struct LightGBMConfig {
@@ -13,6 +14,7 @@ struct LightGBMConfig {
     // GOSS parameters
     double topRate = 0.2;             
     double otherRate = 0.1;           
+    uint32_t seed = 42;               // Keys the per-iteration GOSS streams
     
     // Histogram parameters
     int maxBin = 255;                 
@@ -32,6 +34,12 @@ struct LightGBMConfig {
     bool enableGOSS = true;           
     int histPoolSize = 16384;         
     
+    // Distributed training (MPILightGBMMain): "data" allreduces every
+    // feature's histogram per leaf, "voting" only the votingTopK * 2
+    // features elected from each process's local top votingTopK
+    std::string parallelMode = "data";
+    int votingTopK = 5;
+
     // Objective function
     std::string objective = "regression"; 
 
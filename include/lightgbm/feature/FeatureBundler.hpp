@@ -5,6 +5,7 @@
 
 #include <vector>
 #include <unordered_set>
+#include <cstddef>
 
 struct FeatureBundle {
     std::vector<int> features;        
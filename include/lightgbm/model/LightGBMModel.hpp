@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tree/Node.hpp"
+#include "ensemble/EnsemblePruner.hpp"
 #include <vector>
 #include <memory>
 
@@ -50,6 +51,30 @@ public:
     void setBaseScore(double score) { baseScore_ = score; }
     double getBaseScore() const { return baseScore_; }
 
+    // Keeps the trees the pruner selects on (X_val, y_val), reweighted
+    EnsembleSelection pruneTrees(const EnsemblePruner& pruner,
+                                 const std::vector<double>& X_val,
+                                 int rowLength,
+                                 const std::vector<double>& y_val) {
+        // Nothing to select on: leave the model as it is
+        if (y_val.empty() || trees_.empty()) return EnsembleSelection();
+        std::vector<const Node*> roots;
+        std::vector<double> factors;
+        for (const auto& lgbTree : trees_) {
+            roots.push_back(lgbTree.tree.get());
+            factors.push_back(lgbTree.weight);
+        }
+        EnsembleSelection sel = pruner.selectAdditive(roots, factors, baseScore_, X_val, rowLength, y_val);
+        std::vector<LGBTree> kept;
+        kept.reserve(sel.trees.size());
+        for (size_t k = 0; k < sel.trees.size(); ++k) {
+            kept.emplace_back(std::move(trees_[sel.trees[k]].tree), sel.weights[k]);
+        }
+        trees_ = std::move(kept);
+        baseScore_ = sel.baseScore;
+        return sel;
+    }
+
     void clear() {
         trees_.clear();
         trees_.shrink_to_fit();
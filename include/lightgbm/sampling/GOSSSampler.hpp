@@ -5,7 +5,8 @@
 #pragma once
 
 #include <vector>
-#include <random>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #ifdef _OPENMP
 #include <omp.h>
@@ -15,17 +16,20 @@
 class GOSSSampler {
 public:
     explicit GOSSSampler(double topRate = 0.2, double otherRate = 0.1, uint32_t seed = 42)
-        : topRate_(topRate), otherRate_(otherRate), gen_(seed) {}
+        : topRate_(topRate), otherRate_(otherRate), seed_(seed) {}
 
     /** 
      * Execute GOSS sampling
      * @param gradients Gradient array
      * @param sampleIndices Output: sampled sample indices
      * @param sampleWeights Output: sampling weights (small gradient samples need amplified weights)
+     * @param iteration Boosting iteration; keys the random stream, so the sample
+     *                  depends only on (seed, iteration), not on call order or threads
      */
     void sample(const std::vector<double>& gradients,
                 std::vector<int>& sampleIndices,
-                std::vector<double>& sampleWeights) const;
+                std::vector<double>& sampleWeights,
+                int iteration) const;
 
     /** 
      * GOSS sampling with performance monitoring
@@ -33,6 +37,7 @@ public:
     void sampleWithTiming(const std::vector<double>& gradients,
                           std::vector<int>& sampleIndices,
                           std::vector<double>& sampleWeights,
+                          int iteration,
                           double& samplingTimeMs) const;
 
     /** 
@@ -40,7 +45,8 @@ public:
      */
     void adaptiveSample(const std::vector<double>& gradients,
                         std::vector<int>& sampleIndices,
-                        std::vector<double>& sampleWeights) const;
+                        std::vector<double>& sampleWeights,
+                        int iteration) const;
 
     /** Sampling statistics */
     struct SamplingStats {
@@ -79,17 +85,19 @@ public:
 private:
     double topRate_;      // Large gradient retention ratio
     double otherRate_;    // Small gradient sampling ratio  
-    mutable std::mt19937 gen_;
+    uint32_t seed_;       // Key of the per-iteration sampling streams
 
     /** Parallel GOSS sampling for large datasets */
     void sampleParallel(const std::vector<double>& gradients,
                         std::vector<int>& sampleIndices,
-                        std::vector<double>& sampleWeights) const;
+                        std::vector<double>& sampleWeights,
+                        int iteration) const;
 
     /** Serial GOSS sampling for small datasets */
     void sampleSerial(const std::vector<double>& gradients,
                       std::vector<int>& sampleIndices,
-                      std::vector<double>& sampleWeights) const;
+                      std::vector<double>& sampleWeights,
+                      int iteration) const;
 
     /** Validate sampling parameters */
     bool validateParameters() const {
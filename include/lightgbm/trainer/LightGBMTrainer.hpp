@@ -27,6 +27,7 @@ public:
     explicit LightGBMTrainer(const LightGBMConfig& config);
 
     // ITreeTrainer interface
+    using ITreeTrainer::train;
     void train(const std::vector<double>& data,
                int rowLength,
                const std::vector<double>& labels) override;
@@ -41,12 +42,26 @@ public:
 
     // LightGBM specific methods
     const LightGBMModel* getLGBModel() const { return &model_; }
+    
+    // Post-training ensemble pruning on a validation set (see EnsemblePruner)
+    EnsembleSelection pruneEnsemble(const EnsemblePruner& pruner,
+                                    const std::vector<double>& X_val,
+                                    int rowLength,
+                                    const std::vector<double>& y_val) {
+        return model_.pruneTrees(pruner, X_val, rowLength, y_val);
+    }
     const std::vector<double>& getTrainingLoss() const { return trainingLoss_; }
 
     std::vector<double> getFeatureImportance(int numFeatures) const {
         return calculateFeatureImportance(numFeatures);
     }
 
+    // Distributed training: train() receives this process's shard of the
+    // rows and every tree is grown through `sync` (non-owning, outlives
+    // training). GOSS is skipped, since sampling by local gradient ranks
+    // would differ between shards.
+    void setLeafSplitSync(ILeafSplitSync* sync) { sync_ = sync; }
+
 private:
     LightGBMConfig config_;
     LightGBMModel model_;
@@ -54,6 +69,7 @@ private:
     std::unique_ptr<GOSSSampler> gossSampler_;
     std::unique_ptr<FeatureBundler> featureBundler_;
     std::unique_ptr<LeafwiseTreeBuilder> treeBuilder_;
+    ILeafSplitSync* sync_ = nullptr;
 
     // Training data structures
     std::vector<double> trainingLoss_;
@@ -82,9 +98,11 @@ private:
     
     void prepareFullSample(size_t n);
     
+    // rowLeaf[i]: leaf row i reached while building `tree`, or nullptr
     void updatePredictionsOptimized(const std::vector<double>& data,
                                    int rowLength,
                                    const Node* tree,
+                                   const std::vector<const Node*>& rowLeaf,
                                    std::vector<double>& predictions,
                                    size_t n) const;
     
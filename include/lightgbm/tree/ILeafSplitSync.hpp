@@ -0,0 +1,55 @@
+// =============================================================================
+// include/lightgbm/tree/ILeafSplitSync.hpp - Global split search for sharded rows
+// =============================================================================
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Global totals of a leaf's rows
+struct LeafStats {
+    double count       = 0.0;
+    double weight      = 0.0;
+    double weightedSum = 0.0;   // Sum of weight * target
+
+    double mean() const { return weight > 0.0 ? weightedSum / weight : 0.0; }
+};
+
+struct LeafSplit {
+    int       feature   = -1;
+    double    threshold = 0.0;   // Left: value <= threshold
+    double    gain      = 0.0;   // Drop in weighted MSE, as the local finders report it
+    LeafStats left, right;
+};
+
+/**
+ * Lets LeafwiseTreeBuilder grow one tree over rows sharded across processes
+ * (see LeafwiseTreeBuilder::buildTreeDistributed). Every call is collective:
+ * all processes make the same calls in the same order, each passing its own
+ * rows of the leaf, and get the same result back.
+ *
+ * Row indices refer to the shard passed to prepare(); weights are parallel
+ * to the index list.
+ */
+class ILeafSplitSync {
+public:
+    virtual ~ILeafSplitSync() = default;
+
+    // Once per training run, with this process's shard (row-major)
+    virtual void prepare(const std::vector<double>& data, std::size_t rows, int numFeatures) = 0;
+
+    // Once per tree
+    virtual void beginTree() {}
+
+    // In-place sum over all processes
+    virtual void allreduceSum(double* values, int count) = 0;
+
+    // Best split of the leaf whose global totals are `stats`; false if no
+    // split leaves minDataInLeaf rows on both sides with a positive gain
+    virtual bool findBestSplit(const std::vector<int>& indices,
+                               const std::vector<double>& targets,
+                               const std::vector<double>& weights,
+                               const LeafStats& stats,
+                               int minDataInLeaf,
+                               LeafSplit& split) = 0;
+};
@@ -10,6 +10,7 @@
 #include "lightgbm/core/LightGBMConfig.hpp"
 #include "lightgbm/sampling/GOSSSampler.hpp"
 #include "lightgbm/feature/FeatureBundler.hpp"
+#include "lightgbm/tree/ILeafSplitSync.hpp"
 #include <queue>
 #include <memory>
 #include <vector>
@@ -62,6 +63,29 @@ public:
                                     const std::vector<double>& sampleWeights,
                                     const std::vector<FeatureBundle>& bundles);
 
+    // Same as above on a prebuilt column-major matrix (shared across iterations)
+    std::unique_ptr<Node> buildTree(const FeatureMatrix& X,
+                                    const std::vector<double>& targets,
+                                    const std::vector<int>& sampleIndices,
+                                    const std::vector<double>& sampleWeights);
+
+    /**
+     * Leaf-wise growth over rows sharded across processes: X, targets and
+     * the sample lists are this process's shard, and every count, gain and
+     * leaf value comes from `sync`, so all processes build the same tree.
+     * Collective; runs serially around the sync calls.
+     */
+    std::unique_ptr<Node> buildTreeDistributed(const FeatureMatrix& X,
+                                               const std::vector<double>& targets,
+                                               const std::vector<int>& sampleIndices,
+                                               const std::vector<double>& sampleWeights,
+                                               ILeafSplitSync& sync);
+
+    // Leaf each sampled row of the last built tree ended in, indexed by row
+    // id (the shard's rows when distributed); nullptr for rows the sample
+    // left out. Valid while that tree lives.
+    const std::vector<const Node*>& getRowLeaves() const { return rowLeaf_; }
+
 private:
     const LightGBMConfig& config_;
     std::unique_ptr<ISplitFinder> finder_;
@@ -78,31 +102,33 @@ private:
     // Single split local buffer, avoid multiple allocations in parallel
     std::vector<LeafInfo> localNewLeafInfos_;
 
+    // Row -> leaf of the last built tree
+    std::vector<const Node*> rowLeaf_;
+
+    // Turns node into a leaf and records it as the leaf of `rows`
+    void makeLeaf(Node* node, double value, const std::vector<int>& rows);
+
     // Serial version: retain original interface
-    bool findBestSplitSerial(const std::vector<double>& data,
-                             int rowLength,
+    bool findBestSplitSerial(const FeatureMatrix& X,
                              const std::vector<double>& targets,
                              const std::vector<int>& indices,
                              const std::vector<double>& weights,
                              LeafInfo& leafInfo);
 
     void splitLeafSerial(LeafInfo& leafInfo,
-                         const std::vector<double>& data,
-                         int rowLength,
+                         const FeatureMatrix& X,
                          const std::vector<double>& targets,
                          const std::vector<double>& sampleWeights);
 
     // Parallel version: called when needed
-    bool findBestSplitParallel(const std::vector<double>& data,
-                               int rowLength,
+    bool findBestSplitParallel(const FeatureMatrix& X,
                                const std::vector<double>& targets,
                                const std::vector<int>& indices,
                                const std::vector<double>& weights,
                                LeafInfo& leafInfo);
 
     void splitLeafParallel(LeafInfo& leafInfo,
-                           const std::vector<double>& data,
-                           int rowLength,
+                           const FeatureMatrix& X,
                            const std::vector<double>& targets,
                            const std::vector<double>& sampleWeights);
 
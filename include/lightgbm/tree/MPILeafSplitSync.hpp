@@ -0,0 +1,80 @@
+// =============================================================================
+// include/lightgbm/tree/MPILeafSplitSync.hpp - Data- and voting-parallel leaf splits
+// =============================================================================
+#pragma once
+
+#include "lightgbm/tree/ILeafSplitSync.hpp"
+#include <mpi.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * ILeafSplitSync over MPI. Rows are binned once against cuts shared by all
+ * processes (MPIQuantileSketch); every leaf then builds local (count,
+ * weight, weight * target) histograms of its rows.
+ *
+ *  - Data mode: the histograms of all features are allreduced per leaf.
+ *  - Voting mode (PV-Tree): each process ranks the features by the best
+ *    gain on its own rows and votes for its top k; the votes are
+ *    allgathered, the 2k features with the most votes (ties to the lower
+ *    index) are elected identically everywhere, and only their histograms
+ *    are allreduced. The chosen split is exact for the elected features, so
+ *    the tree can differ from data mode only where the vote missed the best
+ *    feature. Traffic per leaf drops from all features' bins to 2k
+ *    features' bins plus k ints per process.
+ *
+ * Collective payload bytes are counted per tree for comparing the modes.
+ */
+class MPILeafSplitSync : public ILeafSplitSync {
+public:
+    enum class Mode { Data, Voting };
+
+    MPILeafSplitSync(MPI_Comm comm, Mode mode, int topK, int maxBins);
+
+    // "data" / "voting"; false for anything else
+    static bool parseMode(const std::string& name, Mode& mode);
+
+    void prepare(const std::vector<double>& data, std::size_t rows, int numFeatures) override;
+    void beginTree() override;
+    void allreduceSum(double* values, int count) override;
+    bool findBestSplit(const std::vector<int>& indices,
+                       const std::vector<double>& targets,
+                       const std::vector<double>& weights,
+                       const LeafStats& stats,
+                       int minDataInLeaf,
+                       LeafSplit& split) override;
+
+    // Bytes this process passed into collectives from one beginTree() to
+    // the next, and in total (including prepare())
+    const std::vector<std::uint64_t>& getBytesPerTree() const { return bytesPerTree_; }
+    std::uint64_t getTotalBytes() const { return totalBytes_; }
+
+private:
+    MPI_Comm comm_;
+    Mode mode_;
+    int topK_;
+    int maxBins_;
+    int size_ = 1;
+
+    std::vector<std::vector<double>> cuts_;
+    std::vector<int> binOffset_;
+    std::vector<std::uint8_t> bins_;   // Column-major: bins_[f * rows_ + r]
+    std::size_t rows_ = 0;
+    int numFeatures_ = 0;
+
+    std::vector<LeafStats> hist_;       // Local histograms of the current leaf
+    std::vector<double> packed_;        // Elected features' bins, reduced in place
+
+    std::vector<std::uint64_t> bytesPerTree_;
+    std::uint64_t totalBytes_ = 0;
+
+    void countBytes(std::uint64_t bytes);
+
+    // Best split of feature f over histogram h with totals `stats`;
+    // returns its gain (0 when none qualifies)
+    double scanFeature(const LeafStats* h, int f, const LeafStats& stats,
+                       double minCount, LeafSplit* split) const;
+
+    std::vector<int> electFeatures(const LeafStats& localStats, double minLocalCount);
+};
@@ -15,3 +15,9 @@ bool splitDataset(const std::vector<double>& X,
                   const std::vector<double>& y,
                   int rowLength,
                   DataParams& out);
+
+// Moves the last `fraction` of the training rows into (X_val, y_val)
+void holdOutValidation(DataParams& dp,
+                       double fraction,
+                       std::vector<double>& X_val,
+                       std::vector<double>& y_val);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "tree/IPruner.hpp"
+#include "tree/ITreeTrainer.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Cost-complexity pruning with alpha chosen by k-fold cross-validation
+// (Breiman et al.): candidates are the geometric means of consecutive
+// critical alphas of the full tree; every fold grows an unpruned tree on the
+// other folds, scores all candidates on its held-out rows in one routing pass,
+// and the candidate with the lowest pooled MSE prunes the full tree.
+class CostComplexityCV : public IPruner {
+public:
+    // Must return a trainer that grows an unpruned tree with the full tree's settings
+    using TrainerFactory = std::function<std::unique_ptr<ITreeTrainer>()>;
+
+    struct Result {
+        double alpha = 0.0;
+        std::vector<double> candidates;    // Ascending
+        std::vector<double> cvError;       // Held-out MSE per candidate
+        std::vector<int>    leaves;        // Full-tree leaves per candidate
+    };
+
+    CostComplexityCV(const std::vector<double>& X_train, int rowLen,
+                     const std::vector<double>& y_train,
+                     TrainerFactory factory, int folds = 5, uint32_t seed = 42)
+        : X_(X_train), D_(rowLen), y_(y_train),
+          factory_(std::move(factory)), folds_(folds), seed_(seed) {}
+
+    void prune(std::unique_ptr<Node>& root) const override;
+
+    // Cross-validates without touching the tree
+    Result select(const Node* fullTree) const;
+
+    const Result& lastResult() const { return last_; }
+
+private:
+    const std::vector<double>& X_;
+    int D_;
+    const std::vector<double>& y_;
+    TrainerFactory factory_;
+    int folds_;
+    uint32_t seed_;
+    mutable Result last_;
+};
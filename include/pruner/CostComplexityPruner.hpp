@@ -1,13 +1,29 @@
 #pragma once
 
 #include "tree/IPruner.hpp"
+#include <unordered_map>
+#include <vector>
 
+// Nested subtree sequence of minimal cost-complexity pruning.
+// Entry k is the optimal subtree for alpha in [alphas[k], alphas[k+1]);
+// entry 0 is the unpruned tree, the last one the root alone.
+struct CostComplexityPath {
+    std::vector<double> alphas;     // Critical alphas, ascending, alphas[0] = 0
+    std::vector<int>    leaves;     // Leaves of the subtree at each step
+    std::vector<double> risks;      // Training risk sum(metric * samples) of its leaves
+};
 
 class CostComplexityPruner : public IPruner {
 public:
     explicit CostComplexityPruner(double alpha) : alpha_(alpha) {}
     void prune(std::unique_ptr<Node>& root) const override;
+
+    // Whole weakest-link sequence in one bottom-up pass, O(n log^2 n)
+    static CostComplexityPath computePath(const Node* root);
+
+    // Alpha at which each internal node is collapsed; non-increasing root -> leaf
+    static std::unordered_map<const Node*, double> criticalAlphas(const Node* root);
+
 private:
     double alpha_;
-    double pruneRec(Node* node) const;   
 };
@@ -3,6 +3,11 @@
 #include "tree/IPruner.hpp"
 #include <vector>
 
+// Reduced-error pruning against a held-out set. Every validation row is routed
+// once from the root; each node on its path records the squared error it would
+// have as a leaf. All prune decisions are then made in one bottom-up pass:
+// O(|validation| * depth + nodes) instead of re-routing the whole set twice
+// per internal node.
 class ReducedErrorPruner : public IPruner {
 public:
     ReducedErrorPruner(const std::vector<double>& X_val, int rowLen,
@@ -13,6 +18,9 @@ private:
     const std::vector<double>& Xv_;
     int D_;
     const std::vector<double>& yv_;
-    double validate(Node* node) const;              
-    void pruneRec(std::unique_ptr<Node>& node) const;
-};
\ No newline at end of file
+
+    // Squared error per node (preorder id) if that node predicted for its rows
+    std::vector<double> leafErrors(const std::vector<const Node*>& nodes,
+                                   const std::vector<int>& leftId,
+                                   const std::vector<int>& rightId) const;
+};
@@ -0,0 +1,198 @@
+// =============================================================================
+// include/tree/FeatureMatrix.hpp - Column-major training matrix
+// =============================================================================
+#pragma once
+
+#include "tuning/NumaPlacement.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Allocator handing out 64-byte (cache line / AVX-512) aligned storage
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n == 0) return nullptr;
+        const std::size_t bytes = ((n * sizeof(T) + Alignment - 1) / Alignment) * Alignment;
+        void* p = std::aligned_alloc(Alignment, bytes);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, std::size_t) noexcept { std::free(p); }
+
+    // resize() default-initializes, leaving trivial elements unwritten, so a
+    // new buffer is first touched (and NUMA-placed) by the threads filling it
+    template <typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new (static_cast<void*>(p)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// A row-major feature seen through its stride, so finder kernels can be
+// written once and instantiated for both layouts.
+struct StridedColumn {
+    const double* base;
+    std::size_t stride;
+    double operator[](std::size_t row) const { return base[row * stride]; }
+};
+
+// Carries a storage element type into generic lambdas passed to visit()
+template <typename T>
+struct StorageTag { using type = T; };
+
+/**
+ * Training features stored column-major: feature f of every row is one
+ * contiguous, 64-byte aligned run, so per-feature scans in the split finders
+ * stream through memory instead of gathering with a row-sized stride.
+ *
+ * Columns are kept in the narrowest element type that represents the input
+ * exactly (small integer codes -> int16, float-exact values -> float), or in
+ * an explicitly requested type. Only the stored features shrink; labels,
+ * gradients and every accumulator stay double.
+ *
+ * Optionally keeps a (non-owning) view of the row-major source for code that
+ * still walks rows, e.g. tree traversal or finders without a column path.
+ * The source vector must outlive the matrix in that case.
+ *
+ * NUMA (see NumaPlacement): the columns are first touched by the transpose's
+ * static row partition, so with pinned threads each row range lives on the
+ * node of the threads that filled it. Under the replicate policy every node
+ * gets its own copy and column access resolves to the calling thread's.
+ */
+class FeatureMatrix {
+public:
+    static constexpr std::size_t kAlignment = 64;
+
+    enum class Layout { ColumnMajor, Both };
+
+    // Auto picks the narrowest lossless type; Float32 may round
+    enum class Storage { Auto, Float64, Float32, Int16 };
+
+    FeatureMatrix() = default;
+
+    // Transposes a row-major matrix with `numFeatures` columns
+    FeatureMatrix(const std::vector<double>& rowMajor,
+                  int numFeatures,
+                  Layout layout = Layout::Both,
+                  Storage storage = Storage::Auto);
+
+    // Narrowest storage that holds every value of `values` exactly
+    static Storage narrowestExact(const std::vector<double>& values);
+
+    static const char* storageName(Storage storage);
+
+    std::size_t numRows() const { return rows_; }
+    int numFeatures() const { return cols_; }
+    Storage storage() const { return storage_; }
+    std::size_t bytesPerValue() const;
+
+    // Distance in elements between consecutive columns (one cache line multiple)
+    std::size_t columnStride() const { return stride_; }
+
+    // Typed column access; T must match storage()
+    template <typename T>
+    const T* columnAs(int f) const { return buffer<T>().data() + f * stride_; }
+
+    // Copies of the columns kept, one per NUMA node under replicate
+    int numReplicas() const { return static_cast<int>(replicas_.size()); }
+
+    // Calls fn(StorageTag<T>{}) with the element type in use, so a kernel is
+    // instantiated once per storage type and the inner loops stay branch-free.
+    template <typename Fn>
+    decltype(auto) visit(Fn&& fn) const {
+        switch (storage_) {
+            case Storage::Float32: return fn(StorageTag<float>{});
+            case Storage::Int16:   return fn(StorageTag<std::int16_t>{});
+            default:               return fn(StorageTag<double>{});
+        }
+    }
+
+    // Calls fn(const T* column) for feature f
+    template <typename Fn>
+    decltype(auto) visitColumn(int f, Fn&& fn) const {
+        return visit([&](auto tag) -> decltype(auto) {
+            using T = typename decltype(tag)::type;
+            return fn(columnAs<T>(f));
+        });
+    }
+
+    double operator()(std::size_t row, int f) const {
+        const std::size_t pos = f * stride_ + row;
+        const Buffers& b = replicas_[replica()];
+        switch (storage_) {
+            case Storage::Float32: return b.f32[pos];
+            case Storage::Int16:   return b.i16[pos];
+            default:               return b.f64[pos];
+        }
+    }
+
+    bool hasRowMajor() const { return rowMajor_ != nullptr; }
+
+    const std::vector<double>& rowMajor() const {
+        if (!rowMajor_) throw std::logic_error("FeatureMatrix: row-major view not retained");
+        return *rowMajor_;
+    }
+
+    // Materializes a row-major copy (for callers that need one and have no view)
+    std::vector<double> toRowMajor() const;
+
+private:
+    struct Buffers {
+        AlignedVector<double> f64;     // Only the buffer matching storage_ is filled
+        AlignedVector<float> f32;
+        AlignedVector<std::int16_t> i16;
+    };
+
+    template <typename T, typename B>
+    static auto& bufferOf(B& b) {
+        if constexpr (std::is_same_v<T, float>) return b.f32;
+        else if constexpr (std::is_same_v<T, std::int16_t>) return b.i16;
+        else return b.f64;
+    }
+
+    int replica() const {
+        return replicas_.size() > 1 ? NumaPlacement::currentReplica() % numReplicas() : 0;
+    }
+
+    template <typename T>
+    const AlignedVector<T>& buffer() const { return bufferOf<T>(replicas_[replica()]); }
+
+    template <typename T>
+    void transpose(const std::vector<double>& rowMajor);
+
+    // Rows [begin, end) of every column, plus the column padding for the last block
+    template <typename T>
+    void transposeRows(const std::vector<double>& rowMajor, T* out,
+                       std::size_t begin, std::size_t end) const;
+
+    std::size_t rows_ = 0;
+    int cols_ = 0;
+    std::size_t stride_ = 0;
+    Storage storage_ = Storage::Float64;
+    std::vector<Buffers> replicas_ = std::vector<Buffers>(1);
+    const std::vector<double>* rowMajor_ = nullptr;
+};
@@ -1,7 +1,20 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
+// Repeats every index by its multiplicity, turning a weighted (bootstrap)
+// view back into the plain index list the unweighted code paths expect.
+inline std::vector<int> expandByCounts(const std::vector<int>& indices,
+                                       const std::vector<int>& counts) {
+    std::vector<int> expanded;
+    expanded.reserve(indices.size() * 2);
+    for (int idx : indices) {
+        expanded.insert(expanded.end(), static_cast<std::size_t>(counts[idx]), idx);
+    }
+    return expanded;
+}
+
 class ISplitCriterion {
 public:
     virtual ~ISplitCriterion() = default;
@@ -9,4 +22,13 @@ public:
     // Compute quality metric for a node
     virtual double nodeMetric(const std::vector<double>& labels,
                               const std::vector<int>& indices) const = 0;
-};
\ No newline at end of file
+
+    // Same metric with integer sample weights: `counts[row]` is how often
+    // `row` occurs (e.g. a bootstrap multiplicity). The default expands the
+    // indices, which is exact for every criterion; additive ones override it.
+    virtual double nodeMetric(const std::vector<double>& labels,
+                              const std::vector<int>& indices,
+                              const std::vector<int>& counts) const {
+        return nodeMetric(labels, expandByCounts(indices, counts));
+    }
+};
@@ -4,6 +4,8 @@
 #include <vector>
 #include "Node.hpp"
 #include "ISplitCriterion.hpp"
+#include "FeatureMatrix.hpp"
+#include "PresortedIndex.hpp"
 
 class ISplitFinder {
 public:
@@ -17,4 +19,55 @@ public:
                   const std::vector<int>& indices,
                   double currentMetric,
                   const ISplitCriterion& criterion) const = 0;
-};
\ No newline at end of file
+
+    // Column-major variant. Finders that scan one feature at a time override
+    // this; the default forwards to the row-major path.
+    virtual std::tuple<int, double, double>
+    findBestSplit(const FeatureMatrix& X,
+                  const std::vector<double>& labels,
+                  const std::vector<int>& indices,
+                  double currentMetric,
+                  const ISplitCriterion& criterion) const {
+        if (X.hasRowMajor()) {
+            return findBestSplit(X.rowMajor(), X.numFeatures(), labels, indices,
+                                 currentMetric, criterion);
+        }
+        const std::vector<double> rowMajor = X.toRowMajor();
+        return findBestSplit(rowMajor, X.numFeatures(), labels, indices,
+                             currentMetric, criterion);
+    }
+
+    // Weighted variant: `indices` are distinct rows and `counts[row]` their
+    // integer multiplicity, so a bootstrap replica needs no copied rows. The
+    // default expands duplicates and runs the unweighted search.
+    virtual std::tuple<int, double, double>
+    findBestSplit(const FeatureMatrix& X,
+                  const std::vector<double>& labels,
+                  const std::vector<int>& indices,
+                  const std::vector<int>& counts,
+                  double currentMetric,
+                  const ISplitCriterion& criterion) const {
+        return findBestSplit(X, labels, expandByCounts(indices, counts),
+                             currentMetric, criterion);
+    }
+
+    // Presorted variant: `node` lists the node's rows in ascending order of
+    // every feature, so sort-based finders can scan without sorting.
+    // `counts` is null unless training on a weighted view. The default hands
+    // the rows to the index-based search.
+    virtual std::tuple<int, double, double>
+    findBestSplit(const FeatureMatrix& X,
+                  const std::vector<double>& labels,
+                  const SortedRows& node,
+                  const std::vector<int>* counts,
+                  double currentMetric,
+                  const ISplitCriterion& criterion) const {
+        const std::vector<int> indices(node.order(0), node.order(0) + node.count);
+        return counts ? findBestSplit(X, labels, indices, *counts, currentMetric, criterion)
+                      : findBestSplit(X, labels, indices, currentMetric, criterion);
+    }
+
+    // True when the search sorts every feature at every node, i.e. when a
+    // presorted tree builder saves work
+    virtual bool usesSortedOrder() const { return false; }
+};
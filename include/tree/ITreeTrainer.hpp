@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "Node.hpp"
+#include "FeatureMatrix.hpp"
 
 class ITreeTrainer {
 public:
@@ -11,6 +12,16 @@ public:
                        int rowLength,
                        const std::vector<double>& labels) = 0;
 
+    // Column-major variant; the default forwards to the row-major path
+    virtual void train(const FeatureMatrix& X,
+                       const std::vector<double>& labels) {
+        if (X.hasRowMajor()) {
+            train(X.rowMajor(), X.numFeatures(), labels);
+        } else {
+            train(X.toRowMajor(), X.numFeatures(), labels);
+        }
+    }
+
     virtual double predict(const double* sample,
                            int rowLength) const = 0;
 
@@ -22,6 +33,10 @@ public:
 
     const Node* getRoot() const { return root_.get(); }
 
+    // Hands the trained tree to the caller (e.g. a boosting model) instead of
+    // copying it; the trainer holds no tree afterwards
+    std::unique_ptr<Node> releaseRoot() { return std::move(root_); }
+
 protected:
     std::unique_ptr<Node> root_;
-};
\ No newline at end of file
+};
@@ -7,6 +7,7 @@ struct Node {
     bool   isLeaf      = false;
     size_t samples     = 0;
     double metric      = 0.0;      
+    double nodeMean    = 0.0;      // Mean target of the node's samples, kept once it turns internal
     
     // Union for memory efficiency
     union NodeInfo {
@@ -78,7 +79,7 @@ struct Node {
     }
     
     double getNodePrediction() const {
-        return isLeaf ? info.leaf.nodePrediction : 0.0;
+        return isLeaf ? info.leaf.nodePrediction : nodeMean;
     }
     
     Node* getLeft() const { 
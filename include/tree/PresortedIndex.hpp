@@ -0,0 +1,49 @@
+// =============================================================================
+// include/tree/PresortedIndex.hpp - Per-feature row order, sorted once
+// =============================================================================
+#pragma once
+
+#include "FeatureMatrix.hpp"
+#include <cstddef>
+#include <vector>
+
+// The rows of one tree node, kept in ascending order of every feature.
+// Feature f's order starts at rows + f * stride and holds `count` rows;
+// all features list the same rows, only the order differs.
+struct SortedRows {
+    const int*  rows   = nullptr;
+    std::size_t stride = 0;
+    std::size_t count  = 0;
+
+    const int* order(int f) const { return rows + static_cast<std::size_t>(f) * stride; }
+};
+
+/**
+ * Ascending row order of every feature of a FeatureMatrix, computed once and
+ * shared read-only by all trees trained on that matrix. Ties keep row order.
+ *
+ * A bootstrap replica gets its own sorted order by filtering the global one
+ * down to the rows it drew, which is O(N) per feature instead of a sort, and
+ * a presorted tree builder keeps that order intact through every split.
+ */
+class PresortedIndex {
+public:
+    PresortedIndex() = default;
+    explicit PresortedIndex(const FeatureMatrix& X);
+
+    std::size_t numRows() const { return rows_; }
+    int numFeatures() const { return cols_; }
+    bool empty() const { return order_.empty(); }
+
+    const int* order(int f) const { return order_.data() + static_cast<std::size_t>(f) * rows_; }
+
+    // Writes the sorted order of the rows with counts[row] > 0 into `out`,
+    // feature-major (numFeatures() runs of equal length), and returns the
+    // number of distinct rows kept.
+    std::size_t filter(const std::vector<int>& counts, std::vector<int>& out) const;
+
+private:
+    std::vector<int> order_;   // numFeatures() runs of numRows() row ids
+    std::size_t rows_ = 0;
+    int cols_ = 0;
+};
@@ -27,6 +27,41 @@ public:
                int rowLength,
                const std::vector<double>& labels) override;
 
+    // Trains on a prebuilt column-major matrix (shared across trees/iterations)
+    void train(const FeatureMatrix& X,
+               const std::vector<double>& labels) override;
+
+    // Trains on a weighted view of X: every row with counts[row] > 0 takes
+    // part and is counted counts[row] times, so a bootstrap replica needs no
+    // copied rows. `counts` is indexed by row id and must outlive the call.
+    void train(const FeatureMatrix& X,
+               const std::vector<double>& labels,
+               const std::vector<int>& counts);
+
+    // Weighted view as above, grown by the presorted builder: the replica's
+    // per-feature order is filtered from `presort` (built once on X) and kept
+    // sorted through every split, so finders that support it never sort.
+    void train(const FeatureMatrix& X,
+               const std::vector<double>& labels,
+               const std::vector<int>& counts,
+               const PresortedIndex& presort);
+
+    // Every row once, grown by the presorted builder from `presort` (built
+    // once on X), e.g. each round of a booster that refits the same matrix
+    void train(const FeatureMatrix& X,
+               const std::vector<double>& labels,
+               const PresortedIndex& presort);
+
+    // Whether the finder sorts per node, i.e. whether a PresortedIndex pays off
+    bool usesSortedOrder() const { return finder_->usesSortedOrder(); }
+
+    // Leaf each training row ended in during the last train() call, indexed
+    // by row id; nullptr for rows that took no part (e.g. out-of-bag). Lets a
+    // booster add the new tree's output with a gather instead of traversing.
+    // Empty when a post-pruner merged leaves. The leaves stay valid after
+    // releaseRoot() for as long as the released tree lives.
+    const std::vector<const Node*>& getTrainingLeaves() const { return rowLeaf_; }
+
     double predict(const double* sample,
                    int rowLength) const override;
 
@@ -37,14 +72,30 @@ public:
                   double& mae) override;
 
 private:
+    // Shared by the plain and weighted entry points
+    void trainOnRows(const FeatureMatrix& X,
+                     const std::vector<double>& labels,
+                     std::vector<int>&& rootIndices);
+
+    // Node statistics that honour sampleCounts_ when training on a weighted view
+    size_t sampleWeight(const int* begin, const int* end) const;
+    double labelSum(const std::vector<double>& labels,
+                    const std::vector<int>& indices) const;
+    double nodeMetric(const std::vector<double>& labels,
+                      const std::vector<int>& indices) const;
+    // Turns node into a leaf and records it as the leaf of `rows`
+    void makeLeaf(Node* node, double prediction, const std::vector<int>& rows);
+    std::tuple<int, double, double> findSplit(const FeatureMatrix& X,
+                                              const std::vector<double>& labels,
+                                              const std::vector<int>& indices,
+                                              double metric) const;
+
     // Enhanced: Task queue-driven tree building method
-    void buildTreeWithTaskQueue(const std::vector<double>& data,
-                                int rowLength,
+    void buildTreeWithTaskQueue(const FeatureMatrix& X,
                                 const std::vector<double>& labels,
                                 std::vector<int>&& rootIndices);
     
-    void processTask(const std::vector<double>& data,
-                     int rowLength,
+    void processTask(const FeatureMatrix& X,
                      const std::vector<double>& labels,
                      std::unique_ptr<SplitTask> task,
                      TaskQueue& taskQueue,
@@ -52,34 +103,45 @@ private:
     
     // Original methods (optimized versions)
     void splitNode(Node* node,
-                   const std::vector<double>& data,
-                   int rowLength,
+                   const FeatureMatrix& X,
                    const std::vector<double>& labels,
                    const std::vector<int>& indices,
                    int depth);
 
     void splitNodeInPlace(Node* node,
-                          const std::vector<double>& data,
-                          int rowLength,
+                          const FeatureMatrix& X,
                           const std::vector<double>& labels,
                           std::vector<int>& indices,
                           int depth);
 
     void splitNodeInPlaceParallel(Node* node,
-                                  const std::vector<double>& data,
-                                  int rowLength,
+                                  const FeatureMatrix& X,
                                   const std::vector<double>& labels,
                                   std::vector<int>& indices,
                                   int depth);
 
+    // Presorted builder: the node owns [begin, end) of every feature's run in
+    // `sorted` (runs are `stride` apart); a split stably partitions each run
+    void buildPresorted(const FeatureMatrix& X,
+                        const std::vector<double>& labels);
+
+    void splitNodePresorted(Node* node,
+                            const FeatureMatrix& X,
+                            const std::vector<double>& labels,
+                            std::vector<int>& sorted,
+                            size_t stride,
+                            size_t begin,
+                            size_t end,
+                            int depth,
+                            std::vector<char>& goesLeft);
+
     void calculateTreeStats(const Node* node,
                             int currentDepth,
                             int& maxDepth,
                             int& leafCount) const;
                             
     void splitNodeOptimized(Node* node,
-                           const std::vector<double>& data,
-                           int rowLength,
+                           const FeatureMatrix& X,
                            const std::vector<double>& labels,
                            std::vector<int>& indices,
                            int depth);
@@ -89,6 +151,15 @@ private:
     std::unique_ptr<ISplitFinder>    finder_;
     std::unique_ptr<ISplitCriterion> criterion_;
     std::unique_ptr<IPruner>         pruner_;
+
+    // Row multiplicities while training on a weighted view, else nullptr
+    const std::vector<int>* sampleCounts_ = nullptr;
+
+    // Global per-feature order while training with the presorted builder
+    const PresortedIndex* presorted_ = nullptr;
+
+    // Row -> leaf of the last trained tree (see getTrainingLeaves)
+    std::vector<const Node*> rowLeaf_;
     
     // Professor's suggestion: friend class allows BaggingTrainer to access internal structure
     friend class BaggingTrainer;
@@ -0,0 +1,22 @@
+// =============================================================================
+// include/tuning/MPIParallelCalibration.hpp - One set of parallel cutoffs per host
+// =============================================================================
+#pragma once
+
+#include "tuning/ParallelCalibration.hpp"
+#include <mpi.h>
+
+/**
+ * Left to ParallelCalibration::cutoffs(), every rank would load or
+ * calibrate on its own during training: co-located ranks would benchmark
+ * side by side, skew each other's timings, end up with different cutoffs
+ * and race on the same profile file. share() instead lets the lowest rank
+ * of each host (MPI_COMM_TYPE_SHARED) resolve the cutoffs, profile and
+ * DT_PARALLEL_* overrides included, and hands them to the host's other
+ * ranks through setOverride(). Collective over `comm`; call right after
+ * MPI_Init, before any training.
+ */
+class MPIParallelCalibration {
+public:
+    static const ParallelCutoffs& share(MPI_Comm comm);
+};
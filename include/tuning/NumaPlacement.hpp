@@ -0,0 +1,103 @@
+// =============================================================================
+// include/tuning/NumaPlacement.hpp - NUMA topology, thread pinning, data placement
+// =============================================================================
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// NUMA nodes with at least one CPU this process may run on
+struct NumaTopology {
+    std::vector<int> nodeIds;                // OS node number of each entry
+    std::vector<std::vector<int>> nodeCpus;  // Usable CPUs of each node
+    bool fromSysfs = false;                  // false: one node assumed
+
+    int numNodes() const { return static_cast<int>(nodeCpus.size()); }
+};
+
+/**
+ * Keeps the data the OpenMP kernels scan on the NUMA node of the threads
+ * that scan it. Selected with DT_NUMA (or configure()):
+ *
+ *  - off (default): no pinning; buffers are still first touched in parallel.
+ *  - partition: OpenMP threads are pinned, in contiguous blocks per node,
+ *    so the static-schedule first touch of FeatureMatrix leaves each row
+ *    range on the node of the threads that own it, and the threads'
+ *    private histograms stay where they were allocated.
+ *  - replicate: as partition, plus one copy of read-mostly data
+ *    (FeatureMatrix columns) per node that runs threads; each thread reads
+ *    its own node's copy. Costs one matrix of memory per node.
+ *
+ * Threads already bound by the runtime (OMP_PLACES / OMP_PROC_BIND) keep
+ * their place and are only mapped to its node. On a single node, or when
+ * the topology cannot be read, everything maps to node 0 and replicate
+ * behaves like partition.
+ */
+class NumaPlacement {
+public:
+    enum class Policy { Off, Partition, Replicate };
+
+    // Process-wide policy. The first call reads DT_NUMA, detects the
+    // topology, pins the threads of the default OpenMP team and prints what
+    // it found (unless the policy is off). Call outside parallel regions.
+    static Policy policy();
+
+    // Replaces the policy; must be called before training starts
+    static void configure(Policy policy);
+
+    static const NumaTopology& topology();
+
+    // Copies read-mostly data keeps: nodes running pinned threads under
+    // replicate, else 1
+    static int replicaCount();
+
+    // Replica slot of the calling thread, in [0, replicaCount())
+    static int currentReplica();
+
+    static bool parsePolicy(const std::string& name, Policy& policy);
+    static const char* policyName(Policy policy);
+
+    static void print(std::ostream& os);
+
+    // Runs fn(slot, rank, count) in one parallel region: every thread gets
+    // its replica slot and its rank among the `count` threads of that slot.
+    // Slots without a thread of their own are handed to some thread with
+    // rank 0 / count 1, so each slot is covered exactly once per rank.
+    template <typename Fn>
+    static void forEachReplicaThread(Fn&& fn);
+};
+
+template <typename Fn>
+void NumaPlacement::forEachReplicaThread(Fn&& fn) {
+    const int slots = replicaCount();
+#ifdef _OPENMP
+    std::vector<int> slotOf(omp_get_max_threads(), 0);
+    #pragma omp parallel
+    {
+        const int t = omp_get_thread_num();
+        const int T = omp_get_num_threads();
+        slotOf[t] = currentReplica();
+        #pragma omp barrier
+        int rank = 0, count = 0;
+        for (int u = 0; u < T; ++u) {
+            if (slotOf[u] != slotOf[t]) continue;
+            if (u < t) ++rank;
+            ++count;
+        }
+        fn(slotOf[t], rank, count);
+
+        for (int s = 0; s < slots; ++s) {
+            if (s % T != t) continue;
+            bool covered = false;
+            for (int u = 0; u < T && !covered; ++u) covered = slotOf[u] == s;
+            if (!covered) fn(s, 0, 1);
+        }
+    }
+#else
+    for (int s = 0; s < slots; ++s) fn(s, 0, 1);
+#endif
+}
@@ -0,0 +1,68 @@
+// =============================================================================
+// include/tuning/ParallelCalibration.hpp - Per-machine parallel granularity cutoffs
+// =============================================================================
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+// Cutoffs that decide when a kernel is worth an OpenMP region. They used to be
+// hard-coded (N > 1000, num_threads(4), depth <= 2 && N > 2000, ...) and tuned
+// for one machine; now they are measured once per host and cached on disk.
+struct ParallelCutoffs {
+    // Split finders: node size above which features are scanned in parallel
+    std::size_t finderParallelMinSamples = 1000;
+
+    // Node-level reductions (label sums, evaluation)
+    std::size_t reductionParallelMinSamples = 1000;
+    int reductionThreads = 4;
+
+    // SingleTreeTrainer recursion
+    std::size_t taskQueueMinSamples = 1000;
+    int taskQueueMaxWorkers = 8;
+    int recursionMaxDepth = 2;
+    std::size_t recursionMinSamples = 2000;
+    std::size_t recursionMinChildSamples = 500;
+
+    // LightGBM leaf-wise builder
+    std::size_t leafwiseParallelMinSamples = 2000;
+
+    // Element-wise boosting updates (residuals, prediction updates)
+    std::size_t elementwiseParallelMinSamples = 1000;
+    int elementwiseChunkSize = 2048;
+
+    // Host signature the cutoffs were measured for
+    int calibratedThreads = 0;
+};
+
+class ParallelCalibration {
+public:
+    // Returns the process-wide cutoffs. On first use they are loaded from the
+    // profile file; if it is missing or was measured with a different thread
+    // count, a short microbenchmark runs and the result is written back.
+    // DT_PARALLEL_<KEY> environment variables then override single cutoffs,
+    // KEY being the profile key in upper case (DT_PARALLEL_REDUCTION_THREADS=2,
+    // DT_PARALLEL_RECURSION_MIN_SAMPLES=never, ...); they are not saved.
+    static const ParallelCutoffs& cutoffs();
+
+    // Replaces the process-wide cutoffs as given (DT_PARALLEL_* is not
+    // applied again), e.g. cutoffs computed by another process. Must be
+    // called before training starts.
+    static void setOverride(const ParallelCutoffs& cutoffs);
+
+    // Runs the microbenchmarks unconditionally (~0.2s).
+    static ParallelCutoffs calibrate(bool verbose = false);
+
+    // Profile location: $DT_PARALLEL_PROFILE, else
+    // $HOME/.decision_tree/parallel_profile_<host>.cfg, else
+    // ./parallel_profile.cfg (the build directory when run from there).
+    static std::string profilePath();
+
+    // false when the file is missing or lacks any key
+    static bool load(const std::string& path, ParallelCutoffs& out);
+    // Writes a temporary file and renames it over `path`
+    static bool save(const std::string& path, const ParallelCutoffs& cutoffs);
+
+    static void print(const ParallelCutoffs& cutoffs, std::ostream& os);
+};
@@ -25,6 +25,7 @@ struct XGBoostAppOptions {
     double gamma = 0.0;
     double subsample = 1.0;
     double colsampleByTree = 1.0;
+    uint32_t seed = 42;
     
     // Training control
     bool verbose = true;
@@ -32,6 +33,10 @@ struct XGBoostAppOptions {
     double tolerance = 1e-7;
     double valSplit = 0.2;
     
+    // Post-training ensemble pruning on a held-out valSplit ("greedy"/"omp")
+    std::string pruneMethod;
+    double pruneTol = 0.01;
+    
     // Split method
     bool useApproxSplit = false;
     int maxBins = 256;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string> 
 #include <vector> 
 #include <memory> 
@@ -21,6 +22,7 @@ struct XGBoostConfig {
     // Sampling parameters
     double subsample = 1.0;           
     double colsampleByTree = 1.0;     
+    uint32_t seed = 42;               // Keys the per-round subsample streams
     
     // Training control
     bool verbose = true;              
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tree/Node.hpp"
+#include "ensemble/EnsemblePruner.hpp"
 #include <vector>
 #include <memory>
 #include <algorithm>    
@@ -86,6 +87,30 @@ public:
         return importance;
     }
     
+    // Keeps the trees the pruner selects on (X_val, y_val), reweighted
+    EnsembleSelection pruneTrees(const EnsemblePruner& pruner,
+                                 const std::vector<double>& X_val,
+                                 int rowLength,
+                                 const std::vector<double>& y_val) {
+        // Nothing to select on: leave the model as it is
+        if (y_val.empty() || trees_.empty()) return EnsembleSelection();
+        std::vector<const Node*> roots;
+        std::vector<double> factors;
+        for (const auto& xgbTree : trees_) {
+            roots.push_back(xgbTree.tree.get());
+            factors.push_back(xgbTree.weight);
+        }
+        EnsembleSelection sel = pruner.selectAdditive(roots, factors, globalBaseScore_, X_val, rowLength, y_val);
+        std::vector<XGBTree> kept;
+        kept.reserve(sel.trees.size());
+        for (size_t k = 0; k < sel.trees.size(); ++k) {
+            kept.emplace_back(std::move(trees_[sel.trees[k]].tree), sel.weights[k], sel.baseScore);
+        }
+        trees_ = std::move(kept);
+        globalBaseScore_ = sel.baseScore;
+        return sel;
+    }
+    
     // Clean up resources
     void clear() {
         trees_.clear();
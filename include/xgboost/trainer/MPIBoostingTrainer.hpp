@@ -0,0 +1,110 @@
+// =============================================================================
+// include/xgboost/trainer/MPIBoostingTrainer.hpp - Data-parallel histogram boosting
+// =============================================================================
+#pragma once
+
+#include "xgboost/core/XGBoostConfig.hpp"
+#include "xgboost/model/XGBoostModel.hpp"
+#include "xgboost/criterion/XGBoostCriterion.hpp"
+#include "boosting/loss/IRegressionLoss.hpp"
+#include <mpi.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Data-parallel XGBoost-style boosting: the training rows are sharded across
+ * the processes of `comm`, and every process grows the same trees.
+ *
+ *  - Binning: shared quantile cuts from MPIQuantileSketch, which do not
+ *    depend on the process count.
+ *  - Trees grow level by level. Each process builds (G, H) histograms of its
+ *    own rows for the level's nodes and one MPI_Allreduce per level sums
+ *    them. Only the child with the smaller hessian sum of every split is
+ *    built and reduced; its sibling is the parent's histogram minus it.
+ *  - Split search runs on the reduced histograms, so every process picks the
+ *    same splits and no split decision is communicated.
+ *
+ * Uses numRounds, eta, maxDepth, minChildWeight, lambda, gamma, maxBins
+ * (<= 256), objective and verbose from XGBoostConfig; row/column
+ * subsampling and early stopping are not supported here.
+ */
+class MPIBoostingTrainer {
+public:
+    explicit MPIBoostingTrainer(const XGBoostConfig& config, MPI_Comm comm = MPI_COMM_WORLD);
+
+    // Collective. data/labels: this process's shard (row-major, numFeatures
+    // columns); the shards of all processes form the training set
+    void train(const std::vector<double>& data,
+               int numFeatures,
+               const std::vector<double>& labels);
+
+    // Local: every process holds the full model
+    double predict(const double* sample, int numFeatures) const;
+    void predictBatch(const std::vector<double>& X,
+                      int numFeatures,
+                      std::vector<double>& predictions) const;
+
+    // Collective: MSE / MAE over the union of the processes' shards
+    void evaluate(const std::vector<double>& X,
+                  int numFeatures,
+                  const std::vector<double>& y,
+                  double& mse,
+                  double& mae) const;
+
+    const XGBoostModel* getModel() const { return &model_; }
+    const std::vector<double>& getTrainingLoss() const { return trainingLoss_; }
+    std::vector<double> getFeatureImportance(int numFeatures) const { return model_.getFeatureImportance(numFeatures); }
+
+    // Seconds this process spent building histograms / in the per-level
+    // allreduce during the last train()
+    double getHistogramSeconds() const { return histSeconds_; }
+    double getAllreduceSeconds() const { return allreduceSeconds_; }
+
+    // Rows [begin, end) of an n-row table owned by `rank` of `size`
+    static void shardRange(std::size_t n, int rank, int size, std::size_t& begin, std::size_t& end);
+
+private:
+    struct GradPair {
+        double g;
+        double h;
+    };
+
+    struct SplitCandidate {
+        int    feature = -1;
+        int    bin     = -1;
+        double gain    = 0.0;
+        double leftG = 0.0, leftH = 0.0;
+    };
+
+    XGBoostConfig config_;
+    MPI_Comm comm_;
+    int rank_ = 0;
+    int size_ = 1;
+
+    XGBoostModel model_;
+    std::unique_ptr<IRegressionLoss> loss_;
+    XGBoostCriterion criterion_;
+    std::vector<double> trainingLoss_;
+
+    // Cut points (see MPIQuantileSketch); histogram slot of (f, b) is
+    // binOffset_[f] + b
+    std::vector<std::vector<double>> cuts_;
+    std::vector<int> binOffset_;
+    int totalBins_ = 0;
+    std::vector<std::uint8_t> bins_;   // Column-major: bins_[f * n + r]
+    std::size_t localRows_ = 0;
+
+    double histSeconds_ = 0.0;
+    double allreduceSeconds_ = 0.0;
+
+    std::unique_ptr<Node> growTree(const std::vector<GradPair>& gh,
+                                   std::vector<double>& predictions);
+
+    void buildHistograms(const std::vector<const std::vector<int>*>& rows,
+                         const std::vector<GradPair>& gh,
+                         std::vector<GradPair>& hist);
+
+    SplitCandidate findBestSplit(const GradPair* hist, double G, double H) const;
+};
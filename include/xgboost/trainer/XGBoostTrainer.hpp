@@ -5,19 +5,20 @@
 #include "xgboost/loss/XGBoostLossFactory.hpp"
 #include "xgboost/criterion/XGBoostCriterion.hpp"
 #include "tree/ITreeTrainer.hpp"
+#include "tree/FeatureMatrix.hpp"
 #include <memory>
 #include <vector>
 
 // Column-wise data structure - optimized memory access
 struct ColumnData {
     std::vector<std::vector<int>> sortedIndices;  // Sorted indices for each column
-    std::vector<double> values;                   // Column-stored values
+    const FeatureMatrix& values;                  // Column-major feature values
     int numFeatures;
     size_t numSamples;
     
-    ColumnData(int features, size_t samples) : numFeatures(features), numSamples(samples) {
-        sortedIndices.resize(features);
-        values.reserve(samples * features);
+    explicit ColumnData(const FeatureMatrix& matrix)
+        : values(matrix), numFeatures(matrix.numFeatures()), numSamples(matrix.numRows()) {
+        sortedIndices.resize(numFeatures);
     }
 };
 
@@ -27,11 +28,20 @@ public:
 
     // ITreeTrainer interface
     void train(const std::vector<double>& data, int rowLength, const std::vector<double>& labels) override;
+    void train(const FeatureMatrix& X, const std::vector<double>& labels) override;
     double predict(const double* sample, int rowLength) const override;
     void evaluate(const std::vector<double>& X, int rowLength, const std::vector<double>& y, double& mse, double& mae) override;
 
     // XGBoost specific methods
     const XGBoostModel* getXGBModel() const { return &model_; }
+    
+    // Post-training ensemble pruning on a validation set (see EnsemblePruner)
+    EnsembleSelection pruneEnsemble(const EnsemblePruner& pruner,
+                                    const std::vector<double>& X_val,
+                                    int rowLength,
+                                    const std::vector<double>& y_val) {
+        return model_.pruneTrees(pruner, X_val, rowLength, y_val);
+    }
     const std::vector<double>& getTrainingLoss() const { return trainingLoss_; }
     std::vector<double> getFeatureImportance(int numFeatures) const { return model_.getFeatureImportance(numFeatures); }
 
@@ -57,13 +67,15 @@ private:
     std::unique_ptr<Node> trainSingleTree(const ColumnData& columnData, 
                                          const std::vector<double>& gradients, 
                                          const std::vector<double>& hessians, 
-                                         const std::vector<char>& rootMask) const;
+                                         const std::vector<char>& rootMask,
+                                         std::vector<const Node*>& rowLeaf) const;
     
     void buildXGBNode(Node* node, 
                      const ColumnData& columnData, 
                      const std::vector<double>& gradients,
                      const std::vector<double>& hessians, 
                      const std::vector<char>& nodeMask, 
+                     std::vector<const Node*>& rowLeaf,
                      int depth) const;
     
     std::tuple<int, double, double> findBestSplitXGB(
@@ -76,6 +88,9 @@ private:
     double computeBaseScore(const std::vector<double>& y) const;
     bool shouldEarlyStop(const std::vector<double>& losses, int patience) const;
     double computeValidationLoss() const;
-    void updatePredictions(const std::vector<double>& data, int rowLength, 
-                          const Node* tree, std::vector<double>& predictions) const;
+    // rowLeaf[i]: leaf row i reached while growing `tree`, or nullptr
+    void updatePredictions(const FeatureMatrix& X,
+                          const Node* tree,
+                          const std::vector<const Node*>& rowLeaf,
+                          std::vector<double>& predictions) const;
 };
\ No newline at end of file
@@ -28,6 +28,14 @@ int main(int argc, char** argv) {
     if (argc >= 9)  opts.prunerType = argv[8];
     if (argc >= 10) opts.prunerParam = std::stod(argv[9]);
     if (argc >= 11) opts.seed = static_cast<uint32_t>(std::stoi(argv[10]));
+    if (argc >= 12) opts.oobStopTol = std::stod(argv[11]);
+    if (argc >= 13) opts.oobWindow = std::stoi(argv[12]);
+    if (argc >= 14) opts.anytimeTol = std::stod(argv[13]);
+    if (argc >= 15) opts.pruneMethod = argv[14];
+    if (argc >= 16) opts.pruneTol = std::stod(argv[15]);
+    if (argc >= 17) opts.distillTrees = std::stoi(argv[16]);
+    if (argc >= 18) opts.distillDepth = std::stoi(argv[17]);
+    if (argc >= 19) opts.distillAugment = std::stoi(argv[18]);
     
     // Run bagging
     runBaggingApp(opts);
@@ -13,7 +13,11 @@ void printUsage(const char* programName) {
     std::cout << "  --learning-rate FLOAT Learning rate (default: 0.1)\n";
     std::cout << "  --num-leaves INT      Max leaves (default: 31)\n";
     std::cout << "  --max-depth INT       Max depth (default: -1)\n";
-    std::cout << "  --min-data-in-leaf INT Min samples per leaf (default: 20)\n\n";
+    std::cout << "  --min-data-in-leaf INT Min samples per leaf (default: 20)\n";
+    std::cout << "  --seed INT            Seed of the GOSS sampling streams (default: 42)\n\n";
+    std::cout << "Ensemble Pruning:\n";
+    std::cout << "  --prune-ensemble STR  greedy | omp: keep a subset of trees chosen on a held-out split\n";
+    std::cout << "  --prune-tol FLOAT     Allowed relative validation MSE increase (default: 0.01)\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << programName << " --data data.csv\n";
     std::cout << "  " << programName << " --data data.csv --num-leaves 63 --learning-rate 0.05\n";
@@ -33,6 +37,7 @@ bool parseArguments(int argc, char** argv, LightGBMAppOptions& opts) {
         else if (arg == "--min-data-in-leaf" && i + 1 < argc) opts.minDataInLeaf = std::stoi(argv[++i]);
         else if (arg == "--top-rate" && i + 1 < argc) opts.topRate = std::stod(argv[++i]);
         else if (arg == "--other-rate" && i + 1 < argc) opts.otherRate = std::stod(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) opts.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
         else if (arg == "--max-bin" && i + 1 < argc) opts.maxBin = std::stoi(argv[++i]);
         else if (arg == "--max-conflict" && i + 1 < argc) opts.maxConflictRate = std::stod(argv[++i]);
         else if (arg == "--lambda" && i + 1 < argc) opts.lambda = std::stod(argv[++i]);
@@ -41,6 +46,8 @@ bool parseArguments(int argc, char** argv, LightGBMAppOptions& opts) {
         else if (arg == "--disable-goss") opts.enableGOSS = false;
         else if (arg == "--enable-bundling") opts.enableFeatureBundling = true;
         else if (arg == "--disable-bundling") opts.enableFeatureBundling = false;
+        else if (arg == "--prune-ensemble" && i + 1 < argc) opts.pruneMethod = argv[++i];
+        else if (arg == "--prune-tol" && i + 1 < argc) opts.pruneTol = std::stod(argv[++i]);
         else if (arg == "--verbose") opts.verbose = true;
         else if (arg == "--quiet") opts.verbose = false;
         else {
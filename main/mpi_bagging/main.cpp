@@ -1,7 +1,10 @@
 
 #include "ensemble/MPIBaggingTrainer.hpp"
 #include "functions/io/DataIO.hpp"
+#include "functions/io/MPIDataIO.hpp"
+#include "tuning/MPIParallelCalibration.hpp"
 #include "pipeline/DataSplit.hpp"
+#include "boosting/distill/ForestDistiller.hpp"
 #include <mpi.h>
 #include <iostream>
 #include <chrono>
@@ -18,6 +21,14 @@ struct MPIBaggingOptions {
     std::string prunerType;
     double prunerParam;
     uint32_t seed;
+    int distillTrees = 0;     // > 0: distill the forest into a GBRT student
+    int distillDepth = 4;
+    int distillAugment = 2;
+    std::string binaryOut;    // Non-empty: rank 0 saves the loaded data as a .bin dataset
+    std::string forestOut;    // Non-empty: rank 0 saves the merged forest
+    std::string schedule = "static";   // "dynamic": chunked tree dispatch from a shared counter
+    std::string scoring = "gather";    // "collective": keep trees distributed, score with pipelined allreduces
+    int scoringChunkRows = 4096;
 };
 
 int main(int argc, char** argv) {
@@ -26,6 +37,9 @@ int main(int argc, char** argv) {
     int mpiRank, mpiSize;
     MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
     MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+
+    // Same parallel cutoffs on every rank of a host, resolved once
+    MPIParallelCalibration::share(MPI_COMM_WORLD);
     
     // Default parameters
     MPIBaggingOptions opts;
@@ -51,87 +65,140 @@ int main(int argc, char** argv) {
     if (argc >= 9) opts.prunerType = argv[8];
     if (argc >= 10) opts.prunerParam = std::stod(argv[9]);
     if (argc >= 11) opts.seed = static_cast<uint32_t>(std::stoi(argv[10]));
+    if (argc >= 12) opts.distillTrees = std::stoi(argv[11]);
+    if (argc >= 13) opts.distillDepth = std::stoi(argv[12]);
+    if (argc >= 14) opts.distillAugment = std::stoi(argv[13]);
+    if (argc >= 15) opts.binaryOut = argv[14];
+    if (argc >= 16) opts.forestOut = argv[15];
+    if (argc >= 17) opts.schedule = argv[16];
+    if (argc >= 18) opts.scoring = argv[17];
+    if (argc >= 19) opts.scoringChunkRows = std::stoi(argv[18]);
     
     try {
-        // Data loading and distribution
-        std::vector<double> trainX, trainY, testX, testY;
-        int numFeatures = 0;
+        // Collective load: every process parses its own byte range of the
+        // CSV (or maps a .bin dataset) and ends up with the full table, so
+        // the deterministic split needs no broadcast
+        auto loadStart = std::chrono::high_resolution_clock::now();
+        std::vector<double> X, y;
+        int rawRowLength = 0;
+        MPIDataIO mpiIO(MPI_COMM_WORLD);
+        if (!mpiIO.load(opts.dataPath, X, y, rawRowLength) || y.empty()) {
+            if (mpiRank == 0) std::cerr << "Error: Failed to load data" << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        auto loadEnd = std::chrono::high_resolution_clock::now();
         
-        // Master process loads data
-        if (mpiRank == 0) {
+        if (mpiRank == 0 && !opts.binaryOut.empty()) {
             DataIO io;
-            int rawRowLength = 0;
-            auto [X, y] = io.readCSV(opts.dataPath, rawRowLength);
-            
-            if (X.empty() || y.empty()) {
-                std::cerr << "Error: Failed to load data" << std::endl;
-                MPI_Abort(MPI_COMM_WORLD, 1);
-            }
-            
-            numFeatures = rawRowLength - 1;
-            
-            DataParams dp;
-            if (!splitDataset(X, y, rawRowLength, dp)) {
-                std::cerr << "Failed to split dataset" << std::endl;
-                MPI_Abort(MPI_COMM_WORLD, 1);
+            if (io.writeBinary(opts.binaryOut, X, y, rawRowLength)) {
+                std::cout << "Wrote binary dataset: " << opts.binaryOut << std::endl;
             }
-            
-            trainX = std::move(dp.X_train);
-            trainY = std::move(dp.y_train);
-            testX = std::move(dp.X_test);
-            testY = std::move(dp.y_test);
         }
         
-        // Broadcast and distribute data
-        MPI_Bcast(&numFeatures, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        int trainSize = 0;
-        if (mpiRank == 0) trainSize = static_cast<int>(trainY.size());
-        MPI_Bcast(&trainSize, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        if (mpiRank != 0) {
-            trainX.resize(trainSize * numFeatures);
-            trainY.resize(trainSize);
+        const int numFeatures = rawRowLength - 1;
+        DataParams dp;
+        if (!splitDataset(X, y, rawRowLength, dp)) {
+            std::cerr << "Failed to split dataset" << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
         }
-        
-        MPI_Bcast(trainX.data(), trainSize * numFeatures, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-        MPI_Bcast(trainY.data(), trainSize, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        std::vector<double>().swap(X);
+        std::vector<double>().swap(y);
+        std::vector<double>& trainX = dp.X_train;
+        std::vector<double>& trainY = dp.y_train;
+        std::vector<double>& testX = dp.X_test;
+        std::vector<double>& testY = dp.y_test;
         
         // Create and train MPI Bagging trainer
         MPIBaggingTrainer trainer(
             opts.numTrees, opts.sampleRatio, opts.maxDepth, opts.minSamplesLeaf,
             opts.criterion, opts.splitMethod, opts.prunerType, opts.prunerParam, opts.seed
         );
+        trainer.setDynamicScheduling(opts.schedule == "dynamic");
+        trainer.setScoringChunkRows(static_cast<size_t>(std::max(1, opts.scoringChunkRows)));
         
         auto trainStart = std::chrono::high_resolution_clock::now();
         trainer.train(trainX, numFeatures, trainY);
         auto trainEnd = std::chrono::high_resolution_clock::now();
         
-        // Distribute test data
-        int testSize = 0;
-        if (mpiRank == 0) testSize = static_cast<int>(testY.size());
-        MPI_Bcast(&testSize, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        
-        if (mpiRank != 0) {
-            testX.resize(testSize * numFeatures);
-            testY.resize(testSize);
+        // Gather: every process receives the whole forest, so scoring below
+        // needs no per-sample communication. Collective: trees stay where
+        // they were trained (rank 0 only collects them to save) and every
+        // prediction is a chunked, pipelined allreduce.
+        const bool collectiveScoring = opts.scoring == "collective";
+        if (!collectiveScoring) {
+            trainer.gatherForest();
+        } else if (!opts.forestOut.empty()) {
+            trainer.gatherForest(0);
+        }
+        if (mpiRank == 0 && !opts.forestOut.empty() && trainer.saveForest(opts.forestOut)) {
+            std::cout << "Wrote forest: " << opts.forestOut << std::endl;
         }
-        
-        MPI_Bcast(testX.data(), testSize * numFeatures, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-        MPI_Bcast(testY.data(), testSize, MPI_DOUBLE, 0, MPI_COMM_WORLD);
         
         // Evaluation
         double mse = 0.0, mae = 0.0;
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto evalStart = std::chrono::high_resolution_clock::now();
         trainer.evaluate(testX, numFeatures, testY, mse, mae);
+        auto evalEnd = std::chrono::high_resolution_clock::now();
+        const double oobError = trainer.getOOBError(trainX, numFeatures, trainY);
         
         if (mpiRank == 0) {
             auto trainTime = std::chrono::duration_cast<std::chrono::milliseconds>(trainEnd - trainStart);
+            std::cout << "Load time: " << std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd - loadStart).count()
+                      << "ms (" << mpiSize << " processes)" << std::endl;
             std::cout << "Training time: " << trainTime.count() << "ms" << std::endl;
+            std::cout << "Evaluation time: "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(evalEnd - evalStart).count()
+                      << "ms (" << (collectiveScoring ? "collective, " + std::to_string(opts.scoringChunkRows) + "-row chunks"
+                                                      : std::string("gathered forest")) << ")" << std::endl;
             std::cout << "Final MSE: " << mse << std::endl;
             std::cout << "Final MAE: " << mae << std::endl;
+            std::cout << "OOB MSE: " << oobError << std::endl;
             std::cout << "Total Trees: " << opts.numTrees << " (distributed across " << mpiSize << " processes)" << std::endl;
         }
         
+        // Distillation: each process samples leaf boxes from its own trees and
+        // the buffers are summed (each augmented row is written by the one
+        // process owning the tree it drew). Labelling uses the collective
+        // predictBatch, so every process fits the same, deterministic student.
+        if (opts.distillTrees > 0) {
+            DistillConfig dc;
+            dc.numTrees = opts.distillTrees;
+            dc.maxDepth = opts.distillDepth;
+            dc.augmentFactor = opts.distillAugment;
+            dc.seed = opts.seed;
+            ForestDistiller distiller(dc);
+            
+            auto teacher = [&trainer](const std::vector<double>& X, int rowLength,
+                                      std::vector<double>& pred) {
+                trainer.predictBatch(X, rowLength, pred);
+            };
+            
+            auto distillStart = std::chrono::high_resolution_clock::now();
+            std::vector<double> localAugmented;
+            distiller.sampleLeafBoxes(trainer.getLocalTreeRoots(), trainer.getLocalTreeIds(),
+                                      trainer.getNumTrees(), trainX, numFeatures, localAugmented);
+            std::vector<double> augmented(localAugmented.size());
+            MPI_Allreduce(localAugmented.data(), augmented.data(),
+                          static_cast<int>(augmented.size()), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+            auto student = distiller.train(teacher, trainX, numFeatures, augmented);
+            auto distillEnd = std::chrono::high_resolution_clock::now();
+            
+            const DistillReport report =
+                ForestDistiller::evaluate(teacher, *student, testX, numFeatures, testY);
+            if (mpiRank == 0) {
+                std::cout << "Distilled GBRT (" << opts.distillTrees << " trees, depth "
+                          << opts.distillDepth << "): Test MSE: " << report.studentMSE
+                          << " | Fidelity MSE: " << report.fidelityMSE
+                          << " (R2 " << report.fidelityR2 << ")"
+                          << " | Predict: " << report.teacherPredictUs / 1000 << "ms -> "
+                          << report.studentPredictUs / 1000 << "ms"
+                          << " | Distill Time: "
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(distillEnd - distillStart).count()
+                          << "ms" << std::endl;
+            }
+        }
+        
     } catch (const std::exception& e) {
         std::cerr << "Process " << mpiRank << " error: " << e.what() << std::endl;
         MPI_Abort(MPI_COMM_WORLD, 1);
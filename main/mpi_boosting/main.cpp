@@ -0,0 +1,141 @@
+
+#include "xgboost/trainer/MPIBoostingTrainer.hpp"
+#include "functions/io/MPIDataIO.hpp"
+#include "tuning/MPIParallelCalibration.hpp"
+#include "pipeline/DataSplit.hpp"
+#include <mpi.h>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+struct MPIBoostingOptions {
+    std::string dataPath;
+    int numRounds;
+    double eta;
+    int maxDepth;
+    double lambda;
+    double gamma;
+    int minChildWeight;
+    int maxBins;
+    std::string objective;
+};
+
+// Copies rows [begin, end) of a row-major table
+static void takeRows(const std::vector<double>& X, const std::vector<double>& y, int numFeatures,
+                     std::size_t begin, std::size_t end,
+                     std::vector<double>& shardX, std::vector<double>& shardY) {
+    shardX.assign(X.begin() + begin * numFeatures, X.begin() + end * numFeatures);
+    shardY.assign(y.begin() + begin, y.begin() + end);
+}
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+
+    int mpiRank, mpiSize;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+
+    // Same parallel cutoffs on every rank of a host, resolved once
+    MPIParallelCalibration::share(MPI_COMM_WORLD);
+
+    // Default parameters
+    MPIBoostingOptions opts;
+    opts.dataPath = "../data/data_clean/cleaned_data.csv";
+    opts.numRounds = 100;
+    opts.eta = 0.3;
+    opts.maxDepth = 6;
+    opts.lambda = 1.0;
+    opts.gamma = 0.0;
+    opts.minChildWeight = 1;
+    opts.maxBins = 256;
+    opts.objective = "reg:squarederror";
+
+    // Parse arguments
+    if (argc >= 2) opts.dataPath = argv[1];
+    if (argc >= 3) opts.numRounds = std::stoi(argv[2]);
+    if (argc >= 4) opts.eta = std::stod(argv[3]);
+    if (argc >= 5) opts.maxDepth = std::stoi(argv[4]);
+    if (argc >= 6) opts.lambda = std::stod(argv[5]);
+    if (argc >= 7) opts.gamma = std::stod(argv[6]);
+    if (argc >= 8) opts.minChildWeight = std::stoi(argv[7]);
+    if (argc >= 9) opts.maxBins = std::stoi(argv[8]);
+    if (argc >= 10) opts.objective = argv[9];
+
+    try {
+        auto loadStart = std::chrono::high_resolution_clock::now();
+        std::vector<double> X, y;
+        int rawRowLength = 0;
+        MPIDataIO mpiIO(MPI_COMM_WORLD);
+        if (!mpiIO.load(opts.dataPath, X, y, rawRowLength) || y.empty()) {
+            if (mpiRank == 0) std::cerr << "Error: Failed to load data" << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        auto loadEnd = std::chrono::high_resolution_clock::now();
+
+        const int numFeatures = rawRowLength - 1;
+        DataParams dp;
+        if (!splitDataset(X, y, rawRowLength, dp)) {
+            std::cerr << "Failed to split dataset" << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        std::vector<double>().swap(X);
+        std::vector<double>().swap(y);
+
+        // Data parallelism: each process keeps one contiguous block of the
+        // train and test rows
+        std::vector<double> trainX, trainY, testX, testY;
+        std::size_t begin = 0, end = 0;
+        MPIBoostingTrainer::shardRange(dp.y_train.size(), mpiRank, mpiSize, begin, end);
+        takeRows(dp.X_train, dp.y_train, numFeatures, begin, end, trainX, trainY);
+        MPIBoostingTrainer::shardRange(dp.y_test.size(), mpiRank, mpiSize, begin, end);
+        takeRows(dp.X_test, dp.y_test, numFeatures, begin, end, testX, testY);
+        dp = DataParams();
+
+        XGBoostConfig config;
+        config.numRounds = opts.numRounds;
+        config.eta = opts.eta;
+        config.maxDepth = opts.maxDepth;
+        config.lambda = opts.lambda;
+        config.gamma = opts.gamma;
+        config.minChildWeight = opts.minChildWeight;
+        config.maxBins = opts.maxBins;
+        config.objective = opts.objective;
+        config.verbose = true;
+
+        MPIBoostingTrainer trainer(config, MPI_COMM_WORLD);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto trainStart = std::chrono::high_resolution_clock::now();
+        trainer.train(trainX, numFeatures, trainY);
+        auto trainEnd = std::chrono::high_resolution_clock::now();
+
+        double mse = 0.0, mae = 0.0;
+        trainer.evaluate(testX, numFeatures, testY, mse, mae);
+
+        // Slowest process bounds the level-synchronous training
+        double times[2] = {trainer.getHistogramSeconds(), trainer.getAllreduceSeconds()};
+        double maxTimes[2] = {0.0, 0.0};
+        MPI_Reduce(times, maxTimes, 2, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+        if (mpiRank == 0) {
+            std::cout << "Load time: " << std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd - loadStart).count()
+                      << "ms (" << mpiSize << " processes)" << std::endl;
+            std::cout << "Training time: "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(trainEnd - trainStart).count()
+                      << "ms" << std::endl;
+            std::cout << "Histogram time (max): " << static_cast<long long>(maxTimes[0] * 1000) << "ms"
+                      << " | Allreduce time (max): " << static_cast<long long>(maxTimes[1] * 1000) << "ms" << std::endl;
+            std::cout << "Test MSE: " << mse << std::endl;
+            std::cout << "Test MAE: " << mae << std::endl;
+            std::cout << "Total Trees: " << trainer.getModel()->getTreeCount()
+                      << " (rows sharded across " << mpiSize << " processes)" << std::endl;
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Process " << mpiRank << " error: " << e.what() << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,146 @@
+
+#include "lightgbm/trainer/LightGBMTrainer.hpp"
+#include "lightgbm/tree/MPILeafSplitSync.hpp"
+#include "functions/io/MPIDataIO.hpp"
+#include "tuning/MPIParallelCalibration.hpp"
+#include "pipeline/DataSplit.hpp"
+#include <mpi.h>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+
+struct MPILightGBMOptions {
+    std::string dataPath;
+    int numIterations;
+    double learningRate;
+    int numLeaves;
+    int minDataInLeaf;
+    int maxBin;
+    std::string parallelMode;   // "data" | "voting"
+    int votingTopK;
+};
+
+// Rows [begin, end) of a row-major table owned by `rank` of `size`
+static void takeShard(const std::vector<double>& X, const std::vector<double>& y, int numFeatures,
+                      int rank, int size,
+                      std::vector<double>& shardX, std::vector<double>& shardY) {
+    const std::size_t n = y.size();
+    const std::size_t begin = n * rank / size;
+    const std::size_t end = n * (rank + 1) / size;
+    shardX.assign(X.begin() + begin * numFeatures, X.begin() + end * numFeatures);
+    shardY.assign(y.begin() + begin, y.begin() + end);
+}
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+
+    int mpiRank, mpiSize;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+
+    // Same parallel cutoffs on every rank of a host, resolved once
+    MPIParallelCalibration::share(MPI_COMM_WORLD);
+
+    // Default parameters
+    MPILightGBMOptions opts;
+    opts.dataPath = "../data/data_clean/cleaned_data.csv";
+    opts.numIterations = 100;
+    opts.learningRate = 0.1;
+    opts.numLeaves = 31;
+    opts.minDataInLeaf = 20;
+    opts.maxBin = 255;
+    opts.parallelMode = "voting";
+    opts.votingTopK = 5;
+
+    // Parse arguments
+    if (argc >= 2) opts.dataPath = argv[1];
+    if (argc >= 3) opts.numIterations = std::stoi(argv[2]);
+    if (argc >= 4) opts.learningRate = std::stod(argv[3]);
+    if (argc >= 5) opts.numLeaves = std::stoi(argv[4]);
+    if (argc >= 6) opts.minDataInLeaf = std::stoi(argv[5]);
+    if (argc >= 7) opts.maxBin = std::stoi(argv[6]);
+    if (argc >= 8) opts.parallelMode = argv[7];
+    if (argc >= 9) opts.votingTopK = std::stoi(argv[8]);
+
+    MPILeafSplitSync::Mode mode;
+    if (!MPILeafSplitSync::parseMode(opts.parallelMode, mode)) {
+        if (mpiRank == 0) std::cerr << "Unknown parallel mode: " << opts.parallelMode
+                                    << " (expected data or voting)" << std::endl;
+        MPI_Finalize();
+        return 1;
+    }
+
+    try {
+        std::vector<double> X, y;
+        int rawRowLength = 0;
+        MPIDataIO mpiIO(MPI_COMM_WORLD);
+        if (!mpiIO.load(opts.dataPath, X, y, rawRowLength) || y.empty()) {
+            if (mpiRank == 0) std::cerr << "Error: Failed to load data" << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+
+        const int numFeatures = rawRowLength - 1;
+        DataParams dp;
+        if (!splitDataset(X, y, rawRowLength, dp)) {
+            std::cerr << "Failed to split dataset" << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        std::vector<double>().swap(X);
+        std::vector<double>().swap(y);
+
+        std::vector<double> trainX, trainY, testX, testY;
+        takeShard(dp.X_train, dp.y_train, numFeatures, mpiRank, mpiSize, trainX, trainY);
+        takeShard(dp.X_test, dp.y_test, numFeatures, mpiRank, mpiSize, testX, testY);
+        dp = DataParams();
+
+        LightGBMConfig config;
+        config.numIterations = opts.numIterations;
+        config.learningRate = opts.learningRate;
+        config.numLeaves = opts.numLeaves;
+        config.minDataInLeaf = opts.minDataInLeaf;
+        config.maxBin = opts.maxBin;
+        config.parallelMode = opts.parallelMode;
+        config.votingTopK = opts.votingTopK;
+        config.enableGOSS = false;
+        config.verbose = (mpiRank == 0);
+
+        MPILeafSplitSync sync(MPI_COMM_WORLD, mode, config.votingTopK, config.maxBin);
+        LightGBMTrainer trainer(config);
+        trainer.setLeafSplitSync(&sync);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto trainStart = std::chrono::high_resolution_clock::now();
+        trainer.train(trainX, numFeatures, trainY);
+        auto trainEnd = std::chrono::high_resolution_clock::now();
+
+        // Test metrics over every process's shard
+        double mse = 0.0, mae = 0.0;
+        if (!testY.empty()) trainer.evaluate(testX, numFeatures, testY, mse, mae);
+        double sums[3] = {mse * testY.size(), mae * testY.size(), static_cast<double>(testY.size())};
+        MPI_Allreduce(MPI_IN_PLACE, sums, 3, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+        const auto& perTree = sync.getBytesPerTree();
+        const std::uint64_t treeBytes = std::accumulate(perTree.begin(), perTree.end(), std::uint64_t(0));
+        const std::uint64_t maxTreeBytes = perTree.empty() ? 0 : *std::max_element(perTree.begin(), perTree.end());
+
+        if (mpiRank == 0) {
+            std::cout << "Training time: "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(trainEnd - trainStart).count()
+                      << "ms (" << mpiSize << " processes, " << opts.parallelMode << " parallel)" << std::endl;
+            std::cout << "Test MSE: " << (sums[2] > 0 ? sums[0] / sums[2] : 0.0) << std::endl;
+            std::cout << "Test MAE: " << (sums[2] > 0 ? sums[1] / sums[2] : 0.0) << std::endl;
+            std::cout << "Bytes per tree (per process): avg "
+                      << (perTree.empty() ? 0 : treeBytes / perTree.size())
+                      << " | max " << maxTreeBytes
+                      << " | total " << sync.getTotalBytes() << std::endl;
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Process " << mpiRank << " error: " << e.what() << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    MPI_Finalize();
+    return 0;
+}
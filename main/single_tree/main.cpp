@@ -2,6 +2,11 @@
 
 #include "app/SingleTreeApp.hpp"
 #include "app/BaggingApp.hpp"
+#include "ensemble/FlatForest.hpp"
+#include "functions/io/DataIO.hpp"
+#include "pipeline/DataSplit.hpp"
+#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <cstdint>
@@ -10,10 +15,18 @@ void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " [mode] [options...]\n\n";
     std::cout << "Modes:\n";
     std::cout << "  single  - Single decision tree (default)\n";
-    std::cout << "  bagging - Bootstrap aggregating\n\n";
+    std::cout << "  bagging - Bootstrap aggregating\n";
+    std::cout << "  score   - Score the test split with a saved forest (MPIBaggingMain output)\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << programName << " single data.csv 10 2 mse exhaustive none\n";
+    std::cout << "  " << programName << " single data.csv 800 2 mse exhaustive cost_complexity_cv 5\n";
     std::cout << "  " << programName << " bagging data.csv 50 1.0 10 2 mse random none\n";
+    std::cout << "  " << programName << " bagging data.csv 50 1.0 10 2 mse forest:64 none\n";
+    std::cout << "  " << programName << " bagging data.csv 500 1.0 10 2 mse random none 0.01 42 0.01 10\n";
+    std::cout << "           (stop once two 10-tree waves each improve OOB MSE by < 1%)\n";
+    std::cout << "  " << programName << " bagging data.csv 300 1.0 800 2 mse exhaustive none 0.01 42 0 10 0 \"\" 0.01 30 4 2\n";
+    std::cout << "           (distill the forest into a 30-tree depth-4 GBRT with 2x leaf-box augmentation)\n";
+    std::cout << "  " << programName << " score forest.bin data.csv\n";
 }
 
 int main(int argc, char** argv) {
@@ -73,9 +86,55 @@ int main(int argc, char** argv) {
         if (argc >= 10) opts.prunerType = argv[9];
         if (argc >= 11) opts.prunerParam = std::stod(argv[10]);
         if (argc >= 12) opts.seed = static_cast<uint32_t>(std::stoi(argv[11]));
+        if (argc >= 13) opts.oobStopTol = std::stod(argv[12]);
+        if (argc >= 14) opts.oobWindow = std::stoi(argv[13]);
+        if (argc >= 15) opts.anytimeTol = std::stod(argv[14]);
+        if (argc >= 16) opts.pruneMethod = argv[15];
+        if (argc >= 17) opts.pruneTol = std::stod(argv[16]);
+        if (argc >= 18) opts.distillTrees = std::stoi(argv[17]);
+        if (argc >= 19) opts.distillDepth = std::stoi(argv[18]);
+        if (argc >= 20) opts.distillAugment = std::stoi(argv[19]);
 
         runBaggingApp(opts);
     }
+    else if (mode == "score") {
+        // Stand-alone scoring of a merged forest; no MPI needed
+        if (argc < 4) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        FlatForest forest;
+        if (!forest.load(argv[2])) return 1;
+        
+        int rowLength = 0;
+        DataIO io;
+        auto [X, y] = io.readCSV(argv[3], rowLength);
+        DataParams dp;
+        if (y.empty() || !splitDataset(X, y, rowLength, dp)) {
+            std::cerr << "Failed to load or split dataset" << std::endl;
+            return 1;
+        }
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<double> pred;
+        forest.predictBatch(dp.X_test, dp.rowLength, pred);
+        auto end = std::chrono::high_resolution_clock::now();
+        
+        double mse = 0.0, mae = 0.0;
+        for (size_t i = 0; i < pred.size(); ++i) {
+            const double diff = dp.y_test[i] - pred[i];
+            mse += diff * diff;
+            mae += std::abs(diff);
+        }
+        if (!pred.empty()) {
+            mse /= pred.size();
+            mae /= pred.size();
+        }
+        std::cout << "Forest: " << forest.numTrees() << " trees, " << forest.numNodes() << " nodes" << std::endl;
+        std::cout << "Test MSE: " << mse << " | Test MAE: " << mae << " | Predict Time: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                  << "ms" << std::endl;
+    }
     else {
         std::cerr << "Unknown mode: " << mode << std::endl;
         printUsage(argv[0]);
@@ -14,7 +14,11 @@ void printUsage(const char* programName) {
     std::cout << "  --eta FLOAT           Learning rate (default: 0.3)\n";
     std::cout << "  --max-depth INT       Maximum tree depth (default: 6)\n";
     std::cout << "  --lambda FLOAT        L2 regularization (default: 1.0)\n";
-    std::cout << "  --gamma FLOAT         Minimum loss reduction (default: 0.0)\n\n";
+    std::cout << "  --gamma FLOAT         Minimum loss reduction (default: 0.0)\n";
+    std::cout << "  --seed INT            Seed of the subsample streams (default: 42)\n\n";
+    std::cout << "Ensemble Pruning:\n";
+    std::cout << "  --prune-ensemble STR  greedy | omp: keep a subset of trees chosen on a held-out split\n";
+    std::cout << "  --prune-tol FLOAT     Allowed relative validation MSE increase (default: 0.01)\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << programName << " --data data.csv\n";
     std::cout << "  " << programName << " --data data.csv --num-rounds 200 --eta 0.1\n";
@@ -34,8 +38,11 @@ bool parseArguments(int argc, char** argv, XGBoostAppOptions& opts) {
         else if (arg == "--lambda" && i + 1 < argc) opts.lambda = std::stod(argv[++i]);
         else if (arg == "--gamma" && i + 1 < argc) opts.gamma = std::stod(argv[++i]);
         else if (arg == "--subsample" && i + 1 < argc) opts.subsample = std::stod(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) opts.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
         else if (arg == "--colsample-bytree" && i + 1 < argc) opts.colsampleByTree = std::stod(argv[++i]);
         else if (arg == "--early-stopping" && i + 1 < argc) opts.earlyStoppingRounds = std::stoi(argv[++i]);
+        else if (arg == "--prune-ensemble" && i + 1 < argc) opts.pruneMethod = argv[++i];
+        else if (arg == "--prune-tol" && i + 1 < argc) opts.pruneTol = std::stod(argv[++i]);
         else if (arg == "--verbose") opts.verbose = true;
         else if (arg == "--quiet") opts.verbose = false;
         else {
@@ -0,0 +1,105 @@
+#!/bin/bash
+set -euo pipefail
+
+# =============================================================================
+# script/boosting/mpi/test_mpi_boosting_strong_scaling.sh
+#
+# MPI Boosting Strong-scaling test: fixed data size, rows sharded across an
+# increasing number of MPI processes (1 OpenMP thread each); reports time,
+# histogram/allreduce split and MSE
+# =============================================================================
+
+# 1) Project root path and executable location
+PROJECT_ROOT="$( cd "$(dirname "${BASH_SOURCE[0]}")/../../.." && pwd )"
+source "$PROJECT_ROOT/script/env_config.sh" # Source physical core count
+
+EXECUTABLE="$PROJECT_ROOT/build/MPIBoostingMain"
+if [[ ! -x "$EXECUTABLE" ]]; then
+  echo "Error: Executable not found at $EXECUTABLE"
+  exit 1
+fi
+if ! command -v mpirun &> /dev/null; then
+  echo "Error: mpirun not found in PATH"
+  exit 1
+fi
+
+# 2) Fixed parameters
+DATA="$PROJECT_ROOT/data/data_clean/cleaned_data.csv"
+if [[ ! -f "$DATA" ]]; then
+  echo "Error: Data file not found at $DATA"
+  exit 1
+fi
+
+NUM_ROUNDS=100
+ETA=0.3
+MAX_DEPTH=6
+LAMBDA=1.0
+GAMMA=0.0
+MIN_CHILD_WEIGHT=1
+MAX_BINS=256
+MAX_PROCS=$OMP_NUM_THREADS
+
+# 3) Generate process list: 1, 2, 4, ..., MAX_PROCS; ensure MAX_PROCS is included
+procs=(1)
+while (( procs[-1]*2 <= MAX_PROCS )); do
+  procs+=( $(( procs[-1]*2 )) )
+done
+(( procs[-1] != MAX_PROCS )) && procs+=( $MAX_PROCS )
+
+# 4) Print table header
+echo "==============================================="
+echo "  MPI Boosting Strong Scaling Performance Test "
+echo "==============================================="
+echo "Fixed Parameters:"
+echo "  Rounds: $NUM_ROUNDS | Eta: $ETA | Max Depth: $MAX_DEPTH"
+echo "  Lambda: $LAMBDA | Gamma: $GAMMA | Min Child Weight: $MIN_CHILD_WEIGHT | Bins: $MAX_BINS"
+echo "  Data: $(basename "$DATA")"
+echo ""
+echo "Procs | Elapsed(ms) | Train(ms) | Hist(ms) | Allreduce(ms) | TestMSE    | Speedup | Efficiency"
+echo "------|-------------|-----------|----------|---------------|------------|---------|----------"
+
+export OMP_NUM_THREADS=1
+baseline_time=0
+for p in "${procs[@]}"; do
+  start_ts=$(date +%s%3N)
+  output=$(mpirun -np "$p" "$EXECUTABLE" "$DATA" \
+      $NUM_ROUNDS $ETA $MAX_DEPTH $LAMBDA $GAMMA $MIN_CHILD_WEIGHT $MAX_BINS)
+  end_ts=$(date +%s%3N)
+  elapsed=$(( end_ts - start_ts ))
+
+  train_ms=$(echo "$output" | sed -n 's/.*Training time: *\([0-9]*\)ms.*/\1/p' | tail -1)
+  hist_ms=$(echo "$output" | sed -n 's/.*Histogram time (max): *\([0-9]*\)ms.*/\1/p' | tail -1)
+  comm_ms=$(echo "$output" | sed -n 's/.*Allreduce time (max): *\([0-9]*\)ms.*/\1/p' | tail -1)
+  test_mse=$(echo "$output" | sed -n 's/.*Test MSE: *\([0-9.e+-]*\).*/\1/p' | tail -1)
+
+  [[ -z "$train_ms" ]] && train_ms="ERROR"
+  [[ -z "$hist_ms" ]] && hist_ms="ERROR"
+  [[ -z "$comm_ms" ]] && comm_ms="ERROR"
+  [[ -z "$test_mse" ]] && test_mse="ERROR"
+
+  # Speedup and efficiency on the training time
+  if (( p == 1 )) && [[ "$train_ms" != "ERROR" ]]; then
+    baseline_time=$train_ms
+  fi
+  if [[ "$train_ms" != "ERROR" ]] && (( baseline_time > 0 && train_ms > 0 )); then
+    speedup=$(echo "scale=2; $baseline_time / $train_ms" | bc -l)
+    efficiency=$(echo "scale=2; $speedup / $p" | bc -l)
+  else
+    speedup="N/A"
+    efficiency="N/A"
+  fi
+
+  printf "%5d | %11d | %9s | %8s | %13s | %-10s | %7s | %s\n" \
+         "$p" "$elapsed" "$train_ms" "$hist_ms" "$comm_ms" "$test_mse" "$speedup" "$efficiency"
+done
+
+echo ""
+echo "==============================================="
+echo "Strong Scaling Analysis:"
+echo "- Ideal: Hist time halves as processes double; Allreduce time is the"
+echo "  per-level histogram exchange and does not shrink with more processes."
+echo "- Speedup = (1-process train time / current train time)"
+echo "- Efficiency = Speedup / processes; TestMSE should stay stable."
+echo "==============================================="
+
+exit 0
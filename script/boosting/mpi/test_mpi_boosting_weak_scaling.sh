@@ -0,0 +1,119 @@
+#!/bin/bash
+set -euo pipefail
+
+# =============================================================================
+# script/boosting/mpi/test_mpi_boosting_weak_scaling.sh
+#
+# MPI Boosting Weak-scaling test: rows per process stay fixed while the
+# dataset grows with the number of MPI processes (1 OpenMP thread each)
+# =============================================================================
+
+# 1) Project root path and executable location
+PROJECT_ROOT="$( cd "$(dirname "${BASH_SOURCE[0]}")/../../.." && pwd )"
+source "$PROJECT_ROOT/script/env_config.sh" # Source physical core count
+
+EXECUTABLE="$PROJECT_ROOT/build/MPIBoostingMain"
+if [[ ! -x "$EXECUTABLE" ]]; then
+  echo "Error: Executable not found at $EXECUTABLE"
+  exit 1
+fi
+if ! command -v mpirun &> /dev/null; then
+  echo "Error: mpirun not found in PATH"
+  exit 1
+fi
+
+# 2) Fixed parameters
+DATA="$PROJECT_ROOT/data/data_clean/cleaned_data.csv"
+if [[ ! -f "$DATA" ]]; then
+  echo "Error: Data file not found at $DATA"
+  exit 1
+fi
+
+NUM_ROUNDS=100
+ETA=0.3
+MAX_DEPTH=6
+LAMBDA=1.0
+GAMMA=0.0
+MIN_CHILD_WEIGHT=1
+MAX_BINS=256
+MAX_PROCS=$OMP_NUM_THREADS
+
+# 3) Total rows and base rows per process
+total_rows=$(( $(wc -l < "$DATA") - 1 )) # Count lines excluding header
+if (( total_rows < MAX_PROCS )); then
+  echo "Warning: Data rows ($total_rows) are less than physical cores ($MAX_PROCS), exiting script."
+  exit 1
+fi
+BASE=$(( total_rows / MAX_PROCS )) # Base rows per process
+echo "Total rows (excluding header): $total_rows, Physical cores: $MAX_PROCS, Base rows BASE=$BASE"
+
+# 4) Generate process list: 1, 2, 4, ..., MAX_PROCS; ensure MAX_PROCS is included
+procs=(1)
+while (( procs[-1]*2 <= MAX_PROCS )); do
+  procs+=( $(( procs[-1]*2 )) )
+done
+(( procs[-1] != MAX_PROCS )) && procs+=( $MAX_PROCS )
+
+# 5) Print table header
+echo "==============================================="
+echo "   MPI Boosting Weak Scaling Performance Test  "
+echo "==============================================="
+echo "Fixed Parameters (per process):"
+echo "  Rounds: $NUM_ROUNDS | Eta: $ETA | Max Depth: $MAX_DEPTH | Bins: $MAX_BINS"
+echo "  Base rows per process: $BASE"
+echo ""
+echo "Procs | SubsetRows | Train(ms) | Hist(ms) | Allreduce(ms) | TestMSE    | Efficiency"
+echo "------|------------|-----------|----------|---------------|------------|----------"
+
+export OMP_NUM_THREADS=1
+baseline_time=0
+for p in "${procs[@]}"; do
+  # Calculate the subset size for this iteration
+  chunk_size=$(( p * BASE ))
+  if (( chunk_size > total_rows )); then
+    chunk_size=$total_rows # Do not exceed total available rows
+  fi
+  lines_to_take=$(( chunk_size + 1 )) # Include the header row for 'head' command
+
+  # Create a temporary subset file
+  tmpfile="$PROJECT_ROOT/data/data_clean/tmp_mpi_boosting_p${p}_$$.csv"
+  head -n "$lines_to_take" "$DATA" > "$tmpfile"
+
+  output=$(mpirun -np "$p" "$EXECUTABLE" "$tmpfile" \
+      $NUM_ROUNDS $ETA $MAX_DEPTH $LAMBDA $GAMMA $MIN_CHILD_WEIGHT $MAX_BINS)
+
+  rm -f "$tmpfile" # Clean up the temporary file
+
+  train_ms=$(echo "$output" | sed -n 's/.*Training time: *\([0-9]*\)ms.*/\1/p' | tail -1)
+  hist_ms=$(echo "$output" | sed -n 's/.*Histogram time (max): *\([0-9]*\)ms.*/\1/p' | tail -1)
+  comm_ms=$(echo "$output" | sed -n 's/.*Allreduce time (max): *\([0-9]*\)ms.*/\1/p' | tail -1)
+  test_mse=$(echo "$output" | sed -n 's/.*Test MSE: *\([0-9.e+-]*\).*/\1/p' | tail -1)
+
+  [[ -z "$train_ms" ]] && train_ms="ERROR"
+  [[ -z "$hist_ms" ]] && hist_ms="ERROR"
+  [[ -z "$comm_ms" ]] && comm_ms="ERROR"
+  [[ -z "$test_mse" ]] && test_mse="ERROR"
+
+  # Efficiency = 1-process time / current time
+  if (( p == 1 )) && [[ "$train_ms" != "ERROR" ]]; then
+    baseline_time=$train_ms
+  fi
+  if [[ "$train_ms" != "ERROR" ]] && (( baseline_time > 0 && train_ms > 0 )); then
+    efficiency=$(echo "scale=2; $baseline_time / $train_ms" | bc -l)
+  else
+    efficiency="N/A"
+  fi
+
+  printf "%5d | %10d | %9s | %8s | %13s | %-10s | %s\n" \
+         "$p" "$chunk_size" "$train_ms" "$hist_ms" "$comm_ms" "$test_mse" "$efficiency"
+done
+
+echo ""
+echo "==============================================="
+echo "Weak Scaling Analysis:"
+echo "- Ideal: Train time remains constant as processes and data increase."
+echo "- Hist time should stay flat; Allreduce time grows with log(processes)."
+echo "- Efficiency close to 1.0 indicates good scaling."
+echo "==============================================="
+
+exit 0
@@ -2,6 +2,7 @@
 #include "ensemble/BaggingTrainer.hpp"
 #include "functions/io/DataIO.hpp"
 #include "pipeline/DataSplit.hpp"
+#include "boosting/distill/ForestDistiller.hpp"
 
 #include <iostream>
 #include <memory>
@@ -24,6 +25,12 @@ void runBaggingApp(const BaggingOptions& opts) {
         return;
     }
 
+    // Hold out validation rows for ensemble pruning
+    std::vector<double> X_val, y_val;
+    if (!opts.pruneMethod.empty()) {
+        holdOutValidation(dp, 0.2, X_val, y_val);
+    }
+    
     // 3. Create Bagging trainer
     BaggingTrainer trainer(
         opts.numTrees,
@@ -36,6 +43,7 @@ void runBaggingApp(const BaggingOptions& opts) {
         opts.prunerParam,
         opts.seed
     );
+    trainer.setOOBStopping(opts.oobStopTol, opts.oobWindow);
 
     // 4. Train (measure time)
     auto trainStart = std::chrono::high_resolution_clock::now();
@@ -46,11 +54,76 @@ void runBaggingApp(const BaggingOptions& opts) {
     double mse, mae;
     trainer.evaluate(dp.X_test, dp.rowLength, dp.y_test, mse, mae);
     
+    // Forest pruning (greedy forward selection of an unweighted sub-forest)
+    EnsembleSelection pruned;
+    double prunedTestMSE = mse;
+    const int fullTrees = trainer.getTrainedTrees();
+    if (!y_val.empty()) {
+        EnsemblePruner pruner(EnsemblePruner::Method::Greedy, opts.pruneTol);
+        pruned = trainer.pruneEnsemble(pruner, X_val, dp.rowLength, y_val);
+        double prunedMAE;
+        trainer.evaluate(dp.X_test, dp.rowLength, dp.y_test, prunedTestMSE, prunedMAE);
+    }
+    
+    // Anytime prediction on the test set: trees stop per row once the
+    // running mean's standard error is within the tolerance
+    double anytimeMSE = 0.0, anytimeTrees = 0.0;
+    long long anytimeMs = 0;
+    if (opts.anytimeTol > 0.0) {
+        AnytimeOptions anytime;
+        anytime.tolerance = opts.anytimeTol;
+        auto anytimeStart = std::chrono::high_resolution_clock::now();
+        const auto preds = trainer.predictAnytime(dp.X_test, dp.rowLength, anytime);
+        anytimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - anytimeStart).count();
+        for (size_t i = 0; i < preds.size(); ++i) {
+            const double diff = dp.y_test[i] - preds[i].prediction;
+            anytimeMSE += diff * diff;
+            anytimeTrees += preds[i].treesUsed;
+        }
+        if (!preds.empty()) {
+            anytimeMSE /= preds.size();
+            anytimeTrees /= preds.size();
+        }
+    }
+    
+    // Distillation into a small GBRT student trained on the forest's outputs
+    DistillReport distilled;
+    long long distillMs = 0;
+    if (opts.distillTrees > 0) {
+        DistillConfig dc;
+        dc.numTrees = opts.distillTrees;
+        dc.maxDepth = opts.distillDepth;
+        dc.augmentFactor = opts.distillAugment;
+        dc.seed = opts.seed;
+        ForestDistiller distiller(dc);
+        
+        auto teacher = [&trainer](const std::vector<double>& X, int rowLength,
+                                  std::vector<double>& pred) {
+            const int n = static_cast<int>(X.size() / rowLength);
+            pred.resize(n);
+            #pragma omp parallel for schedule(static, 256)
+            for (int i = 0; i < n; ++i) {
+                pred[i] = trainer.predict(&X[static_cast<size_t>(i) * rowLength], rowLength);
+            }
+        };
+        
+        auto distillStart = std::chrono::high_resolution_clock::now();
+        std::vector<double> augmented;
+        distiller.sampleLeafBoxes(trainer.getTreeRoots(), trainer.getTreeIds(), trainer.getTrainedTrees(),
+                                  dp.X_train, dp.rowLength, augmented);
+        auto student = distiller.train(teacher, dp.X_train, dp.rowLength, augmented);
+        distillMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - distillStart).count();
+        distilled = ForestDistiller::evaluate(teacher, *student, dp.X_test, dp.rowLength, dp.y_test);
+    }
+    
     // 6. Compute OOB error
-    double oobError = trainer.getOOBError(dp.X_train, dp.rowLength, dp.y_train);
+    double oobError = trainer.getOOBError(dp.X_train, dp.rowLength, dp.y_train, true);
     
-    // 7. Compute feature importance
+    // 7. Compute feature importance (split counts, and OOB permutation)
     auto featureImportance = trainer.getFeatureImportance(dp.rowLength);
+    auto permImportance = trainer.getPermutationImportance(dp.X_train, dp.rowLength, dp.y_train);
     
     auto totalEnd = std::chrono::high_resolution_clock::now();
     
@@ -60,7 +133,9 @@ void runBaggingApp(const BaggingOptions& opts) {
 
     // 9. Print results
     std::cout << "\n=== Bagging Results ===" << std::endl;
-    std::cout << "Trees: " << opts.numTrees 
+    std::cout << "Trees: " << trainer.getTrainedTrees();
+    if (trainer.getTrainedTrees() < opts.numTrees) std::cout << "/" << opts.numTrees;
+    std::cout
               << " | Sample Ratio: " << std::fixed << std::setprecision(2) << opts.sampleRatio
               << " | Criterion: " << opts.criterion 
               << " | Split: " << opts.splitMethod << std::endl;
@@ -70,22 +145,54 @@ void runBaggingApp(const BaggingOptions& opts) {
     
     std::cout << "OOB MSE: " << std::fixed << std::setprecision(6) << oobError << std::endl;
     
-    std::cout << "Train Time: " << trainTime.count() << "ms"
-              << " | Total Time: " << totalTime.count() << "ms" << std::endl;
+    if (!y_val.empty()) {
+        std::cout << "Ensemble pruning (greedy): " << pruned.trees.size() << "/" << fullTrees
+                  << " trees | Val MSE " << pruned.fullMSE << " -> " << pruned.prunedMSE
+                  << " | Test MSE " << mse << " -> " << prunedTestMSE << std::endl;
+    }
     
-    // 10. Print top 10 most important features
-    std::cout << "\nTop 10 Feature Importances:" << std::endl;
-    std::vector<std::pair<double, int>> importanceWithIndex;
-    for (int i = 0; i < static_cast<int>(featureImportance.size()); ++i) {
-        importanceWithIndex.emplace_back(featureImportance[i], i);
+    if (opts.anytimeTol > 0.0) {
+        std::cout << "Anytime (std. error <= " << opts.anytimeTol << "): Test MSE: " << anytimeMSE
+                  << " | Avg trees: " << std::setprecision(1) << anytimeTrees
+                  << "/" << trainer.getTrainedTrees()
+                  << " | Time: " << anytimeMs << "ms" << std::endl;
     }
     
-    std::sort(importanceWithIndex.begin(), importanceWithIndex.end(), 
-              std::greater<std::pair<double, int>>());
+    if (opts.distillTrees > 0) {
+        std::cout << "Distilled GBRT (" << opts.distillTrees << " trees, depth " << opts.distillDepth
+                  << ", " << opts.distillAugment << "x leaf-box augmentation): Test MSE: "
+                  << std::setprecision(6) << distilled.studentMSE
+                  << " | Fidelity MSE: " << distilled.fidelityMSE
+                  << " (R2 " << std::setprecision(4) << distilled.fidelityR2 << ")"
+                  << " | Predict: " << distilled.teacherPredictUs / 1000 << "ms -> "
+                  << distilled.studentPredictUs / 1000 << "ms"
+                  << " | Distill Time: " << distillMs << "ms" << std::endl;
+    }
     
-    for (int i = 0; i < std::min(10, static_cast<int>(importanceWithIndex.size())); ++i) {
-        std::cout << "Feature " << importanceWithIndex[i].second 
-                  << ": " << std::fixed << std::setprecision(4) 
-                  << importanceWithIndex[i].first << std::endl;
+    if (opts.oobStopTol > 0.0) {
+        const auto& curve = trainer.getOOBCurve();
+        std::cout << "OOB curve (every " << trainer.getOOBWindow() << " trees):";
+        for (double v : curve) std::cout << " " << std::setprecision(6) << v;
+        std::cout << std::endl;
     }
+    
+    std::cout << "Train Time: " << trainTime.count() << "ms"
+              << " | Total Time: " << totalTime.count() << "ms" << std::endl;
+    
+    // 10. Print top 10 most important features
+    auto printTop = [](const char* title, const std::vector<double>& values, int precision) {
+        std::cout << "\n" << title << ":" << std::endl;
+        std::vector<std::pair<double, int>> withIndex;
+        for (int i = 0; i < static_cast<int>(values.size()); ++i) {
+            withIndex.emplace_back(values[i], i);
+        }
+        std::sort(withIndex.begin(), withIndex.end(), std::greater<std::pair<double, int>>());
+        for (int i = 0; i < std::min(10, static_cast<int>(withIndex.size())); ++i) {
+            std::cout << "Feature " << withIndex[i].second 
+                      << ": " << std::fixed << std::setprecision(precision) 
+                      << withIndex[i].first << std::endl;
+        }
+    };
+    printTop("Top 10 Feature Importances", featureImportance, 4);
+    printTop("Top 10 Permutation Importances (OOB MSE increase)", permImportance, 8);
 }
@@ -12,6 +12,7 @@
 
 #include "finder/ExhaustiveSplitFinder.hpp"
 #include "finder/RandomSplitFinder.hpp"
+#include "finder/ExtraTreesSplitFinder.hpp"
 #include "finder/QuartileSplitFinder.hpp"
 #include "finder/HistogramEWFinder.hpp"
 #include "finder/HistogramEQFinder.hpp"
@@ -22,6 +23,7 @@
 #include "pruner/MinGainPrePruner.hpp"
 #include "pruner/CostComplexityPruner.hpp"
 #include "pruner/ReducedErrorPruner.hpp"
+#include "pruner/CostComplexityCV.hpp"
 
 #include <iostream>
 #include <memory>
@@ -87,6 +89,14 @@ std::unique_ptr<ISplitFinder> createSplitFinder(const std::string& method) {
         }
         return std::make_unique<RandomSplitFinder>(k);
     }
+    else if (method == "extra" || method.find("extra:") == 0) {
+        int k = 1;
+        auto pos = method.find(':');
+        if (pos != std::string::npos) {
+            k = std::stoi(method.substr(pos + 1));
+        }
+        return std::make_unique<ExtraTreesSplitFinder>(k);
+    }
     else if (method == "quartile") {
         return std::make_unique<QuartileSplitFinder>();
     }
@@ -122,6 +132,26 @@ std::unique_ptr<ISplitFinder> createSplitFinder(const std::string& method) {
     }
 }
 
+std::unique_ptr<ISplitCriterion> createCriterion(const std::string& crit) {
+    if (crit == "mae")
+        return std::make_unique<MAECriterion>();
+    else if (crit == "huber")
+        return std::make_unique<HuberCriterion>();
+    else if (crit.rfind("quantile", 0) == 0) {
+        double tau = 0.5;
+        auto pos = crit.find(':');
+        if (pos != std::string::npos)
+            tau = std::stod(crit.substr(pos + 1));
+        return std::make_unique<QuantileCriterion>(tau);
+    }
+    else if (crit == "logcosh")
+        return std::make_unique<LogCoshCriterion>();
+    else if (crit == "poisson")
+        return std::make_unique<PoissonCriterion>();
+    else
+        return std::make_unique<MSECriterion>();
+}
+
 std::unique_ptr<IPruner> createPruner(const std::string& type, 
                                      double param,
                                      const std::vector<double>& X_val,
@@ -162,30 +192,29 @@ void runSingleTreeApp(const ProgramOptions& opts) {
     auto finder = createSplitFinder(opts.splitMethod);
     
     // 4. Create split criterion
-    std::unique_ptr<ISplitCriterion> criterion;
-    const std::string crit = opts.criterion;
-
-    if (crit == "mae")
-        criterion = std::make_unique<MAECriterion>();
-    else if (crit == "huber")
-        criterion = std::make_unique<HuberCriterion>();
-    else if (crit.rfind("quantile", 0) == 0) {
-        double tau = 0.5;
-        auto pos = crit.find(':');
-        if (pos != std::string::npos)
-            tau = std::stod(crit.substr(pos + 1));
-        criterion = std::make_unique<QuantileCriterion>(tau);
-    }
-    else if (crit == "logcosh")
-        criterion = std::make_unique<LogCoshCriterion>();
-    else if (crit == "poisson")
-        criterion = std::make_unique<PoissonCriterion>();
-    else
-        criterion = std::make_unique<MSECriterion>();
+    auto criterion = createCriterion(opts.criterion);
 
     // 5. Create pruner
-    auto pruner = createPruner(opts.prunerType, opts.prunerParam, 
+    std::unique_ptr<IPruner> pruner;
+    const CostComplexityCV* ccpCV = nullptr;
+    if (opts.prunerType == "cost_complexity_cv") {
+        // prunerParam is the number of folds here; fold trees are grown unpruned
+        const int folds = opts.prunerParam >= 2 ? static_cast<int>(opts.prunerParam) : 5;
+        auto factory = [&opts]() -> std::unique_ptr<ITreeTrainer> {
+            return std::make_unique<SingleTreeTrainer>(createSplitFinder(opts.splitMethod),
+                                                       createCriterion(opts.criterion),
+                                                       std::make_unique<NoPruner>(),
+                                                       opts.maxDepth,
+                                                       opts.minSamplesLeaf);
+        };
+        auto cv = std::make_unique<CostComplexityCV>(dp.X_train, dp.rowLength, dp.y_train,
+                                                     factory, folds);
+        ccpCV = cv.get();
+        pruner = std::move(cv);
+    } else {
+        pruner = createPruner(opts.prunerType, opts.prunerParam, 
                               dp.X_val, dp.rowLength, dp.y_val);
+    }
 
     SingleTreeTrainer trainer(std::move(finder),
                               std::move(criterion),
@@ -210,7 +239,10 @@ void runSingleTreeApp(const ProgramOptions& opts) {
 
     // 9. Result
     std::cout << " | Pruner: " << opts.prunerType;
-    if (opts.prunerType != "none") {
+    if (ccpCV) {
+        const auto& cv = ccpCV->lastResult();
+        std::cout << "(alpha=" << cv.alpha << ", " << cv.candidates.size() << " candidates)";
+    } else if (opts.prunerType != "none") {
         std::cout << "(" << opts.prunerParam << ")";
     }
     std::cout << std::endl;
@@ -10,6 +10,8 @@
 #include <iostream>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
+#include <functional>
 
 void runRegressionBoostingApp(const RegressionBoostingOptions& opts) {
     auto totalStart = std::chrono::high_resolution_clock::now();
@@ -28,6 +30,12 @@ void runRegressionBoostingApp(const RegressionBoostingOptions& opts) {
     DataParams dp;
     splitDataset(X, y, rowLength, dp);
     
+    // Hold out validation rows for ensemble pruning
+    std::vector<double> X_val, y_val;
+    if (!opts.pruneMethod.empty() && opts.valSplit > 0) {
+        holdOutValidation(dp, opts.valSplit, X_val, y_val);
+    }
+    
     // Create trainer
     auto trainer = createRegressionBoostingTrainer(opts);
     
@@ -61,6 +69,30 @@ void runRegressionBoostingApp(const RegressionBoostingOptions& opts) {
     std::cout << "Test Loss: " << testLoss 
               << " | Test MSE: " << testMSE << std::endl;
     std::cout << "Train Time: " << trainTime.count() << "ms" << std::endl;
+    
+    if (!y_val.empty()) {
+        const size_t fullTrees = trainer->getModel()->getTreeCount();
+        EnsemblePruner pruner(EnsemblePruner::parseMethod(opts.pruneMethod), opts.pruneTol);
+        const EnsembleSelection sel = trainer->pruneEnsemble(pruner, X_val, dp.rowLength, y_val);
+        double prunedLoss, prunedMSE, prunedMAE;
+        trainer->evaluate(dp.X_test, dp.rowLength, dp.y_test, prunedLoss, prunedMSE, prunedMAE);
+        std::cout << "Ensemble pruning (" << opts.pruneMethod << "): " << sel.trees.size()
+                  << "/" << fullTrees << " trees | Val MSE " << sel.fullMSE << " -> " << sel.prunedMSE
+                  << " | Test MSE " << testMSE << " -> " << prunedMSE << std::endl;
+    }
+    
+    // Permutation importance on the test split
+    auto permImportance = trainer->getPermutationImportance(dp.X_test, dp.rowLength, dp.y_test);
+    std::vector<std::pair<double, int>> ranked;
+    for (int i = 0; i < static_cast<int>(permImportance.size()); ++i) {
+        ranked.emplace_back(permImportance[i], i);
+    }
+    std::sort(ranked.begin(), ranked.end(), std::greater<std::pair<double, int>>());
+    std::cout << "\nTop 10 Permutation Importances (test MSE increase):" << std::endl;
+    for (int i = 0; i < std::min(10, static_cast<int>(ranked.size())); ++i) {
+        std::cout << "Feature " << ranked[i].second << ": "
+                  << std::setprecision(8) << ranked[i].first << std::endl;
+    }
 }
 
 std::unique_ptr<GBRTTrainer> createRegressionBoostingTrainer(const RegressionBoostingOptions& opts) {
@@ -126,6 +158,8 @@ RegressionBoostingOptions parseRegressionCommandLine(int argc, char** argv) {
         std::string skipDropStr = argv[13];
         opts.dartSkipDropForPrediction = (skipDropStr == "true" || skipDropStr == "1");
     }
+    if (argc >= 15) opts.pruneMethod = argv[14];
+    if (argc >= 16) opts.pruneTol = std::stod(argv[15]);
     
     return opts;
 }
@@ -3,16 +3,14 @@
 // =============================================================================
 #include "boosting/dart/UniformDartStrategy.hpp"
 #include <algorithm>
-#include <random>
 #include <iostream>
 #include <cmath>
-#include <execution>  // C++17 parallel algorithms
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 std::vector<int> UniformDartStrategy::selectDroppedTrees(
-    int totalTrees, double dropRate, std::mt19937& gen) const {
+    int totalTrees, double dropRate, CounterRng& rng) const {
     
     if (totalTrees <= 0 || dropRate <= 0.0 || dropRate >= 1.0) {
         return {};
@@ -24,11 +22,10 @@ std::vector<int> UniformDartStrategy::selectDroppedTrees(
     
     // **Optimization 1: Batch random number generation**
     std::vector<double> randomValues(totalTrees);
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
     
     // Batch generate random numbers (more efficient)
     for (int i = 0; i < totalTrees; ++i) {
-        randomValues[i] = dist(gen);
+        randomValues[i] = rng.uniform();
     }
     
     // **Optimization 2: Vectorized selection process**
@@ -40,8 +37,7 @@ std::vector<int> UniformDartStrategy::selectDroppedTrees(
     
     // **Optimization 3: Ensure at least one tree is dropped (if expected >= 1)**
     if (droppedTrees.empty() && expectedDrops >= 1 && totalTrees > 0) {
-        std::uniform_int_distribution<int> treeDist(0, totalTrees - 1);
-        droppedTrees.push_back(treeDist(gen));
+        droppedTrees.push_back(static_cast<int>(rng.below(static_cast<uint32_t>(totalTrees))));
     }
     
     return droppedTrees;
@@ -300,7 +296,7 @@ void UniformDartStrategy::computeDropoutPredictionsBatch(
 std::vector<int> UniformDartStrategy::selectDroppedTreesAdaptive(
     const std::vector<RegressionBoostingModel::RegressionTree>& trees,
     double dropRate,
-    std::mt19937& gen) const {
+    CounterRng& rng) const {
     
     const int totalTrees = static_cast<int>(trees.size());
     if (totalTrees <= 0 || dropRate <= 0.0) {
@@ -313,8 +309,14 @@ std::vector<int> UniformDartStrategy::selectDroppedTreesAdaptive(
         treeWeights[i] = std::abs(trees[i].weight * trees[i].learningRate);
     }
     
-    // **Create weighted distribution**
-    std::discrete_distribution<int> dist(treeWeights.begin(), treeWeights.end());
+    // **Create weighted distribution** (cumulative weights, inverted by binary search)
+    std::vector<double> cumWeights(totalTrees);
+    double totalWeight = 0.0;
+    for (int i = 0; i < totalTrees; ++i) {
+        totalWeight += treeWeights[i];
+        cumWeights[i] = totalWeight;
+    }
+    if (totalWeight <= 0.0) return {};
     
     const int numToDrop = static_cast<int>(std::ceil(totalTrees * dropRate));
     std::vector<int> droppedTrees;
@@ -322,7 +324,10 @@ std::vector<int> UniformDartStrategy::selectDroppedTreesAdaptive(
     
     // **Randomly select trees to drop based on importance**
     for (int i = 0; i < numToDrop && droppedTrees.size() < static_cast<size_t>(totalTrees); ++i) {
-        int candidate = dist(gen);
+        const double u = rng.uniform() * totalWeight;
+        int candidate = static_cast<int>(
+            std::upper_bound(cumWeights.begin(), cumWeights.end(), u) - cumWeights.begin());
+        candidate = std::min(candidate, totalTrees - 1);
         if (!alreadyDropped[candidate]) {
             droppedTrees.push_back(candidate);
             alreadyDropped[candidate] = true;
@@ -0,0 +1,157 @@
+// =============================================================================
+// src/boosting/distill/ForestDistiller.cpp - Leaf-box augmentation + student
+// =============================================================================
+#include "boosting/distill/ForestDistiller.hpp"
+#include "boosting/loss/SquaredLoss.hpp"
+#include "boosting/strategy/GradientRegressionStrategy.hpp"
+#include "functions/random/CounterRng.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+ForestDistiller::ForestDistiller(const DistillConfig& config)
+    : config_(config) {}
+
+void ForestDistiller::sampleLeafBoxes(const std::vector<const Node*>& trees,
+                                      const std::vector<int>& treeIds,
+                                      int totalTrees,
+                                      const std::vector<double>& X,
+                                      int rowLength,
+                                      std::vector<double>& out) const {
+    const int N = rowLength > 0 ? static_cast<int>(X.size() / rowLength) : 0;
+    const int count = N * std::max(0, config_.augmentFactor);
+    out.assign(static_cast<size_t>(count) * rowLength, 0.0);
+    if (N == 0 || count <= 0 || totalTrees <= 0) return;
+
+    // Unbounded box sides are clipped to the training range
+    std::vector<double> featMin(rowLength, std::numeric_limits<double>::max());
+    std::vector<double> featMax(rowLength, std::numeric_limits<double>::lowest());
+    for (int r = 0; r < N; ++r) {
+        const double* x = &X[static_cast<size_t>(r) * rowLength];
+        for (int f = 0; f < rowLength; ++f) {
+            featMin[f] = std::min(featMin[f], x[f]);
+            featMax[f] = std::max(featMax[f], x[f]);
+        }
+    }
+
+    // Global tree id -> index into `trees`, -1 where another rank owns it
+    std::vector<int> localIndex(totalTrees, -1);
+    for (size_t k = 0; k < trees.size() && k < treeIds.size(); ++k) {
+        if (treeIds[k] >= 0 && treeIds[k] < totalTrees) localIndex[treeIds[k]] = static_cast<int>(k);
+    }
+
+    #pragma omp parallel
+    {
+        std::vector<double> lo(rowLength), hi(rowLength);
+        std::vector<int> stamp(rowLength, -1);
+        std::vector<int> constrained;
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < count; ++i) {
+            CounterRng rng(config_.seed, RngPurpose::Augment, static_cast<uint32_t>(i));
+            const int r = static_cast<int>(rng.below(static_cast<uint32_t>(N)));
+            const int t = localIndex[rng.below(static_cast<uint32_t>(totalTrees))];
+            if (t < 0) continue;   // Another rank owns the tree
+
+            const double* x = &X[static_cast<size_t>(r) * rowLength];
+            double* dst = &out[static_cast<size_t>(i) * rowLength];
+            std::copy(x, x + rowLength, dst);
+
+            // Narrow the box of every feature on x's root-to-leaf path
+            constrained.clear();
+            const Node* node = trees[t];
+            while (node && !node->isLeaf) {
+                const int f = node->getFeatureIndex();
+                const double th = node->getThreshold();
+                if (stamp[f] != i) {
+                    stamp[f] = i;
+                    lo[f] = featMin[f];
+                    hi[f] = featMax[f];
+                    constrained.push_back(f);
+                }
+                if (x[f] <= th) {
+                    hi[f] = std::min(hi[f], th);
+                    node = node->getLeft();
+                } else {
+                    lo[f] = std::max(lo[f], th);
+                    node = node->getRight();
+                }
+            }
+            for (const int f : constrained) {
+                if (hi[f] > lo[f]) dst[f] = lo[f] + (hi[f] - lo[f]) * rng.uniform();
+            }
+        }
+    }
+}
+
+std::unique_ptr<GBRTTrainer> ForestDistiller::train(const Teacher& teacher,
+                                                    const std::vector<double>& X,
+                                                    int rowLength,
+                                                    const std::vector<double>& augmented) const {
+    std::vector<double> studentX;
+    studentX.reserve(X.size() + augmented.size());
+    studentX.insert(studentX.end(), X.begin(), X.end());
+    studentX.insert(studentX.end(), augmented.begin(), augmented.end());
+
+    // The student fits the teacher, not the labels
+    std::vector<double> soft;
+    teacher(studentX, rowLength, soft);
+
+    GBRTConfig gbrt;
+    gbrt.numIterations  = config_.numTrees;
+    gbrt.learningRate   = config_.learningRate;
+    gbrt.maxDepth       = config_.maxDepth;
+    gbrt.minSamplesLeaf = config_.minSamplesLeaf;
+    gbrt.splitMethod    = config_.splitMethod;
+    gbrt.verbose        = false;
+
+    auto student = std::make_unique<GBRTTrainer>(
+        gbrt, std::make_unique<GradientRegressionStrategy>(
+                  std::make_unique<SquaredLoss>(), config_.learningRate));
+    student->train(studentX, rowLength, soft);
+    return student;
+}
+
+DistillReport ForestDistiller::evaluate(const Teacher& teacher,
+                                        const GBRTTrainer& student,
+                                        const std::vector<double>& X,
+                                        int rowLength,
+                                        const std::vector<double>& y) {
+    DistillReport report;
+    const size_t n = y.size();
+    if (n == 0) return report;
+
+    std::vector<double> teacherPred;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    teacher(X, rowLength, teacherPred);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    const std::vector<double> studentPred = student.predictBatch(X, rowLength);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    report.teacherPredictUs = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+    report.studentPredictUs = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+    double teacherMean = 0.0;
+    for (size_t i = 0; i < n; ++i) teacherMean += teacherPred[i];
+    teacherMean /= n;
+
+    double teacherVar = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double dt = y[i] - teacherPred[i];
+        const double ds = y[i] - studentPred[i];
+        const double dts = studentPred[i] - teacherPred[i];
+        const double dv = teacherPred[i] - teacherMean;
+        report.teacherMSE  += dt * dt;
+        report.studentMSE  += ds * ds;
+        report.fidelityMSE += dts * dts;
+        teacherVar += dv * dv;
+    }
+    report.teacherMSE  /= n;
+    report.studentMSE  /= n;
+    report.fidelityMSE /= n;
+    teacherVar /= n;
+    report.fidelityR2 = teacherVar > 0.0 ? 1.0 - report.fidelityMSE / teacherVar : 0.0;
+    return report;
+}
@@ -7,19 +7,30 @@
 #include "finder/ExhaustiveSplitFinder.hpp"
 #include "pruner/NoPruner.hpp"
 #include "boosting/dart/UniformDartStrategy.hpp"
+#include "tuning/ParallelCalibration.hpp"
 #include <algorithm>
 #include <numeric>
 #include <chrono>
 #include <iomanip>
 #include <memory>
-#include <execution>  // C++17并行算法
+#include <functional>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 GBRTTrainer::GBRTTrainer(const GBRTConfig& config,
                         std::unique_ptr<GradientRegressionStrategy> strategy)
-    : config_(config), strategy_(std::move(strategy)), dartGen_(config.dartSeed) {
+    : config_(config), strategy_(std::move(strategy)) {
+    
+    // Explicit config values win; otherwise use the per-machine calibrated profile
+    const auto& cutoffs = ParallelCalibration::cutoffs();
+    parallelThreshold_ = config_.parallelThreshold > 0
+                             ? static_cast<size_t>(config_.parallelThreshold)
+                             : cutoffs.elementwiseParallelMinSamples;
+    chunkSize_ = config_.chunkSize > 0 ? config_.chunkSize : cutoffs.elementwiseChunkSize;
+    // Tree walks cost far more per element than element-wise updates
+    traversalThreshold_ = parallelThreshold_ / 2;
+    traversalChunk_ = std::max(1, chunkSize_ / 4);
     
     if (config_.enableDart) {
         dartStrategy_ = createDartStrategy();
@@ -43,13 +54,33 @@ GBRTTrainer::GBRTTrainer(const GBRTConfig& config,
 void GBRTTrainer::train(const std::vector<double>& X,
                        int rowLength,
                        const std::vector<double>& y) {
+    // Column-major copy built once and shared by every boosting iteration
+    const FeatureMatrix columns(X, rowLength);
+    train(columns, y);
+}
+
+void GBRTTrainer::train(const FeatureMatrix& columns,
+                       const std::vector<double>& y) {
     
     auto totalStart = std::chrono::high_resolution_clock::now();
     
+    // Prediction updates still walk rows; reuse the caller's view when present
+    std::vector<double> materialized;
+    if (!columns.hasRowMajor()) materialized = columns.toRowMajor();
+    const std::vector<double>& X = columns.hasRowMajor() ? columns.rowMajor() : materialized;
+    const int rowLength = columns.numFeatures();
+    
+    // The features never change between rounds, only the residuals do: sort
+    // every feature once here instead of at every node of every tree
+    PresortedIndex presort;
+    if (createTreeTrainer()->usesSortedOrder()) {
+        presort = PresortedIndex(columns);
+    }
+    
     if (config_.enableDart) {
-        trainWithDartOptimized(X, rowLength, y);
+        trainWithDartOptimized(X, columns, presort, rowLength, y);
     } else {
-        trainStandardOptimized(X, rowLength, y);
+        trainStandardOptimized(X, columns, presort, rowLength, y);
     }
     
     auto totalEnd = std::chrono::high_resolution_clock::now();
@@ -70,6 +101,8 @@ void GBRTTrainer::train(const std::vector<double>& X,
 
 
 void GBRTTrainer::trainStandardOptimized(const std::vector<double>& X,
+                                         const FeatureMatrix& columns,
+                                         const PresortedIndex& presort,
                                          int rowLength,
                                          const std::vector<double>& y) {
     
@@ -96,6 +129,7 @@ void GBRTTrainer::trainStandardOptimized(const std::vector<double>& X,
     
     trainingLoss_.reserve(config_.numIterations);
     
+    auto treeTrainer = createTreeTrainer();
  
     for (int iter = 0; iter < config_.numIterations; ++iter) {
         auto iterStart = std::chrono::high_resolution_clock::now();
@@ -107,8 +141,7 @@ void GBRTTrainer::trainStandardOptimized(const std::vector<double>& X,
         computeResidualsParallel(y, currentPred, residuals);
         
      
-        auto treeTrainer = createTreeTrainer();
-        treeTrainer->train(X, rowLength, residuals);
+        fitTree(*treeTrainer, columns, presort, residuals);
         
        
         batchTreePredictOptimized(treeTrainer.get(), X, rowLength, treePred);
@@ -120,8 +153,7 @@ void GBRTTrainer::trainStandardOptimized(const std::vector<double>& X,
         updatePredictionsVectorized(treePred, lr, currentPred);
         
       
-        auto rootCopy = cloneTreeOptimized(treeTrainer->getRoot());
-        model_.addTree(std::move(rootCopy), 1.0, lr);
+        model_.addTree(treeTrainer->releaseRoot(), 1.0, lr);
         
         auto iterEnd = std::chrono::high_resolution_clock::now();
         auto iterTime = std::chrono::duration_cast<std::chrono::milliseconds>(iterEnd - iterStart);
@@ -146,6 +178,8 @@ void GBRTTrainer::trainStandardOptimized(const std::vector<double>& X,
 
 
 void GBRTTrainer::trainWithDartOptimized(const std::vector<double>& X,
+                                         const FeatureMatrix& columns,
+                                         const PresortedIndex& presort,
                                          int rowLength,
                                          const std::vector<double>& y) {
     
@@ -170,6 +204,7 @@ void GBRTTrainer::trainWithDartOptimized(const std::vector<double>& X,
     
     trainingLoss_.reserve(config_.numIterations);
     
+    auto treeTrainer = createTreeTrainer();
 
     for (int iter = 0; iter < config_.numIterations; ++iter) {
         auto iterStart = std::chrono::high_resolution_clock::now();
@@ -177,10 +212,11 @@ void GBRTTrainer::trainWithDartOptimized(const std::vector<double>& X,
        
         std::vector<int> droppedTrees;
         if (model_.getTreeCount() > 0) {
+            CounterRng dropRng(config_.dartSeed, RngPurpose::DartDrop, static_cast<uint32_t>(iter));
             droppedTrees = dartStrategy_->selectDroppedTrees(
                 static_cast<int>(model_.getTreeCount()), 
                 config_.dartDropRate, 
-                dartGen_);
+                dropRng);
         }
         
         if (config_.verbose && iter % 10 == 0 && !droppedTrees.empty()) {
@@ -201,8 +237,7 @@ void GBRTTrainer::trainWithDartOptimized(const std::vector<double>& X,
         computeResidualsParallel(y, currentPred, residuals);
         
       
-        auto treeTrainer = createTreeTrainer();
-        treeTrainer->train(X, rowLength, residuals);
+        fitTree(*treeTrainer, columns, presort, residuals);
         
      
         batchTreePredictOptimized(treeTrainer.get(), X, rowLength, treePred);
@@ -210,8 +245,7 @@ void GBRTTrainer::trainWithDartOptimized(const std::vector<double>& X,
       
         double lr = strategy_->computeLearningRate(iter, y, currentPred, treePred);
         
-        auto rootCopy = cloneTreeOptimized(treeTrainer->getRoot());
-        model_.addTree(std::move(rootCopy), 1.0, lr);
+        model_.addTree(treeTrainer->releaseRoot(), 1.0, lr);
         
       
         int newTreeIndex = static_cast<int>(model_.getTreeCount()) - 1;
@@ -246,7 +280,9 @@ double GBRTTrainer::computeBaseScoreParallel(const std::vector<double>& y) const
     const size_t n = y.size();
     double sum = 0.0;
     
-    #pragma omp parallel for reduction(+:sum) schedule(static, 2048) if(n > 1000)
+    const size_t threshold = parallelThreshold_;
+    const int chunk = chunkSize_;
+    #pragma omp parallel for reduction(+:sum) schedule(static, chunk) if(n > threshold)
     for (size_t i = 0; i < n; ++i) {
         sum += y[i];
     }
@@ -261,7 +297,9 @@ double GBRTTrainer::computeTotalLossParallel(const std::vector<double>& y,
     double totalLoss = 0.0;
     
     
-    #pragma omp parallel for reduction(+:totalLoss) schedule(static, 4096) if(n > 2000)
+    const size_t threshold = parallelThreshold_;
+    const int chunk = chunkSize_;
+    #pragma omp parallel for reduction(+:totalLoss) schedule(static, chunk) if(n > threshold)
     for (size_t i = 0; i < n; ++i) {
         totalLoss += strategy_->getLossFunction()->loss(y[i], pred[i]);
     }
@@ -276,7 +314,9 @@ void GBRTTrainer::computeResidualsParallel(const std::vector<double>& y,
     const size_t n = y.size();
     
    
-    #pragma omp parallel for schedule(static, 4096) if(n > 2000)
+    const size_t threshold = parallelThreshold_;
+    const int chunk = chunkSize_;
+    #pragma omp parallel for schedule(static, chunk) if(n > threshold)
     for (size_t i = 0; i < n; ++i) {
         residuals[i] = strategy_->getLossFunction()->gradient(y[i], pred[i]);
     }
@@ -289,8 +329,22 @@ void GBRTTrainer::batchTreePredictOptimized(const SingleTreeTrainer* trainer,
                                            std::vector<double>& predictions) const {
     const size_t n = predictions.size();
     
+    // Every training row already knows its leaf: a gather instead of n traversals
+    const std::vector<const Node*>& leaves = trainer->getTrainingLeaves();
+    if (leaves.size() == n) {
+        const size_t threshold = parallelThreshold_;
+        const int chunk = chunkSize_;
+        #pragma omp parallel for schedule(static, chunk) if(n > threshold)
+        for (size_t i = 0; i < n; ++i) {
+            predictions[i] = leaves[i] ? leaves[i]->getPrediction()
+                                       : trainer->predict(&X[i * rowLength], rowLength);
+        }
+        return;
+    }
     
-    #pragma omp parallel for schedule(static, 1024) if(n > 500)
+    const size_t threshold = traversalThreshold_;
+    const int chunk = traversalChunk_;
+    #pragma omp parallel for schedule(static, chunk) if(n > threshold)
     for (size_t i = 0; i < n; ++i) {
         predictions[i] = trainer->predict(&X[i * rowLength], rowLength);
     }
@@ -303,7 +357,9 @@ void GBRTTrainer::updatePredictionsVectorized(const std::vector<double>& treePre
     const size_t n = predictions.size();
     
    
-    #pragma omp parallel for schedule(static, 4096) if(n > 2000)
+    const size_t threshold = parallelThreshold_;
+    const int chunk = chunkSize_;
+    #pragma omp parallel for schedule(static, chunk) if(n > threshold)
     for (size_t i = 0; i < n; ++i) {
         predictions[i] += lr * treePred[i];
     }
@@ -324,7 +380,9 @@ void GBRTTrainer::computeDartPredictionsParallel(const std::vector<double>& X,
             if (treeIdx >= 0 && treeIdx < static_cast<int>(model_.getTrees().size())) {
                 const auto& tree = model_.getTrees()[treeIdx];
                 
-                #pragma omp parallel for schedule(static, 1024) if(n > 500)
+                const size_t threshold = traversalThreshold_;
+                const int chunk = traversalChunk_;
+                #pragma omp parallel for schedule(static, chunk) if(n > threshold)
                 for (size_t i = 0; i < n; ++i) {
                     double treePred = predictSingleTreeFast(tree.tree.get(), &X[i * rowLength]);
                     predictions[i] -= tree.learningRate * tree.weight * treePred;
@@ -333,7 +391,9 @@ void GBRTTrainer::computeDartPredictionsParallel(const std::vector<double>& X,
         }
     } else {
         
-        #pragma omp parallel for schedule(static, 512) if(n > 1000)
+        const size_t threshold = traversalThreshold_;
+        const int chunk = traversalChunk_;
+        #pragma omp parallel for schedule(static, chunk) if(n > threshold)
         for (size_t i = 0; i < n; ++i) {
             const double* sample = &X[i * rowLength];
             predictions[i] = dartStrategy_->computeDropoutPrediction(
@@ -347,7 +407,9 @@ void GBRTTrainer::recomputeFullPredictionsParallel(const std::vector<double>& X,
                                                    std::vector<double>& predictions) const {
     const size_t n = predictions.size();
     
-    #pragma omp parallel for schedule(static, 512) if(n > 1000)
+    const size_t threshold = traversalThreshold_;
+    const int chunk = traversalChunk_;
+    #pragma omp parallel for schedule(static, chunk) if(n > threshold)
     for (size_t i = 0; i < n; ++i) {
         predictions[i] = model_.predict(&X[i * rowLength], rowLength);
     }
@@ -407,7 +469,9 @@ std::vector<double> GBRTTrainer::predictBatch(
     if (config_.enableDart && dartStrategy_) {
        
         predictions.resize(n);
-        #pragma omp parallel for schedule(static, 512) if(n > 1000)
+        const size_t threshold = traversalThreshold_;
+        const int chunk = traversalChunk_;
+        #pragma omp parallel for schedule(static, chunk) if(n > threshold)
         for (size_t i = 0; i < n; ++i) {
             const double* sample = &X[i * rowLength];
             predictions[i] = dartStrategy_->computeDropoutPrediction(
@@ -436,7 +500,9 @@ void GBRTTrainer::evaluate(const std::vector<double>& X,
     mse = 0.0;
     mae = 0.0;
     
-    #pragma omp parallel for reduction(+:mse,mae) schedule(static, 2048) if(n > 2000)
+    const size_t threshold = parallelThreshold_;
+    const int chunk = chunkSize_;
+    #pragma omp parallel for reduction(+:mse,mae) schedule(static, chunk) if(n > threshold)
     for (size_t i = 0; i < n; ++i) {
         double diff = y[i] - predictions[i];
         mse += diff * diff;
@@ -460,6 +526,17 @@ bool GBRTTrainer::shouldEarlyStop(const std::vector<double>& losses, int patienc
 }
 
 
+void GBRTTrainer::fitTree(SingleTreeTrainer& treeTrainer,
+                          const FeatureMatrix& columns,
+                          const PresortedIndex& presort,
+                          const std::vector<double>& residuals) const {
+    if (presort.empty()) {
+        treeTrainer.train(columns, residuals);
+    } else {
+        treeTrainer.train(columns, residuals, presort);
+    }
+}
+
 std::unique_ptr<SingleTreeTrainer> GBRTTrainer::createTreeTrainer() const {
     auto criterion = std::make_unique<MSECriterion>();
     auto finder = std::make_unique<ExhaustiveSplitFinder>();
@@ -12,6 +12,58 @@
 #include <iomanip>
 #include <stdexcept>    
 #include <vector>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DATAIO_HAS_MMAP 1
+#endif
+
+namespace {
+
+struct BinaryHeader {
+    char          magic[8];
+    std::uint64_t rows;
+    std::uint64_t features;
+};
+
+constexpr char BINARY_MAGIC[8] = {'D', 'T', 'B', 'I', 'N', '0', '1', '\0'};
+
+// Validates the header against the file size and copies the payload out
+bool decodeBinary(const char* bytes, size_t size, const std::string& filename,
+                  std::vector<double>& flattenedFeatures,
+                  std::vector<double>& labels,
+                  int& rowLength) {
+    BinaryHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << "Truncated binary dataset: " << filename << std::endl;
+        return false;
+    }
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+        std::cerr << "Not a binary dataset: " << filename << std::endl;
+        return false;
+    }
+    const size_t numFeatureValues = static_cast<size_t>(header.rows * header.features);
+    if (size != sizeof(header) + (numFeatureValues + header.rows) * sizeof(double)) {
+        std::cerr << "Binary dataset size mismatch: " << filename << std::endl;
+        return false;
+    }
+    const char* payload = bytes + sizeof(header);
+    flattenedFeatures.resize(numFeatureValues);
+    labels.resize(header.rows);
+    std::memcpy(flattenedFeatures.data(), payload, numFeatureValues * sizeof(double));
+    std::memcpy(labels.data(), payload + numFeatureValues * sizeof(double),
+                header.rows * sizeof(double));
+    rowLength = static_cast<int>(header.features) + 1;
+    return true;
+}
+
+} // namespace
 
 
 std::pair<std::vector<double>, std::vector<double>>
@@ -236,6 +288,73 @@ bool DataIO::readCSVMemoryMapped(const std::string& filename,
     return !flattenedFeatures.empty();
 }
 
+bool DataIO::writeBinary(const std::string& filename,
+                         const std::vector<double>& flattenedFeatures,
+                         const std::vector<double>& labels,
+                         int rowLength) const {
+    const int features = rowLength - 1;
+    if (features <= 0 || flattenedFeatures.size() != labels.size() * features) {
+        std::cerr << "Error: Feature count mismatch writing " << filename << std::endl;
+        return false;
+    }
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file: " << filename << std::endl;
+        return false;
+    }
+    BinaryHeader header;
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.rows = labels.size();
+    header.features = static_cast<std::uint64_t>(features);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(flattenedFeatures.data()),
+               static_cast<std::streamsize>(flattenedFeatures.size() * sizeof(double)));
+    file.write(reinterpret_cast<const char*>(labels.data()),
+               static_cast<std::streamsize>(labels.size() * sizeof(double)));
+    return static_cast<bool>(file);
+}
+
+bool DataIO::readBinaryMapped(const std::string& filename,
+                              std::vector<double>& flattenedFeatures,
+                              std::vector<double>& labels,
+                              int& rowLength) const {
+#ifdef DATAIO_HAS_MMAP
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Unable to open file: " << filename << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        std::cerr << "Empty file: " << filename << std::endl;
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Unable to map file: " << filename << std::endl;
+        return false;
+    }
+    ::madvise(mapped, size, MADV_SEQUENTIAL);
+    const bool ok = decodeBinary(static_cast<const char*>(mapped), size, filename,
+                                 flattenedFeatures, labels, rowLength);
+    ::munmap(mapped, size);
+    return ok;
+#else
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file: " << filename << std::endl;
+        return false;
+    }
+    const std::string bytes((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+    return decodeBinary(bytes.data(), bytes.size(), filename,
+                        flattenedFeatures, labels, rowLength);
+#endif
+}
+
 // New method: Validate data integrity
 bool DataIO::validateData(const std::vector<double>& flattenedFeatures,
                           const std::vector<double>& labels,
@@ -0,0 +1,212 @@
+// =============================================================================
+// src/functions/io/MPIDataIO.cpp - Byte-range parallel CSV parsing + allgather
+// =============================================================================
+#include "functions/io/MPIDataIO.hpp"
+#include "functions/io/DataIO.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// Extra bytes read per step while completing a range's last line
+constexpr MPI_Offset TAIL_CHUNK = 1 << 16;
+// MPI counts are int
+constexpr MPI_Offset MAX_READ = INT_MAX / 2;
+
+} // namespace
+
+MPIDataIO::MPIDataIO(MPI_Comm comm) : comm_(comm) {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+}
+
+bool MPIDataIO::isBinaryPath(const std::string& filename) {
+    return filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0;
+}
+
+bool MPIDataIO::allOk(bool ok) const {
+    int local = ok ? 1 : 0, global = 0;
+    MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_MIN, comm_);
+    return global == 1;
+}
+
+bool MPIDataIO::load(const std::string& filename,
+                     std::vector<double>& flattenedFeatures,
+                     std::vector<double>& labels,
+                     int& rowLength) const {
+    if (isBinaryPath(filename)) {
+        DataIO io;
+        const bool ok = io.readBinaryMapped(filename, flattenedFeatures, labels, rowLength);
+        if (!allOk(ok)) return false;
+        if (rank_ == 0) {
+            std::cout << "Loaded " << labels.size() << " samples with "
+                      << (rowLength - 1) << " features each (mapped on "
+                      << size_ << " processes)" << std::endl;
+        }
+        return true;
+    }
+    return readCSVCollective(filename, flattenedFeatures, labels, rowLength);
+}
+
+bool MPIDataIO::readRange(MPI_File fh, MPI_Offset fileSize,
+                          MPI_Offset begin, MPI_Offset end,
+                          std::string& buffer) const {
+    buffer.clear();
+    if (begin >= end) return true;
+    const MPI_Offset readBegin = begin > 0 ? begin - 1 : 0;
+
+    auto readAt = [&](MPI_Offset offset, MPI_Offset bytes) {
+        const size_t old = buffer.size();
+        buffer.resize(old + static_cast<size_t>(bytes));
+        MPI_Offset done = 0;
+        while (done < bytes) {
+            const int step = static_cast<int>(std::min(bytes - done, MAX_READ));
+            MPI_Status status;
+            if (MPI_File_read_at(fh, offset + done, &buffer[old + done], step,
+                                 MPI_CHAR, &status) != MPI_SUCCESS) {
+                return false;
+            }
+            int got = 0;
+            MPI_Get_count(&status, MPI_CHAR, &got);
+            if (got <= 0) break;
+            done += got;
+        }
+        buffer.resize(old + static_cast<size_t>(done));
+        return true;
+    };
+
+    if (!readAt(readBegin, end - readBegin)) return false;
+
+    // The last line starting before `end` must be complete: read on until a
+    // newline at or after byte end - 1, or end of file
+    size_t searchFrom = static_cast<size_t>(end - 1 - readBegin);
+    while (buffer.find('\n', searchFrom) == std::string::npos) {
+        const MPI_Offset next = readBegin + static_cast<MPI_Offset>(buffer.size());
+        if (next >= fileSize) break;
+        searchFrom = buffer.size();
+        if (!readAt(next, std::min(TAIL_CHUNK, fileSize - next))) return false;
+    }
+    return true;
+}
+
+bool MPIDataIO::readCSVCollective(const std::string& filename,
+                                  std::vector<double>& flattenedFeatures,
+                                  std::vector<double>& labels,
+                                  int& rowLength) const {
+    flattenedFeatures.clear();
+    labels.clear();
+    rowLength = 0;
+
+    MPI_File fh;
+    if (MPI_File_open(comm_, filename.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rank_ == 0) std::cerr << "Unable to open file: " << filename << std::endl;
+        return false;
+    }
+    MPI_Offset fileSize = 0;
+    MPI_File_get_size(fh, &fileSize);
+
+    // This rank owns the lines whose first byte lies in [begin, end)
+    const MPI_Offset begin = fileSize * rank_ / size_;
+    const MPI_Offset end = fileSize * (rank_ + 1) / size_;
+    std::string buffer;
+    const bool readOk = readRange(fh, fileSize, begin, end, buffer);
+    MPI_File_close(&fh);
+    if (!allOk(readOk)) {
+        if (rank_ == 0) std::cerr << "Failed to read file: " << filename << std::endl;
+        return false;
+    }
+
+    // buffer[0] is byte begin - 1 (begin > 0) or the header's first byte
+    // (begin == 0); either way the first owned line follows the first newline
+    std::vector<double> localFeatures;
+    std::vector<double> localLabels;
+    std::vector<double> row;
+    int features = -1;
+    long long skippedRows = 0, badValues = 0;
+    const size_t limit = begin < end ? static_cast<size_t>(end - (begin > 0 ? begin - 1 : 0)) : 0;
+    size_t pos = buffer.find('\n');
+    pos = (pos == std::string::npos) ? buffer.size() : pos + 1;
+
+    while (pos < limit && pos < buffer.size()) {
+        size_t lineEnd = buffer.find('\n', pos);
+        if (lineEnd == std::string::npos) lineEnd = buffer.size();
+        const char* p = buffer.data() + pos;
+        const char* e = buffer.data() + lineEnd;
+        pos = lineEnd + 1;
+        if (e > p && e[-1] == '\r') --e;
+        if (p == e) continue;
+
+        row.clear();
+        while (true) {
+            const char* comma = static_cast<const char*>(std::memchr(p, ',', e - p));
+            if (!comma) comma = e;
+            char* stop = nullptr;
+            double v = std::strtod(p, &stop);
+            if (stop == p || stop > comma) {
+                v = 0.0;   // Unparsable field, as readCSV does
+                ++badValues;
+            }
+            row.push_back(v);
+            if (comma == e) break;
+            p = comma + 1;
+        }
+
+        const int rowFeatures = static_cast<int>(row.size()) - 1;
+        if (features < 0) features = rowFeatures;
+        if (rowFeatures != features || rowFeatures <= 0) {
+            ++skippedRows;
+            continue;
+        }
+        localLabels.push_back(row.back());
+        localFeatures.insert(localFeatures.end(), row.begin(), row.end() - 1);
+    }
+
+    // Agree on the feature count and report parse problems once
+    int globalFeatures = 0;
+    MPI_Allreduce(&features, &globalFeatures, 1, MPI_INT, MPI_MAX, comm_);
+    long long counts[2] = {skippedRows, badValues}, totals[2] = {0, 0};
+    MPI_Reduce(counts, totals, 2, MPI_LONG_LONG, MPI_SUM, 0, comm_);
+    if (!allOk(globalFeatures > 0 && (features < 0 || features == globalFeatures))) {
+        if (rank_ == 0) std::cerr << "Inconsistent column count in " << filename << std::endl;
+        return false;
+    }
+    if (rank_ == 0 && (totals[0] > 0 || totals[1] > 0)) {
+        std::cerr << "Warning: " << totals[0] << " malformed rows skipped, "
+                  << totals[1] << " unparsable values read as 0" << std::endl;
+    }
+
+    // Allgather the parsed rows in rank order (= file order)
+    const int localRows = static_cast<int>(localLabels.size());
+    std::vector<int> rowCounts(size_), rowDispls(size_), featCounts(size_), featDispls(size_);
+    MPI_Allgather(&localRows, 1, MPI_INT, rowCounts.data(), 1, MPI_INT, comm_);
+    long long totalRows = 0;
+    for (int r = 0; r < size_; ++r) {
+        rowDispls[r] = static_cast<int>(totalRows);
+        totalRows += rowCounts[r];
+    }
+    if (totalRows * globalFeatures > INT_MAX) {
+        if (rank_ == 0) std::cerr << "Dataset too large for a single allgather: " << filename << std::endl;
+        return false;
+    }
+    for (int r = 0; r < size_; ++r) {
+        featCounts[r] = rowCounts[r] * globalFeatures;
+        featDispls[r] = rowDispls[r] * globalFeatures;
+    }
+
+    labels.resize(static_cast<size_t>(totalRows));
+    flattenedFeatures.resize(static_cast<size_t>(totalRows) * globalFeatures);
+    MPI_Allgatherv(localLabels.data(), localRows, MPI_DOUBLE,
+                   labels.data(), rowCounts.data(), rowDispls.data(), MPI_DOUBLE, comm_);
+    MPI_Allgatherv(localFeatures.data(), localRows * globalFeatures, MPI_DOUBLE,
+                   flattenedFeatures.data(), featCounts.data(), featDispls.data(), MPI_DOUBLE, comm_);
+    rowLength = globalFeatures + 1;
+
+    if (rank_ == 0) {
+        std::cout << "Loaded " << totalRows << " samples with " << globalFeatures
+                  << " features each (parsed by " << size_ << " processes)" << std::endl;
+    }
+    return true;
+}
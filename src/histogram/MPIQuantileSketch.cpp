@@ -0,0 +1,101 @@
+// =============================================================================
+// src/histogram/MPIQuantileSketch.cpp - Fixed-stride sketch, allgathered
+// =============================================================================
+#include "histogram/MPIQuantileSketch.hpp"
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+// Rows gathered (at most) for the sketch
+constexpr unsigned long long SKETCH_ROWS = 1ULL << 16;
+
+} // namespace
+
+std::vector<std::vector<double>> MPIQuantileSketch::computeCuts(MPI_Comm comm,
+                                                                const std::vector<double>& data,
+                                                                std::size_t rows,
+                                                                int numFeatures,
+                                                                int maxBins) {
+    int rank = 0, size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    maxBins = std::max(2, std::min(maxBins, 256));
+
+    unsigned long long local = rows, global = 0, offset = 0;
+    MPI_Allreduce(&local, &global, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm);
+    MPI_Exscan(&local, &offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm);
+    if (rank == 0) offset = 0;
+    const unsigned long long stride = std::max(1ULL, (global + SKETCH_ROWS - 1) / SKETCH_ROWS);
+
+    std::vector<double> localSketch;
+    for (unsigned long long i = (stride - offset % stride) % stride; i < local; i += stride) {
+        const double* x = &data[i * numFeatures];
+        localSketch.insert(localSketch.end(), x, x + numFeatures);
+    }
+    const int localCount = static_cast<int>(localSketch.size());
+    std::vector<int> counts(size), displs(size);
+    MPI_Allgather(&localCount, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+    int total = 0;
+    for (int r = 0; r < size; ++r) {
+        displs[r] = total;
+        total += counts[r];
+    }
+    std::vector<double> sketch(total);
+    MPI_Allgatherv(localSketch.data(), localCount, MPI_DOUBLE,
+                   sketch.data(), counts.data(), displs.data(), MPI_DOUBLE, comm);
+    const std::size_t sketchRows = numFeatures > 0 ? static_cast<std::size_t>(total) / numFeatures : 0;
+
+    std::vector<std::vector<double>> cuts(numFeatures);
+    #pragma omp parallel for schedule(dynamic)
+    for (int f = 0; f < numFeatures; ++f) {
+        std::vector<double> vals(sketchRows);
+        for (std::size_t i = 0; i < sketchRows; ++i) vals[i] = sketch[i * numFeatures + f];
+        std::sort(vals.begin(), vals.end());
+        std::vector<double>& c = cuts[f];
+        if (vals.empty()) continue;
+
+        std::vector<double> distinct(vals);
+        distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+        if (static_cast<int>(distinct.size()) <= maxBins) {
+            // One bin per value; values above the last cut fall in the last bin
+            c.assign(distinct.begin(), distinct.end() - 1);
+            continue;
+        }
+        const std::size_t m = vals.size();
+        for (int k = 1; k < maxBins; ++k) {
+            const std::size_t idx = static_cast<std::size_t>(k) * m / maxBins;
+            if (idx == 0) continue;
+            const double v = vals[idx - 1];
+            if (v < distinct.back() && (c.empty() || v > c.back())) c.push_back(v);
+        }
+    }
+    return cuts;
+}
+
+void MPIQuantileSketch::binColumns(const std::vector<std::vector<double>>& cuts,
+                                   const std::vector<double>& data,
+                                   std::size_t rows,
+                                   std::vector<std::uint8_t>& bins) {
+    const int numFeatures = static_cast<int>(cuts.size());
+    bins.resize(rows * numFeatures);
+    #pragma omp parallel for schedule(static)
+    for (int f = 0; f < numFeatures; ++f) {
+        const std::vector<double>& c = cuts[f];
+        std::uint8_t* col = &bins[static_cast<std::size_t>(f) * rows];
+        for (std::size_t r = 0; r < rows; ++r) {
+            const double x = data[r * numFeatures + f];
+            col[r] = static_cast<std::uint8_t>(std::lower_bound(c.begin(), c.end(), x) - c.begin());
+        }
+    }
+}
+
+std::vector<int> MPIQuantileSketch::binOffsets(const std::vector<std::vector<double>>& cuts) {
+    std::vector<int> offsets(cuts.size() + 1, 0);
+    for (std::size_t f = 0; f < cuts.size(); ++f) {
+        offsets[f + 1] = offsets[f] + static_cast<int>(cuts[f].size()) + 1;
+    }
+    return offsets;
+}
@@ -22,6 +22,12 @@ void runLightGBMApp(const LightGBMAppOptions& opts) {
     DataParams dp;
     splitDataset(X, y, rowLength, dp);
     
+    // Hold out validation rows for ensemble pruning
+    std::vector<double> X_val, y_val;
+    if (!opts.pruneMethod.empty() && opts.valSplit > 0) {
+        holdOutValidation(dp, opts.valSplit, X_val, y_val);
+    }
+    
     // Create trainer
     auto trainer = createLightGBMTrainer(opts);
     
@@ -39,6 +45,18 @@ void runLightGBMApp(const LightGBMAppOptions& opts) {
     trainer->evaluate(dp.X_train, dp.rowLength, dp.y_train, trainMSE, trainMAE);
     trainer->evaluate(dp.X_test, dp.rowLength, dp.y_test, testMSE, testMAE);
     
+    if (!y_val.empty()) {
+        const size_t fullTrees = trainer->getLGBModel()->getTreeCount();
+        EnsemblePruner pruner(EnsemblePruner::parseMethod(opts.pruneMethod), opts.pruneTol);
+        const EnsembleSelection sel = trainer->pruneEnsemble(pruner, X_val, dp.rowLength, y_val);
+        double prunedMSE, prunedMAE;
+        trainer->evaluate(dp.X_test, dp.rowLength, dp.y_test, prunedMSE, prunedMAE);
+        std::cout << "Ensemble pruning (" << opts.pruneMethod << "): " << sel.trees.size()
+                  << "/" << fullTrees << " trees | Val MSE " << std::fixed << std::setprecision(6)
+                  << sel.fullMSE << " -> " << sel.prunedMSE
+                  << " | Test MSE " << testMSE << " -> " << prunedMSE << std::endl;
+    }
+    
     auto totalEnd = std::chrono::high_resolution_clock::now();
     
     // Output results
@@ -66,6 +84,7 @@ std::unique_ptr<LightGBMTrainer> createLightGBMTrainer(const LightGBMAppOptions&
     config.minDataInLeaf = opts.minDataInLeaf;
     config.topRate = opts.topRate;
     config.otherRate = opts.otherRate;
+    config.seed = opts.seed;
     config.maxBin = opts.maxBin;
     config.maxConflictRate = opts.maxConflictRate;
     config.enableFeatureBundling = opts.enableFeatureBundling;
@@ -3,6 +3,7 @@
 // OpenMP Deep Parallel Optimization Version (with header additions and parallel reduction fixes)
 // =============================================================================
 #include "lightgbm/sampling/GOSSSampler.hpp"
+#include "functions/random/CounterRng.hpp"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -14,7 +15,8 @@
 
 void GOSSSampler::sample(const std::vector<double>& gradients,
                         std::vector<int>& sampleIndices,
-                        std::vector<double>& sampleWeights) const {
+                        std::vector<double>& sampleWeights,
+                        int iteration) const {
     size_t n = gradients.size();
     // If parameters are invalid, perform full sampling
     if (!validateParameters()) {
@@ -25,15 +27,16 @@ void GOSSSampler::sample(const std::vector<double>& gradients,
     }
     // Parallel only if sample size is large enough, otherwise serial
     if (n >= getParallelThreshold()) {
-        sampleParallel(gradients, sampleIndices, sampleWeights);
+        sampleParallel(gradients, sampleIndices, sampleWeights, iteration);
     } else {
-        sampleSerial(gradients, sampleIndices, sampleWeights);
+        sampleSerial(gradients, sampleIndices, sampleWeights, iteration);
     }
 }
 
 void GOSSSampler::sampleParallel(const std::vector<double>& gradients,
                                  std::vector<int>& sampleIndices,
-                                 std::vector<double>& sampleWeights) const {
+                                 std::vector<double>& sampleWeights,
+                                 int iteration) const {
     size_t n = gradients.size();
     // Parallel construction of (|grad|, idx) pairs
     std::vector<std::pair<double, int>> gradWithIndex(n);
@@ -75,7 +78,9 @@ void GOSSSampler::sampleParallel(const std::vector<double>& gradients,
         for (size_t i = topNum; i < n; ++i) {
             smallGradPool.push_back(gradWithIndex[i].second);
         }
-        std::shuffle(smallGradPool.begin(), smallGradPool.end(), gen_);
+        // Only the first randNum positions are needed: partial Fisher-Yates
+        CounterRng rng(seed_, RngPurpose::GossSample, static_cast<uint32_t>(iteration));
+        rng.sampleToFront(smallGradPool.begin(), smallGradPool.end(), randNum);
         double smallWeight = (1.0 - topRate_) / otherRate_;
         for (size_t i = 0; i < randNum; ++i) {
             sampleIndices.push_back(smallGradPool[i]);
@@ -93,7 +98,8 @@ void GOSSSampler::sampleParallel(const std::vector<double>& gradients,
 
 void GOSSSampler::sampleSerial(const std::vector<double>& gradients,
                                std::vector<int>& sampleIndices,
-                               std::vector<double>& sampleWeights) const {
+                               std::vector<double>& sampleWeights,
+                               int iteration) const {
     size_t n = gradients.size();
     std::vector<std::pair<double, int>> gradWithIndex;
     gradWithIndex.reserve(n);
@@ -126,7 +132,9 @@ void GOSSSampler::sampleSerial(const std::vector<double>& gradients,
         for (size_t i = topNum; i < n; ++i) {
             smallGradPool.push_back(gradWithIndex[i].second);
         }
-        std::shuffle(smallGradPool.begin(), smallGradPool.end(), gen_);
+        // Only the first randNum positions are needed: partial Fisher-Yates
+        CounterRng rng(seed_, RngPurpose::GossSample, static_cast<uint32_t>(iteration));
+        rng.sampleToFront(smallGradPool.begin(), smallGradPool.end(), randNum);
         double smallWeight = (1.0 - topRate_) / otherRate_;
         for (size_t i = 0; i < randNum; ++i) {
             sampleIndices.push_back(smallGradPool[i]);
@@ -143,16 +151,18 @@ void GOSSSampler::sampleSerial(const std::vector<double>& gradients,
 void GOSSSampler::sampleWithTiming(const std::vector<double>& gradients,
                                    std::vector<int>& sampleIndices,
                                    std::vector<double>& sampleWeights,
+                                   int iteration,
                                    double& samplingTimeMs) const {
     auto start = std::chrono::high_resolution_clock::now();
-    sample(gradients, sampleIndices, sampleWeights);
+    sample(gradients, sampleIndices, sampleWeights, iteration);
     auto end = std::chrono::high_resolution_clock::now();
     samplingTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
 }
 
 void GOSSSampler::adaptiveSample(const std::vector<double>& gradients,
                                  std::vector<int>& sampleIndices,
-                                 std::vector<double>& sampleWeights) const {
+                                 std::vector<double>& sampleWeights,
+                                 int iteration) const {
     size_t n = gradients.size();
     // Calculate mean and std dev first, serial for n < 10000
     double meanGrad = 0.0, stdGrad = 0.0;
@@ -189,8 +199,8 @@ void GOSSSampler::adaptiveSample(const std::vector<double>& gradients,
         adaptiveTopRate = std::max(0.1, topRate_ * 0.8);
         adaptiveOtherRate = std::min(0.3, otherRate_ * 1.2);
     }
-    GOSSSampler adaptiveSampler(adaptiveTopRate, adaptiveOtherRate);
-    adaptiveSampler.sample(gradients, sampleIndices, sampleWeights);
+    GOSSSampler adaptiveSampler(adaptiveTopRate, adaptiveOtherRate, seed_);
+    adaptiveSampler.sample(gradients, sampleIndices, sampleWeights, iteration);
 }
 
 GOSSSampler::SamplingStats GOSSSampler::getSamplingStats(
@@ -60,7 +60,7 @@ LightGBMTrainer::LightGBMTrainer(const LightGBMConfig& config)
 void LightGBMTrainer::initializeComponents() {
     lossFunction_ = std::make_unique<SquaredLoss>();
     if (config_.enableGOSS) {
-        gossSampler_ = std::make_unique<GOSSSampler>(config_.topRate, config_.otherRate);
+        gossSampler_ = std::make_unique<GOSSSampler>(config_.topRate, config_.otherRate, config_.seed);
     }
     if (config_.enableFeatureBundling) {
         featureBundler_ = std::make_unique<FeatureBundler>(config_.maxBin, config_.maxConflictRate);
@@ -94,34 +94,48 @@ void LightGBMTrainer::train(const std::vector<double>& data,
     }
 
     // Initialize predictions and gradients
-    const double baseScore = computeBaseScore(labels);
+    double baseScore = computeBaseScore(labels);
+    if (sync_) {
+        sync_->prepare(data, n, rowLength);
+        double sums[2] = {n > 0 ? baseScore * n : 0.0, static_cast<double>(n)};
+        sync_->allreduceSum(sums, 2);
+        baseScore = sums[1] > 0.0 ? sums[0] / sums[1] : 0.0;
+    }
     model_.setBaseScore(baseScore);
     std::vector<double> predictions(n, baseScore);
     gradients_.assign(n, 0.0);
 
+    // Column-major copy built once and shared by every iteration
+    const FeatureMatrix columns(data, rowLength);
+
     // Boosting iterations
     for (int iter = 0; iter < config_.numIterations; ++iter) {
         auto iterStart = std::chrono::high_resolution_clock::now();
 
         // Compute loss and update gradients
-        const double currentLoss = computeLossOptimized(labels, predictions);
+        double currentLoss = computeLossOptimized(labels, predictions);
+        if (sync_) {
+            double sums[2] = {n > 0 ? currentLoss * n : 0.0, static_cast<double>(n)};
+            sync_->allreduceSum(sums, 2);
+            currentLoss = sums[1] > 0.0 ? sums[0] / sums[1] : 0.0;
+        }
         trainingLoss_.push_back(currentLoss);
         computeGradientsOptimized(labels, predictions);
 
         // GOSS sampling or full sample
-        if (config_.enableGOSS) {
+        if (config_.enableGOSS && !sync_) {
             std::vector<double> absGradients(n);
             computeAbsGradients(absGradients);
-            gossSampler_->sample(absGradients, sampleIndices_, sampleWeights_);
+            gossSampler_->sample(absGradients, sampleIndices_, sampleWeights_, iter);
             normalizeWeights(n);
         } else {
             prepareFullSample(n);
         }
 
         // Build a tree
-        auto tree = treeBuilder_->buildTree(
-            data, rowLength, labels, gradients_,
-            sampleIndices_, sampleWeights_, featureBundles_);
+        auto tree = sync_
+            ? treeBuilder_->buildTreeDistributed(columns, gradients_, sampleIndices_, sampleWeights_, *sync_)
+            : treeBuilder_->buildTree(columns, gradients_, sampleIndices_, sampleWeights_);
 
         if (!tree) {
             if (config_.verbose) {
@@ -131,7 +145,8 @@ void LightGBMTrainer::train(const std::vector<double>& data,
         }
 
         // Optimization 2: Efficient prediction update
-        updatePredictionsOptimized(data, rowLength, tree.get(), predictions, n);
+        updatePredictionsOptimized(data, rowLength, tree.get(), treeBuilder_->getRowLeaves(),
+                                   predictions, n);
         model_.addTree(std::move(tree), config_.learningRate);
 
         auto iterEnd = std::chrono::high_resolution_clock::now();
@@ -263,12 +278,14 @@ void LightGBMTrainer::prepareFullSample(size_t n) {
 void LightGBMTrainer::updatePredictionsOptimized(const std::vector<double>& data,
                                                  int rowLength,
                                                  const Node* tree,
+                                                 const std::vector<const Node*>& rowLeaf,
                                                  std::vector<double>& predictions,
                                                  size_t n) const {
     #pragma omp parallel for schedule(static) if(n > 5000)
     for (size_t i = 0; i < n; ++i) {
-        const double* sample = &data[i * rowLength];
-        const double treePred = predictSingleTree(tree, sample, rowLength);
+        // Sampled rows gather their leaf; only rows GOSS left out walk the tree
+        const double treePred = rowLeaf[i] ? rowLeaf[i]->getPrediction()
+                                           : predictSingleTree(tree, &data[i * rowLength], rowLength);
         predictions[i] += config_.learningRate * treePred;
     }
 }
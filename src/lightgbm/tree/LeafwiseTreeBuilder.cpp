@@ -3,6 +3,7 @@
 // OpenMP Deep Parallel Optimization Version (reduced lock contention, increased thresholds, pre-allocated buffers)
 // =============================================================================
 #include "lightgbm/tree/LeafwiseTreeBuilder.hpp"
+#include "tuning/ParallelCalibration.hpp"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
@@ -18,18 +19,30 @@ std::unique_ptr<Node> LeafwiseTreeBuilder::buildTree(
     const std::vector<int>& sampleIndices,
     const std::vector<double>& sampleWeights,
     const std::vector<FeatureBundle>& /* bundles */) {
+    const FeatureMatrix X(data, rowLength);
+    return buildTree(X, targets, sampleIndices, sampleWeights);
+}
+
+std::unique_ptr<Node> LeafwiseTreeBuilder::buildTree(
+    const FeatureMatrix& X,
+    const std::vector<double>& targets,
+    const std::vector<int>& sampleIndices,
+    const std::vector<double>& sampleWeights) {
 
     // Clear the priority queue
     while (!leafQueue_.empty()) leafQueue_.pop();
+    rowLeaf_.assign(targets.size(), nullptr);
 
     // Initialize root node
     auto root = std::make_unique<Node>();
     root->samples = sampleIndices.size();
 
-    // Calculate root node prediction (weighted average). Parallel for n >= 2000.
+    // Calculate root node prediction (weighted average). Parallel above the calibrated cutoff.
+    const auto& cutoffs = ParallelCalibration::cutoffs();
+    const size_t parallelMin = cutoffs.leafwiseParallelMinSamples;
     double weightedSum = 0.0, totalWeight = 0.0;
     size_t n = sampleIndices.size();
-    if (n >= 2000) {
+    if (n >= parallelMin) {
         #pragma omp parallel for reduction(+:weightedSum, totalWeight) schedule(static)
         for (size_t i = 0; i < n; ++i) {
             int idx = sampleIndices[i];
@@ -53,17 +66,17 @@ std::unique_ptr<Node> LeafwiseTreeBuilder::buildTree(
     rootInfo.sampleIndices = sampleIndices;
     if (n < static_cast<size_t>(config_.minDataInLeaf) * 2) {
         // Too few samples, make it a leaf
-        root->makeLeaf(rootPrediction);
+        makeLeaf(root.get(), rootPrediction, sampleIndices);
         return root;
     }
-    if (n >= 2000) {
-        if (!findBestSplitParallel(data, rowLength, targets, rootInfo.sampleIndices, sampleWeights, rootInfo)) {
-            root->makeLeaf(rootPrediction);
+    if (n >= parallelMin) {
+        if (!findBestSplitParallel(X, targets, rootInfo.sampleIndices, sampleWeights, rootInfo)) {
+            makeLeaf(root.get(), rootPrediction, sampleIndices);
             return root;
         }
     } else {
-        if (!findBestSplitSerial(data, rowLength, targets, rootInfo.sampleIndices, sampleWeights, rootInfo)) {
-            root->makeLeaf(rootPrediction);
+        if (!findBestSplitSerial(X, targets, rootInfo.sampleIndices, sampleWeights, rootInfo)) {
+            makeLeaf(root.get(), rootPrediction, sampleIndices);
             return root;
         }
     }
@@ -80,18 +93,18 @@ std::unique_ptr<Node> LeafwiseTreeBuilder::buildTree(
         if (bestLeaf.splitGain <= config_.minSplitGain ||
             m < static_cast<size_t>(config_.minDataInLeaf) * 2) {
             // Calculate leaf prediction (parallel/serial) and make it a leaf
-            double leafPred = (m >= 500)
+            double leafPred = (m >= cutoffs.reductionParallelMinSamples)
                               ? computeLeafPredictionParallel(bestLeaf.sampleIndices, targets, sampleWeights)
                               : computeLeafPredictionSerial(bestLeaf.sampleIndices, targets, sampleWeights);
-            bestLeaf.node->makeLeaf(leafPred);
+            makeLeaf(bestLeaf.node, leafPred, bestLeaf.sampleIndices);
             continue;
         }
 
         // Perform split (parallel or serial)
-        if (m >= 2000) {
-            splitLeafParallel(bestLeaf, data, rowLength, targets, sampleWeights);
+        if (m >= parallelMin) {
+            splitLeafParallel(bestLeaf, X, targets, sampleWeights);
         } else {
-            splitLeafSerial(bestLeaf, data, rowLength, targets, sampleWeights);
+            splitLeafSerial(bestLeaf, X, targets, sampleWeights);
         }
         currentLeaves++;
     }
@@ -108,9 +121,96 @@ std::unique_ptr<Node> LeafwiseTreeBuilder::buildTree(
     return root;
 }
 
+std::unique_ptr<Node> LeafwiseTreeBuilder::buildTreeDistributed(
+    const FeatureMatrix& X,
+    const std::vector<double>& targets,
+    const std::vector<int>& sampleIndices,
+    const std::vector<double>& sampleWeights,
+    ILeafSplitSync& sync) {
+
+    struct DistLeaf {
+        Node* node;
+        std::vector<int> indices;
+        std::vector<double> weights;
+        LeafStats stats;
+        LeafSplit split;
+        bool operator<(const DistLeaf& other) const { return split.gain < other.split.gain; }
+    };
+
+    sync.beginTree();
+    rowLeaf_.assign(targets.size(), nullptr);
+    auto root = std::make_unique<Node>();
+
+    double totals[3] = {static_cast<double>(sampleIndices.size()), 0.0, 0.0};
+    for (size_t i = 0; i < sampleIndices.size(); ++i) {
+        totals[1] += sampleWeights[i];
+        totals[2] += sampleWeights[i] * targets[sampleIndices[i]];
+    }
+    sync.allreduceSum(totals, 3);
+    const LeafStats rootStats{totals[0], totals[1], totals[2]};
+    root->samples = static_cast<size_t>(rootStats.count);
+
+    // Only global counts and gains steer the growth, so every process takes
+    // the same branches and issues the same collectives
+    const double minSplitCount = 2.0 * config_.minDataInLeaf;
+    std::priority_queue<DistLeaf> queue;
+    auto trySplit = [&](DistLeaf&& leaf) {
+        if (leaf.stats.count >= minSplitCount &&
+            sync.findBestSplit(leaf.indices, targets, leaf.weights, leaf.stats,
+                               config_.minDataInLeaf, leaf.split)) {
+            queue.push(std::move(leaf));
+        } else {
+            makeLeaf(leaf.node, leaf.stats.mean(), leaf.indices);
+        }
+    };
+
+    trySplit(DistLeaf{root.get(), sampleIndices, sampleWeights, rootStats, {}});
+
+    int currentLeaves = 1;
+    while (!queue.empty() && currentLeaves < config_.numLeaves) {
+        DistLeaf leaf = queue.top();
+        queue.pop();
+        const LeafSplit& split = leaf.split;
+        if (split.gain <= config_.minSplitGain) {
+            makeLeaf(leaf.node, leaf.stats.mean(), leaf.indices);
+            continue;
+        }
+
+        leaf.node->makeInternal(split.feature, split.threshold);
+        leaf.node->leftChild = std::make_unique<Node>();
+        leaf.node->rightChild = std::make_unique<Node>();
+        leaf.node->leftChild->samples = static_cast<size_t>(split.left.count);
+        leaf.node->rightChild->samples = static_cast<size_t>(split.right.count);
+
+        DistLeaf left{leaf.node->leftChild.get(), {}, {}, split.left, {}};
+        DistLeaf right{leaf.node->rightChild.get(), {}, {}, split.right, {}};
+        X.visitColumn(split.feature, [&](const auto* column) {
+            for (size_t i = 0; i < leaf.indices.size(); ++i) {
+                DistLeaf& side = (column[leaf.indices[i]] <= split.threshold) ? left : right;
+                side.indices.push_back(leaf.indices[i]);
+                side.weights.push_back(leaf.weights[i]);
+            }
+        });
+        trySplit(std::move(left));
+        trySplit(std::move(right));
+        currentLeaves++;
+    }
+
+    while (!queue.empty()) {
+        makeLeaf(queue.top().node, queue.top().stats.mean(), queue.top().indices);
+        queue.pop();
+    }
+    return root;
+}
+
+void LeafwiseTreeBuilder::makeLeaf(Node* node, double value, const std::vector<int>& rows) {
+    node->makeLeaf(value);
+    // Leaves own disjoint rows, so leaves finished in parallel never share a slot
+    for (const int row : rows) rowLeaf_[row] = node;
+}
+
 // Serial find best split
-bool LeafwiseTreeBuilder::findBestSplitSerial(const std::vector<double>& data,
-                                              int rowLength,
+bool LeafwiseTreeBuilder::findBestSplitSerial(const FeatureMatrix& X,
                                               const std::vector<double>& targets,
                                               const std::vector<int>& indices,
                                               const std::vector<double>& weights,
@@ -118,7 +218,7 @@ bool LeafwiseTreeBuilder::findBestSplitSerial(const std::vector<double>& data,
     if (indices.size() < static_cast<size_t>(config_.minDataInLeaf) * 2) return false;
     double currentMetric = criterion_->nodeMetric(targets, indices);
     auto [f, thresh, gain] =
-        finder_->findBestSplit(data, rowLength, targets, indices, currentMetric, *criterion_);
+        finder_->findBestSplit(X, targets, indices, currentMetric, *criterion_);
     leafInfo.bestFeature = f;
     leafInfo.bestThreshold = thresh;
     leafInfo.splitGain = gain;
@@ -126,8 +226,7 @@ bool LeafwiseTreeBuilder::findBestSplitSerial(const std::vector<double>& data,
 }
 
 // Parallel find best split (conceptually parallel, implementation is still serial search for best split here)
-bool LeafwiseTreeBuilder::findBestSplitParallel(const std::vector<double>& data,
-                                                int rowLength,
+bool LeafwiseTreeBuilder::findBestSplitParallel(const FeatureMatrix& X,
                                                 const std::vector<double>& targets,
                                                 const std::vector<int>& indices,
                                                 const std::vector<double>& weights,
@@ -135,7 +234,7 @@ bool LeafwiseTreeBuilder::findBestSplitParallel(const std::vector<double>& data,
     if (indices.size() < static_cast<size_t>(config_.minDataInLeaf) * 2) return false;
     double currentMetric = criterion_->nodeMetric(targets, indices);
     auto [f, thresh, gain] =
-        finder_->findBestSplit(data, rowLength, targets, indices, currentMetric, *criterion_);
+        finder_->findBestSplit(X, targets, indices, currentMetric, *criterion_);
     leafInfo.bestFeature = f;
     leafInfo.bestThreshold = thresh;
     leafInfo.splitGain = gain;
@@ -144,8 +243,7 @@ bool LeafwiseTreeBuilder::findBestSplitParallel(const std::vector<double>& data,
 
 // Serial split leaf
 void LeafwiseTreeBuilder::splitLeafSerial(LeafInfo& leafInfo,
-                                          const std::vector<double>& data,
-                                          int rowLength,
+                                          const FeatureMatrix& X,
                                           const std::vector<double>& targets,
                                           const std::vector<double>& sampleWeights) {
     leafInfo.node->makeInternal(leafInfo.bestFeature, leafInfo.bestThreshold);
@@ -157,18 +255,20 @@ void LeafwiseTreeBuilder::splitLeafSerial(LeafInfo& leafInfo,
     leftWeights_.clear();
     rightWeights_.clear();
 
-    for (size_t i = 0; i < leafInfo.sampleIndices.size(); ++i) {
-        int idx = leafInfo.sampleIndices[i];
-        double value = data[idx * rowLength + leafInfo.bestFeature];
-        double w = (i < sampleWeights.size()) ? sampleWeights[i] : 1.0;
-        if (value <= leafInfo.bestThreshold) {
-            leftIndices_.push_back(idx);
-            leftWeights_.push_back(w);
-        } else {
-            rightIndices_.push_back(idx);
-            rightWeights_.push_back(w);
+    X.visitColumn(leafInfo.bestFeature, [&](const auto* splitColumn) {
+        for (size_t i = 0; i < leafInfo.sampleIndices.size(); ++i) {
+            int idx = leafInfo.sampleIndices[i];
+            double value = splitColumn[idx];
+            double w = (i < sampleWeights.size()) ? sampleWeights[i] : 1.0;
+            if (value <= leafInfo.bestThreshold) {
+                leftIndices_.push_back(idx);
+                leftWeights_.push_back(w);
+            } else {
+                rightIndices_.push_back(idx);
+                rightWeights_.push_back(w);
+            }
         }
-    }
+    });
 
     // Left child node
     if (leftIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf)) {
@@ -177,15 +277,15 @@ void LeafwiseTreeBuilder::splitLeafSerial(LeafInfo& leafInfo,
         leftInfo.sampleIndices = leftIndices_;
         leftInfo.node->samples = leftIndices_.size();
         if (leftIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf) * 2 &&
-            findBestSplitSerial(data, rowLength, targets, leftInfo.sampleIndices, leftWeights_, leftInfo)) {
+            findBestSplitSerial(X, targets, leftInfo.sampleIndices, leftWeights_, leftInfo)) {
             leafQueue_.push(leftInfo);
         } else {
             double leftPred = computeLeafPredictionSerial(leftIndices_, targets, leftWeights_);
-            leftInfo.node->makeLeaf(leftPred);
+            makeLeaf(leftInfo.node, leftPred, leftIndices_);
         }
     } else {
         double leftPred = computeLeafPredictionSerial(leftIndices_, targets, leftWeights_);
-        leafInfo.node->leftChild->makeLeaf(leftPred);
+        makeLeaf(leafInfo.node->leftChild.get(), leftPred, leftIndices_);
     }
 
     // Right child node (logic same as left)
@@ -195,22 +295,21 @@ void LeafwiseTreeBuilder::splitLeafSerial(LeafInfo& leafInfo,
         rightInfo.sampleIndices = rightIndices_;
         rightInfo.node->samples = rightIndices_.size();
         if (rightIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf) * 2 &&
-            findBestSplitSerial(data, rowLength, targets, rightInfo.sampleIndices, rightWeights_, rightInfo)) {
+            findBestSplitSerial(X, targets, rightInfo.sampleIndices, rightWeights_, rightInfo)) {
             leafQueue_.push(rightInfo);
         } else {
             double rightPred = computeLeafPredictionSerial(rightIndices_, targets, rightWeights_);
-            rightInfo.node->makeLeaf(rightPred);
+            makeLeaf(rightInfo.node, rightPred, rightIndices_);
         }
     } else {
         double rightPred = computeLeafPredictionSerial(rightIndices_, targets, rightWeights_);
-        leafInfo.node->rightChild->makeLeaf(rightPred);
+        makeLeaf(leafInfo.node->rightChild.get(), rightPred, rightIndices_);
     }
 }
 
 // Parallel split leaf, reduced lock contention: use thread-local buffers to collect child nodes, then merge serially
 void LeafwiseTreeBuilder::splitLeafParallel(LeafInfo& leafInfo,
-                                            const std::vector<double>& data,
-                                            int rowLength,
+                                            const FeatureMatrix& X,
                                             const std::vector<double>& targets,
                                             const std::vector<double>& sampleWeights) {
     leafInfo.node->makeInternal(leafInfo.bestFeature, leafInfo.bestThreshold);
@@ -230,37 +329,39 @@ void LeafwiseTreeBuilder::splitLeafParallel(LeafInfo& leafInfo,
     // Parallel processing to local buffers
     int bestFeat = leafInfo.bestFeature;
     double bestThresh = leafInfo.bestThreshold;
-    #pragma omp parallel
-    {
-        std::vector<int> localLeftIdx, localRightIdx;
-        std::vector<double> localLeftW, localRightW;
-        localLeftIdx.reserve(m / 4 + 1);
-        localRightIdx.reserve(m / 4 + 1);
-        localLeftW.reserve(m / 4 + 1);
-        localRightW.reserve(m / 4 + 1);
-
-        #pragma omp for schedule(dynamic)
-        for (size_t i = 0; i < m; ++i) {
-            int idx = leafInfo.sampleIndices[i];
-            double value = data[idx * rowLength + bestFeat];
-            double w = (i < sampleWeights.size()) ? sampleWeights[i] : 1.0;
-            if (value <= bestThresh) {
-                localLeftIdx.push_back(idx);
-                localLeftW.push_back(w);
-            } else {
-                localRightIdx.push_back(idx);
-                localRightW.push_back(w);
+    X.visitColumn(bestFeat, [&](const auto* splitColumn) {
+        #pragma omp parallel
+        {
+            std::vector<int> localLeftIdx, localRightIdx;
+            std::vector<double> localLeftW, localRightW;
+            localLeftIdx.reserve(m / 4 + 1);
+            localRightIdx.reserve(m / 4 + 1);
+            localLeftW.reserve(m / 4 + 1);
+            localRightW.reserve(m / 4 + 1);
+
+            #pragma omp for schedule(dynamic)
+            for (size_t i = 0; i < m; ++i) {
+                int idx = leafInfo.sampleIndices[i];
+                double value = splitColumn[idx];
+                double w = (i < sampleWeights.size()) ? sampleWeights[i] : 1.0;
+                if (value <= bestThresh) {
+                    localLeftIdx.push_back(idx);
+                    localLeftW.push_back(w);
+                } else {
+                    localRightIdx.push_back(idx);
+                    localRightW.push_back(w);
+                }
             }
-        }
 
-        #pragma omp critical
-        {
-            leftIndices_.insert(leftIndices_.end(), localLeftIdx.begin(), localLeftIdx.end());
-            leftWeights_.insert(leftWeights_.end(), localLeftW.begin(), localLeftW.end());
-            rightIndices_.insert(rightIndices_.end(), localRightIdx.begin(), localRightIdx.end());
-            rightWeights_.insert(rightWeights_.end(), localRightW.begin(), localRightW.end());
+            #pragma omp critical
+            {
+                leftIndices_.insert(leftIndices_.end(), localLeftIdx.begin(), localLeftIdx.end());
+                leftWeights_.insert(leftWeights_.end(), localLeftW.begin(), localLeftW.end());
+                rightIndices_.insert(rightIndices_.end(), localRightIdx.begin(), localRightIdx.end());
+                rightWeights_.insert(rightWeights_.end(), localRightW.begin(), localRightW.end());
+            }
         }
-    }
+    });
 
     // Left child node
     if (leftIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf)) {
@@ -269,16 +370,16 @@ void LeafwiseTreeBuilder::splitLeafParallel(LeafInfo& leafInfo,
         leftInfo.sampleIndices = leftIndices_;
         leftInfo.node->samples = leftIndices_.size();
         if (leftIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf) * 2 &&
-            findBestSplitParallel(data, rowLength, targets, leftInfo.sampleIndices, leftWeights_, leftInfo)) {
+            findBestSplitParallel(X, targets, leftInfo.sampleIndices, leftWeights_, leftInfo)) {
             // Thread-safe insertion: performed outside parallel region since findBestSplitParallel only determines, no insertion conflict
             leafQueue_.push(leftInfo);
         } else {
             double leftPred = computeLeafPredictionParallel(leftIndices_, targets, leftWeights_);
-            leftInfo.node->makeLeaf(leftPred);
+            makeLeaf(leftInfo.node, leftPred, leftIndices_);
         }
     } else {
         double leftPred = computeLeafPredictionParallel(leftIndices_, targets, leftWeights_);
-        leafInfo.node->leftChild->makeLeaf(leftPred);
+        makeLeaf(leafInfo.node->leftChild.get(), leftPred, leftIndices_);
     }
 
     // Right child node
@@ -288,15 +389,15 @@ void LeafwiseTreeBuilder::splitLeafParallel(LeafInfo& leafInfo,
         rightInfo.sampleIndices = rightIndices_;
         rightInfo.node->samples = rightIndices_.size();
         if (rightIndices_.size() >= static_cast<size_t>(config_.minDataInLeaf) * 2 &&
-            findBestSplitParallel(data, rowLength, targets, rightInfo.sampleIndices, rightWeights_, rightInfo)) {
+            findBestSplitParallel(X, targets, rightInfo.sampleIndices, rightWeights_, rightInfo)) {
             leafQueue_.push(rightInfo);
         } else {
             double rightPred = computeLeafPredictionParallel(rightIndices_, targets, rightWeights_);
-            rightInfo.node->makeLeaf(rightPred);
+            makeLeaf(rightInfo.node, rightPred, rightIndices_);
         }
     } else {
         double rightPred = computeLeafPredictionParallel(rightIndices_, targets, rightWeights_);
-        leafInfo.node->rightChild->makeLeaf(rightPred);
+        makeLeaf(leafInfo.node->rightChild.get(), rightPred, rightIndices_);
     }
 }
 
@@ -320,7 +421,7 @@ double LeafwiseTreeBuilder::computeLeafPredictionParallel(
     if (indices.empty()) return 0.0;
     double sum = 0.0, wsum = 0.0;
     size_t m = indices.size();
-    if (m >= 1000) {
+    if (m >= ParallelCalibration::cutoffs().reductionParallelMinSamples) {
         #pragma omp parallel for reduction(+:sum, wsum) schedule(static)
         for (size_t i = 0; i < m; ++i) {
             sum += targets[indices[i]] * weights[i];
@@ -343,7 +444,7 @@ void LeafwiseTreeBuilder::processRemainingLeavesSerial(
         LeafInfo leaf = leafQueue_.top();
         leafQueue_.pop();
         double leafPred = computeLeafPredictionSerial(leaf.sampleIndices, targets, sampleWeights);
-        leaf.node->makeLeaf(leafPred);
+        makeLeaf(leaf.node, leafPred, leaf.sampleIndices);
     }
 }
 
@@ -362,6 +463,6 @@ void LeafwiseTreeBuilder::processRemainingLeavesParallel(
     #pragma omp parallel for schedule(dynamic)
     for (size_t i = 0; i < m; ++i) {
         double leafPred = computeLeafPredictionParallel(rem[i].sampleIndices, targets, sampleWeights);
-        rem[i].node->makeLeaf(leafPred);
+        makeLeaf(rem[i].node, leafPred, rem[i].sampleIndices);
     }
 }
\ No newline at end of file
@@ -0,0 +1,186 @@
+// =============================================================================
+// src/lightgbm/tree/MPILeafSplitSync.cpp - Local histograms, vote, reduce elected
+// =============================================================================
+#include "lightgbm/tree/MPILeafSplitSync.hpp"
+#include "histogram/MPIQuantileSketch.hpp"
+#include <algorithm>
+#include <numeric>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+MPILeafSplitSync::MPILeafSplitSync(MPI_Comm comm, Mode mode, int topK, int maxBins)
+    : comm_(comm), mode_(mode), topK_(std::max(1, topK)), maxBins_(maxBins) {
+    MPI_Comm_size(comm_, &size_);
+}
+
+bool MPILeafSplitSync::parseMode(const std::string& name, Mode& mode) {
+    if (name == "data")   { mode = Mode::Data;   return true; }
+    if (name == "voting") { mode = Mode::Voting; return true; }
+    return false;
+}
+
+void MPILeafSplitSync::countBytes(std::uint64_t bytes) {
+    totalBytes_ += bytes;
+    if (!bytesPerTree_.empty()) bytesPerTree_.back() += bytes;
+}
+
+void MPILeafSplitSync::prepare(const std::vector<double>& data, std::size_t rows, int numFeatures) {
+    rows_ = rows;
+    numFeatures_ = numFeatures;
+    cuts_ = MPIQuantileSketch::computeCuts(comm_, data, rows, numFeatures, maxBins_);
+    MPIQuantileSketch::binColumns(cuts_, data, rows, bins_);
+    binOffset_ = MPIQuantileSketch::binOffsets(cuts_);
+    bytesPerTree_.clear();
+    totalBytes_ = 0;
+}
+
+void MPILeafSplitSync::beginTree() {
+    bytesPerTree_.push_back(0);
+}
+
+void MPILeafSplitSync::allreduceSum(double* values, int count) {
+    MPI_Allreduce(MPI_IN_PLACE, values, count, MPI_DOUBLE, MPI_SUM, comm_);
+    countBytes(static_cast<std::uint64_t>(count) * sizeof(double));
+}
+
+double MPILeafSplitSync::scanFeature(const LeafStats* h, int f, const LeafStats& stats,
+                                     double minCount, LeafSplit* split) const {
+    const int nb = binOffset_[f + 1] - binOffset_[f];
+    if (stats.count <= 0.0 || stats.weight <= 0.0) return 0.0;
+    const double parentScore = stats.weightedSum * stats.weightedSum / stats.weight;
+
+    double bestGain = 0.0;
+    LeafStats left;
+    // Splitting after the last bin would leave the right side empty
+    for (int b = 0; b + 1 < nb; ++b) {
+        left.count += h[b].count;
+        left.weight += h[b].weight;
+        left.weightedSum += h[b].weightedSum;
+        const LeafStats right{stats.count - left.count, stats.weight - left.weight,
+                              stats.weightedSum - left.weightedSum};
+        if (left.count < minCount || right.count < minCount) continue;
+        if (left.weight <= 0.0 || right.weight <= 0.0) continue;
+
+        // Weighted SSE reduction, normalized by the leaf's rows like the
+        // MSE-criterion finders of the single-process builder
+        const double gain = (left.weightedSum * left.weightedSum / left.weight +
+                             right.weightedSum * right.weightedSum / right.weight -
+                             parentScore) / stats.count;
+        if (gain > bestGain) {
+            bestGain = gain;
+            if (split) {
+                split->feature = f;
+                split->threshold = cuts_[f][b];
+                split->gain = gain;
+                split->left = left;
+                split->right = right;
+            }
+        }
+    }
+    return bestGain;
+}
+
+std::vector<int> MPILeafSplitSync::electFeatures(const LeafStats& localStats, double minLocalCount) {
+    // Local ranking on this process's rows only
+    std::vector<double> localGain(numFeatures_);
+    #pragma omp parallel for schedule(dynamic) if(numFeatures_ > 8)
+    for (int f = 0; f < numFeatures_; ++f) {
+        localGain[f] = scanFeature(&hist_[binOffset_[f]], f, localStats, minLocalCount, nullptr);
+    }
+    std::vector<int> order(numFeatures_);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return localGain[a] > localGain[b]; });
+
+    std::vector<int> votes(topK_, -1);
+    for (int k = 0; k < topK_ && k < numFeatures_; ++k) {
+        if (localGain[order[k]] > 0.0) votes[k] = order[k];
+    }
+    std::vector<int> allVotes(static_cast<size_t>(topK_) * size_);
+    MPI_Allgather(votes.data(), topK_, MPI_INT, allVotes.data(), topK_, MPI_INT, comm_);
+    countBytes(static_cast<std::uint64_t>(topK_) * sizeof(int));
+
+    // Global election: 2k most voted features, ties to the lower index
+    std::vector<int> tally(numFeatures_, 0);
+    for (const int f : allVotes) {
+        if (f >= 0) ++tally[f];
+    }
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return tally[a] > tally[b]; });
+    std::vector<int> elected;
+    for (int k = 0; k < 2 * topK_ && k < numFeatures_ && tally[order[k]] > 0; ++k) {
+        elected.push_back(order[k]);
+    }
+    std::sort(elected.begin(), elected.end());
+    return elected;
+}
+
+bool MPILeafSplitSync::findBestSplit(const std::vector<int>& indices,
+                                     const std::vector<double>& targets,
+                                     const std::vector<double>& weights,
+                                     const LeafStats& stats,
+                                     int minDataInLeaf,
+                                     LeafSplit& split) {
+    split = LeafSplit();
+    hist_.assign(binOffset_.back(), LeafStats());
+
+    // Local histograms of every feature: voting ranks them all, data mode
+    // reduces them all
+    #pragma omp parallel for schedule(dynamic) if(indices.size() > 2000)
+    for (int f = 0; f < numFeatures_; ++f) {
+        LeafStats* h = &hist_[binOffset_[f]];
+        const std::uint8_t* col = &bins_[static_cast<size_t>(f) * rows_];
+        for (size_t i = 0; i < indices.size(); ++i) {
+            const int r = indices[i];
+            LeafStats& slot = h[col[r]];
+            slot.count += 1.0;
+            slot.weight += weights[i];
+            slot.weightedSum += weights[i] * targets[r];
+        }
+    }
+
+    std::vector<int> elected;
+    if (mode_ == Mode::Voting) {
+        LeafStats localStats;
+        localStats.count = static_cast<double>(indices.size());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            localStats.weight += weights[i];
+            localStats.weightedSum += weights[i] * targets[indices[i]];
+        }
+        // minDataInLeaf scaled to this process's share of the leaf
+        const double share = stats.count > 0.0 ? localStats.count / stats.count : 0.0;
+        elected = electFeatures(localStats, std::max(1.0, minDataInLeaf * share));
+    } else {
+        elected.resize(numFeatures_);
+        std::iota(elected.begin(), elected.end(), 0);
+    }
+    if (elected.empty()) return false;
+
+    // Pack the elected features' bins, reduce, unpack in place
+    packed_.clear();
+    for (const int f : elected) {
+        for (int b = binOffset_[f]; b < binOffset_[f + 1]; ++b) {
+            packed_.push_back(hist_[b].count);
+            packed_.push_back(hist_[b].weight);
+            packed_.push_back(hist_[b].weightedSum);
+        }
+    }
+    allreduceSum(packed_.data(), static_cast<int>(packed_.size()));
+    size_t pos = 0;
+    for (const int f : elected) {
+        for (int b = binOffset_[f]; b < binOffset_[f + 1]; ++b, pos += 3) {
+            hist_[b] = {packed_[pos], packed_[pos + 1], packed_[pos + 2]};
+        }
+    }
+
+    // Global search over the elected features, in index order
+    for (const int f : elected) {
+        LeafSplit candidate;
+        const double gain = scanFeature(&hist_[binOffset_[f]], f, stats,
+                                        static_cast<double>(minDataInLeaf), &candidate);
+        if (gain > split.gain) split = candidate;
+    }
+    return split.feature >= 0;
+}
@@ -1,4 +1,5 @@
 #include "pipeline/DataSplit.hpp"
+#include <cstddef>
 
 bool splitDataset(const std::vector<double>& X,
                   const std::vector<double>& y,
@@ -15,4 +16,17 @@ bool splitDataset(const std::vector<double>& X,
     out.X_test.assign(X.begin() + trainRows * feat, X.end());
     out.y_test.assign(y.begin() + trainRows, y.end());
     return true;
-}
\ No newline at end of file
+}
+
+void holdOutValidation(DataParams& dp,
+                       double fraction,
+                       std::vector<double>& X_val,
+                       std::vector<double>& y_val) {
+    const size_t trainRows = dp.y_train.size();
+    const size_t valRows = static_cast<size_t>(trainRows * fraction);
+    const size_t keep = trainRows - valRows;
+    X_val.assign(dp.X_train.begin() + keep * dp.rowLength, dp.X_train.end());
+    y_val.assign(dp.y_train.begin() + keep, dp.y_train.end());
+    dp.X_train.resize(keep * dp.rowLength);
+    dp.y_train.resize(keep);
+}
@@ -1,5 +1,6 @@
 // src/tree/criterion/MSECriterion.cpp - OpenMP Parallel Version
 #include "criterion/MSECriterion.hpp"
+#include <algorithm>
 #include <numeric>
 #include <cmath>
 #ifdef _OPENMP
@@ -29,3 +30,31 @@ double MSECriterion::nodeMetric(const std::vector<double>& labels,
     // Ensure non-negative due to precision
     return std::max(0.0, mse);
 }
+
+
+double MSECriterion::nodeMetric(const std::vector<double>& labels,
+                                const std::vector<int>& indices,
+                                const std::vector<int>& counts) const {
+    if (indices.empty()) return 0.0;
+
+    size_t n = indices.size();
+
+    double sum = 0.0;
+    double sumSq = 0.0;
+    double weight = 0.0;
+    #pragma omp parallel for reduction(+:sum,sumSq,weight) schedule(static) if(n > 1000)
+    for (size_t i = 0; i < n; ++i) {
+        const int idx = indices[i];
+        const double w = counts[idx];
+        const double y = labels[idx];
+        sum += w * y;
+        sumSq += w * y * y;
+        weight += w;
+    }
+    if (weight <= 0.0) return 0.0;
+
+    double mean = sum / weight;
+    double mse = sumSq / weight - mean * mean;
+
+    return std::max(0.0, mse);
+}
@@ -2,6 +2,9 @@
 // src/tree/ensemble/BaggingTrainer.cpp - Optimized Version (avoiding vector copy and new)
 // =============================================================================
 #include "ensemble/BaggingTrainer.hpp"
+#include "ensemble/ForestHistogramBuilder.hpp"
+#include "ensemble/PermutationImportance.hpp"
+#include "functions/random/CounterRng.hpp"
 
 // Criteria
 #include "criterion/MSECriterion.hpp"
@@ -14,6 +17,7 @@
 // Split Finders
 #include "finder/ExhaustiveSplitFinder.hpp"
 #include "finder/RandomSplitFinder.hpp"
+#include "finder/ExtraTreesSplitFinder.hpp"
 #include "finder/QuartileSplitFinder.hpp"
 #include "finder/HistogramEWFinder.hpp"
 #include "finder/HistogramEQFinder.hpp"
@@ -55,13 +59,13 @@ BaggingTrainer::BaggingTrainer(int numTrees,
       splitMethod_(splitMethod),
       prunerType_(prunerType),
       prunerParam_(prunerParam),
-      gen_(seed) {
+      seed_(seed) {
     
     trees_.reserve(numTrees_);
     oobIndices_.reserve(numTrees_);
 }
 
-std::unique_ptr<ISplitFinder> BaggingTrainer::createSplitFinder() const {
+std::unique_ptr<ISplitFinder> BaggingTrainer::createSplitFinder(int treeId) const {
     const std::string& method = splitMethod_;
     
     if (method == "exhaustive" || method == "exact") {
@@ -73,7 +77,18 @@ std::unique_ptr<ISplitFinder> BaggingTrainer::createSplitFinder() const {
         if (pos != std::string::npos) {
             k = std::stoi(method.substr(pos + 1));
         }
-        return std::make_unique<RandomSplitFinder>(k);
+        // Per-tree threshold seed, independent of the thread growing the tree
+        CounterRng rng(seed_, RngPurpose::SplitThreshold, treeIdOffset_ + treeId);
+        return std::make_unique<RandomSplitFinder>(k, rng());
+    }
+    else if (method == "extra" || method.find("extra:") == 0) {
+        int k = 1;
+        const auto pos = method.find(':');
+        if (pos != std::string::npos) {
+            k = std::stoi(method.substr(pos + 1));
+        }
+        CounterRng rng(seed_, RngPurpose::SplitThreshold, treeIdOffset_ + treeId);
+        return std::make_unique<ExtraTreesSplitFinder>(k, rng());
     }
     else if (method == "quartile") {
         return std::make_unique<QuartileSplitFinder>();
@@ -152,65 +167,54 @@ std::unique_ptr<IPruner> BaggingTrainer::createPruner(const std::vector<double>&
     }
 }
 
-// Optimized Bootstrap sampling: avoids vector copies
-void BaggingTrainer::bootstrapSample(int dataSize,
-                                     std::vector<int>& sampleIndices,
+// Bootstrap sampling as multiplicities: no sample index list, no row copies
+void BaggingTrainer::bootstrapCounts(int dataSize,
+                                     std::vector<int>& counts,
                                      std::vector<int>& oobIndices,
-                                     std::mt19937& localGen) const {
+                                     int treeId) const {
     const int sampleSize = static_cast<int>(dataSize * sampleRatio_);
     
-    // Pre-allocate to exact size to prevent reallocations
-    sampleIndices.clear();
-    sampleIndices.reserve(sampleSize);
-    
-    // Use a bitmap for efficient sampling status tracking
-    std::vector<bool> sampledBits(dataSize, false);
+    counts.assign(dataSize, 0);
     
     // Perform bootstrap sampling (sampling with replacement)
-    std::uniform_int_distribution<int> dist(0, dataSize - 1);
+    CounterRng rng(seed_, RngPurpose::Bootstrap, treeIdOffset_ + treeId);
     for (int i = 0; i < sampleSize; ++i) {
-        const int idx = dist(localGen);
-        sampleIndices.push_back(idx);
-        sampledBits[idx] = true;
+        ++counts[rng.below(static_cast<uint32_t>(dataSize))];
     }
     
     // Identify out-of-bag samples
     oobIndices.clear();
     oobIndices.reserve(dataSize - sampleSize);
     for (int i = 0; i < dataSize; ++i) {
-        if (!sampledBits[i]) {
+        if (counts[i] == 0) {
             oobIndices.push_back(i);
         }
     }
 }
 
-// Zero-copy data passing: uses references and move semantics
-void BaggingTrainer::extractSubsetOptimized(const std::vector<double>& originalData,
-                                           int rowLength,
-                                           const std::vector<double>& originalLabels,
-                                           const std::vector<int>& indices,
-                                           std::vector<double>& subData,
-                                           std::vector<double>& subLabels) const {
-    
-    const int featCount = rowLength;
-    const size_t totalSize = indices.size() * featCount;
-    
-    // Pre-allocate exact size to prevent reallocations
-    subData.resize(totalSize);
-    subLabels.resize(indices.size());
-    
-    // Optimized bulk copy for better cache locality
-    #pragma omp parallel for schedule(static) if(indices.size() > 500)
-    for (size_t i = 0; i < indices.size(); ++i) {
-        const int idx = indices[i];
-        
-        // Use contiguous memory copy optimization
-        const double* srcStart = &originalData[idx * featCount];
-        double* dstStart = &subData[i * featCount];
-        std::copy(srcStart, srcStart + featCount, dstStart);
-        
-        subLabels[i] = originalLabels[idx];
+std::unique_ptr<SingleTreeTrainer> BaggingTrainer::growTree(int treeId,
+                                                            const FeatureMatrix& X,
+                                                            const std::vector<double>& labels,
+                                                            const PresortedIndex& presort,
+                                                            std::vector<int>& counts,
+                                                            std::vector<int>& oobIndices) const {
+    bootstrapCounts(static_cast<int>(labels.size()), counts, oobIndices, treeId);
+    
+    // Pruner is created without validation data here
+    auto tree = std::make_unique<SingleTreeTrainer>(
+        createSplitFinder(treeId),
+        createCriterion(),
+        createPruner({}, X.numFeatures(), {}),
+        maxDepth_,
+        minSamplesLeaf_
+    );
+    
+    if (presort.empty()) {
+        tree->train(X, labels, counts);
+    } else {
+        tree->train(X, labels, counts, presort);
     }
+    return tree;
 }
 
 void BaggingTrainer::train(const std::vector<double>& data,
@@ -218,6 +222,7 @@ void BaggingTrainer::train(const std::vector<double>& data,
                           const std::vector<double>& labels) {
     trees_.clear();
     oobIndices_.clear();
+    oobCurve_.clear();
     
     const int dataSize = static_cast<int>(labels.size());
     
@@ -246,67 +251,132 @@ void BaggingTrainer::train(const std::vector<double>& data,
     trees_.resize(numTrees_);
     oobIndices_.resize(numTrees_);
     
+    oobSum_.assign(dataSize, 0.0);
+    oobCount_.assign(dataSize, 0);
+    
     // Atomic counter for thread-safe progress tracking
     std::atomic<int> completedTrees(0);
     
-    // Core: Parallel training of multiple trees, avoiding vector copies
-    #pragma omp parallel if(numTrees_ > 1)
-    {
-        // Thread-local random number generator
-        thread_local std::mt19937 localGen;
-        thread_local bool initialized = false;
-        if (!initialized) {
+    // One shared column-major matrix; each tree sees it through row counts
+    const FeatureMatrix X(data, rowLength);
+    
+    const bool forest = splitMethod_ == "forest" || splitMethod_.rfind("forest:", 0) == 0;
+    // The forest builder only minimises weighted MSE
+    if (forest && criterion_ != "mse") {
+        std::cerr << "Warning: split method '" << splitMethod_ << "' supports only the mse "
+                  << "criterion; growing " << criterion_ << " trees one by one with exhaustive splits"
+                  << std::endl;
+    }
+    else if (forest) {
+        trainForest(X, data, rowLength, labels);
+        treeIds_.resize(trees_.size());
+        std::iota(treeIds_.begin(), treeIds_.end(), treeIdOffset_);
+        shuffleTreeOrder();
+        std::cout << "Bagging training completed!" << std::endl;
+        return;
+    }
+    
+    // Sort-based finders: sort every feature once for the whole forest; each
+    // replica filters this order by its counts and its trees never sort
+    PresortedIndex presort;
+    if (createSplitFinder()->usesSortedOrder()) {
+        presort = PresortedIndex(X);
+    }
+    
+    // Per-thread OOB buffers: each tree adds its OOB predictions as soon as
+    // it is grown, and waves are merged row-parallel without atomics
+    #ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+    #else
+    const int maxThreads = 1;
+    #endif
+    std::vector<std::vector<double>> threadSum(maxThreads, std::vector<double>(dataSize, 0.0));
+    std::vector<std::vector<int>> threadCount(maxThreads, std::vector<int>(dataSize, 0));
+    
+    // Without stopping the whole forest is one wave. With stopping a wave is
+    // still wide enough to keep every thread busy (whole windows, at least
+    // maxThreads trees); the stopping rule is then checked window by window
+    // inside it, so the result is the same as growing one window at a time.
+    const bool stopping = oobStopTol_ > 0.0;
+    const int wave = stopping
+        ? oobWindow_ * ((std::max(oobWindow_, maxThreads) + oobWindow_ - 1) / oobWindow_)
+        : numTrees_;
+    int grown = numTrees_;
+    
+    for (int first = 0; first < numTrees_ && grown == numTrees_; first += wave) {
+        const int last = std::min(numTrees_, first + wave);
+        
+        // Core: Parallel training of multiple trees, avoiding vector copies
+        #pragma omp parallel if(last - first > 1)
+        {
             #ifdef _OPENMP
-            const int threadId = omp_get_thread_num();
-            localGen.seed(gen_() + threadId * 1000);
+            const int tid = omp_get_thread_num();
             #else
-            localGen.seed(gen_());
+            const int tid = 0;
             #endif
-            initialized = true;
+            // Thread-local buffers: N ints per thread instead of an N x D copy
+            std::vector<int> counts, oobIndices;
+            
+            #pragma omp for schedule(dynamic, 1)
+            for (int t = first; t < last; ++t) {
+                auto tree = growTree(t, X, labels, presort, counts, oobIndices);
+                
+                // Thread-safe storage of results
+                trees_[t] = std::move(tree);
+                oobIndices_[t] = std::move(oobIndices);
+                // With stopping, OOB rows are added per window below
+                if (!stopping) {
+                    addOOBPredictions(t, data, rowLength, threadSum[tid], threadCount[tid]);
+                }
+                
+                // Thread-safe progress output
+                const int completed = ++completedTrees;
+                if (completed % std::max(1, numTrees_ / 10) == 0) {
+                    #pragma omp critical(progress_output)
+                    {
+                        std::cout << "Completed " << completed << "/" << numTrees_ 
+                                  << " trees (" << std::fixed << std::setprecision(1) 
+                                  << 100.0 * completed / numTrees_ << "%)" << std::endl;
+                        std::cout.flush();
+                    }
+                }
+            }
         }
         
-        // Thread-local data buffers to avoid repeated allocations
-        std::vector<int> sampleIndices, oobIndices;
-        std::vector<double> subData, subLabels;
+        if (!stopping) {
+            mergeOOBWave(threadSum, threadCount, labels);
+            continue;
+        }
         
-        #pragma omp for schedule(dynamic, 1)
-        for (int t = 0; t < numTrees_; ++t) {
-            // Bootstrap sampling
-            bootstrapSample(dataSize, sampleIndices, oobIndices, localGen);
-            
-            // Efficient data extraction, avoiding unnecessary copies
-            extractSubsetOptimized(data, rowLength, labels, sampleIndices, 
-                                  subData, subLabels);
-            
-            // Create a single tree using smart pointers for memory management
-            auto tree = std::make_unique<SingleTreeTrainer>(
-                createSplitFinder(),
-                createCriterion(),
-                createPruner({}, rowLength, {}), // Pruner needs to be created without validation data here
-                maxDepth_,
-                minSamplesLeaf_
-            );
-            
-            tree->train(subData, rowLength, subLabels);
-            
-            // Thread-safe storage of results
-            trees_[t] = std::move(tree);
-            oobIndices_[t] = std::move(oobIndices);
-            
-            // Thread-safe progress output
-            const int completed = ++completedTrees;
-            if (completed % std::max(1, numTrees_ / 10) == 0) {
-                #pragma omp critical(progress_output)
-                {
-                    std::cout << "Completed " << completed << "/" << numTrees_ 
-                              << " trees (" << std::fixed << std::setprecision(1) 
-                              << 100.0 * completed / numTrees_ << "%)" << std::endl;
-                    std::cout.flush();
-                }
+        for (int begin = first; begin < last; begin += oobWindow_) {
+            const int end = std::min(last, begin + oobWindow_);
+            #pragma omp parallel for schedule(dynamic, 1) if(end - begin > 1)
+            for (int t = begin; t < end; ++t) {
+                #ifdef _OPENMP
+                const int tid = omp_get_thread_num();
+                #else
+                const int tid = 0;
+                #endif
+                addOOBPredictions(t, data, rowLength, threadSum[tid], threadCount[tid]);
+            }
+            if (mergeOOBWave(threadSum, threadCount, labels) && end < numTrees_) {
+                grown = end;   // Trees grown past this window are dropped
+                break;
             }
         }
     }
     
+    if (grown < numTrees_) {
+        trees_.resize(grown);
+        oobIndices_.resize(grown);
+        std::cout << "OOB error flattened: stopped at " << grown << "/" << numTrees_
+                  << " trees (OOB MSE " << std::fixed << std::setprecision(6)
+                  << oobCurve_.back() << ")" << std::endl;
+    }
+    
+    treeIds_.resize(trees_.size());
+    std::iota(treeIds_.begin(), treeIds_.end(), treeIdOffset_);
+    shuffleTreeOrder();
     std::cout << "Bagging training completed!" << std::endl;
     
     #ifdef _OPENMP
@@ -314,6 +384,227 @@ void BaggingTrainer::train(const std::vector<double>& data,
     #endif
 }
 
+void BaggingTrainer::trainDynamic(const std::vector<double>& data,
+                                  int rowLength,
+                                  const std::vector<double>& labels,
+                                  const TreeChunkSource& next) {
+    trees_.clear();
+    oobIndices_.clear();
+    oobCurve_.clear();
+    treeIds_.clear();
+    
+    const int dataSize = static_cast<int>(labels.size());
+    if (dataSize == 0 || rowLength <= 0 || static_cast<int>(data.size()) != dataSize * rowLength) {
+        std::cerr << "Error: Invalid training data" << std::endl;
+        return;
+    }
+    
+    oobSum_.assign(dataSize, 0.0);
+    oobCount_.assign(dataSize, 0);
+    
+    const FeatureMatrix X(data, rowLength);
+    PresortedIndex presort;
+    if (createSplitFinder()->usesSortedOrder()) {
+        presort = PresortedIndex(X);
+    }
+    
+    #ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+    #else
+    const int maxThreads = 1;
+    #endif
+    std::vector<std::vector<double>> threadSum(maxThreads, std::vector<double>(dataSize, 0.0));
+    std::vector<std::vector<int>> threadCount(maxThreads, std::vector<int>(dataSize, 0));
+    
+    int first = 0, count = 0;
+    while (next(first, count)) {
+        const int base = static_cast<int>(trees_.size());
+        trees_.resize(base + count);
+        oobIndices_.resize(base + count);
+        for (int k = 0; k < count; ++k) treeIds_.push_back(first + k);
+        
+        #pragma omp parallel if(count > 1)
+        {
+            #ifdef _OPENMP
+            const int tid = omp_get_thread_num();
+            #else
+            const int tid = 0;
+            #endif
+            std::vector<int> counts;
+            
+            #pragma omp for schedule(dynamic, 1)
+            for (int k = 0; k < count; ++k) {
+                // Streams are keyed by treeIdOffset_ + id; this makes the key
+                // the global id handed out
+                trees_[base + k] = growTree(first + k - treeIdOffset_, X, labels, presort,
+                                            counts, oobIndices_[base + k]);
+                addOOBPredictions(base + k, data, rowLength, threadSum[tid], threadCount[tid]);
+            }
+        }
+    }
+    
+    mergeOOBWave(threadSum, threadCount, labels);
+    shuffleTreeOrder();
+}
+
+void BaggingTrainer::trainForest(const FeatureMatrix& X,
+                                 const std::vector<double>& data,
+                                 int rowLength,
+                                 const std::vector<double>& labels) {
+    int bins = 64;
+    // Default batch: every tree that fits the builder's memory budget
+    int batch = std::min(numTrees_, ForestHistogramBuilder::maxBatch(labels.size()));
+    const auto pos = splitMethod_.find(':');
+    if (pos != std::string::npos) {
+        const auto pos2 = splitMethod_.find(':', pos + 1);
+        bins = std::stoi(splitMethod_.substr(pos + 1, pos2 - pos - 1));
+        if (pos2 != std::string::npos) {
+            batch = std::max(1, std::stoi(splitMethod_.substr(pos2 + 1)));
+        }
+    }
+    // With OOB stopping a batch is one wave
+    if (oobStopTol_ > 0.0) batch = std::min(batch, oobWindow_);
+    
+    double minGain = 0.0;
+    if (prunerType_ == "mingain") minGain = prunerParam_;
+    const ForestHistogramBuilder builder(bins, maxDepth_, minSamplesLeaf_, minGain);
+    
+    std::cout << "Forest-synchronous histogram build: " << bins << " bins, "
+              << batch << " trees per batch" << std::endl;
+    
+    // Same bootstrap draws as the per-tree path (streams are keyed by tree id)
+    const int dataSize = static_cast<int>(labels.size());
+    #ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+    #else
+    const int maxThreads = 1;
+    #endif
+    std::vector<std::vector<double>> threadSum(maxThreads, std::vector<double>(dataSize, 0.0));
+    std::vector<std::vector<int>> threadCount(maxThreads, std::vector<int>(dataSize, 0));
+    
+    for (int first = 0; first < numTrees_; first += batch) {
+        const int last = std::min(numTrees_, first + batch);
+        std::vector<std::vector<int>> counts(last - first);
+        for (int t = first; t < last; ++t) {
+            bootstrapCounts(dataSize, counts[t - first], oobIndices_[t], t);
+        }
+        
+        auto roots = builder.build(X, labels, counts);
+        
+        for (int t = first; t < last; ++t) {
+            auto tree = std::make_unique<SingleTreeTrainer>(
+                createSplitFinder(t), createCriterion(),
+                createPruner({}, X.numFeatures(), {}),
+                maxDepth_, minSamplesLeaf_);
+            tree->root_ = std::move(roots[t - first]);
+            tree->pruner_->prune(tree->root_);
+            trees_[t] = std::move(tree);
+        }
+        
+        #pragma omp parallel for schedule(dynamic, 1) if(last - first > 1)
+        for (int t = first; t < last; ++t) {
+            #ifdef _OPENMP
+            const int tid = omp_get_thread_num();
+            #else
+            const int tid = 0;
+            #endif
+            addOOBPredictions(t, data, rowLength, threadSum[tid], threadCount[tid]);
+        }
+        std::cout << "Completed " << last << "/" << numTrees_ << " trees" << std::endl;
+        
+        if (mergeOOBWave(threadSum, threadCount, labels) && last < numTrees_) {
+            trees_.resize(last);
+            oobIndices_.resize(last);
+            std::cout << "OOB error flattened: stopped at " << last << "/" << numTrees_
+                      << " trees (OOB MSE " << std::fixed << std::setprecision(6)
+                      << oobCurve_.back() << ")" << std::endl;
+            break;
+        }
+    }
+}
+
+void BaggingTrainer::addOOBPredictions(int t,
+                                       const std::vector<double>& data,
+                                       int rowLength,
+                                       std::vector<double>& sum,
+                                       std::vector<int>& count) const {
+    const SingleTreeTrainer& tree = *trees_[t];
+    for (const int idx : oobIndices_[t]) {
+        sum[idx] += tree.predict(&data[static_cast<size_t>(idx) * rowLength], rowLength);
+        ++count[idx];
+    }
+}
+
+void BaggingTrainer::accumulateOOB(const std::vector<double>& data,
+                                   int rowLength,
+                                   int dataSize,
+                                   std::vector<double>& sum,
+                                   std::vector<int>& count) const {
+    #ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+    #else
+    const int maxThreads = 1;
+    #endif
+    const int numTrees = static_cast<int>(trees_.size());
+    const int numBuffers = std::max(1, std::min(maxThreads, numTrees));
+    std::vector<std::vector<double>> threadSum(numBuffers, std::vector<double>(dataSize, 0.0));
+    std::vector<std::vector<int>> threadCount(numBuffers, std::vector<int>(dataSize, 0));
+    
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(numBuffers) if(numTrees > 1)
+    for (int t = 0; t < numTrees; ++t) {
+        #ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+        #else
+        const int tid = 0;
+        #endif
+        if (trees_[t]) addOOBPredictions(t, data, rowLength, threadSum[tid], threadCount[tid]);
+    }
+    
+    sum.assign(dataSize, 0.0);
+    count.assign(dataSize, 0);
+    #pragma omp parallel for schedule(static) if(dataSize > 10000)
+    for (int i = 0; i < dataSize; ++i) {
+        for (int b = 0; b < numBuffers; ++b) {
+            sum[i] += threadSum[b][i];
+            count[i] += threadCount[b][i];
+        }
+    }
+}
+
+bool BaggingTrainer::mergeOOBWave(std::vector<std::vector<double>>& threadSum,
+                                  std::vector<std::vector<int>>& threadCount,
+                                  const std::vector<double>& labels) {
+    const int dataSize = static_cast<int>(oobSum_.size());
+    const int numBuffers = static_cast<int>(threadSum.size());
+    double oobMSE = 0.0;
+    int validCount = 0;
+    
+    // Each row is owned by one iteration, so buffers fold in without atomics
+    #pragma omp parallel for reduction(+:oobMSE,validCount) schedule(static) if(dataSize > 10000)
+    for (int i = 0; i < dataSize; ++i) {
+        for (int b = 0; b < numBuffers; ++b) {
+            oobSum_[i] += threadSum[b][i];
+            oobCount_[i] += threadCount[b][i];
+            threadSum[b][i] = 0.0;
+            threadCount[b][i] = 0;
+        }
+        if (oobCount_[i] > 0) {
+            const double diff = labels[i] - oobSum_[i] / oobCount_[i];
+            oobMSE += diff * diff;
+            ++validCount;
+        }
+    }
+    oobCurve_.push_back(validCount > 0 ? oobMSE / validCount : 0.0);
+    
+    // Flat: the last two waves each improved by less than the tolerance
+    if (oobStopTol_ <= 0.0 || oobCurve_.size() < 3) return false;
+    const size_t k = oobCurve_.size() - 1;
+    auto flat = [&](size_t j) {
+        return oobCurve_[j - 1] - oobCurve_[j] < oobStopTol_ * oobCurve_[j - 1];
+    };
+    return flat(k) && flat(k - 1);
+}
+
 double BaggingTrainer::predict(const double* sample, int rowLength) const {
     if (trees_.empty()) return 0.0;
     
@@ -330,6 +621,104 @@ double BaggingTrainer::predict(const double* sample, int rowLength) const {
     return sum / trees_.size();
 }
 
+void BaggingTrainer::shuffleTreeOrder() {
+    treeOrder_.resize(trees_.size());
+    std::iota(treeOrder_.begin(), treeOrder_.end(), 0);
+    CounterRng rng(seed_, RngPurpose::TreeOrder, static_cast<uint32_t>(treeIdOffset_));
+    rng.shuffle(treeOrder_.begin(), treeOrder_.end());
+}
+
+namespace {
+
+// Welford running mean/variance of the tree predictions seen so far
+struct RunningMean {
+    int    n    = 0;
+    double mean = 0.0;
+    double m2   = 0.0;
+    
+    void add(double x) {
+        ++n;
+        const double d = x - mean;
+        mean += d / n;
+        m2 += d * (x - mean);
+    }
+    // Estimated variance of the mean: s^2 / n
+    double meanVariance() const { return n > 1 ? m2 / (n - 1) / n : 0.0; }
+};
+
+} // namespace
+
+AnytimePrediction BaggingTrainer::predictAnytime(const double* sample,
+                                                 int rowLength,
+                                                 const AnytimeOptions& options) const {
+    AnytimePrediction result;
+    const int T = static_cast<int>(treeOrder_.size());
+    if (T == 0) return result;
+    
+    const int budget = options.maxTrees > 0 ? std::min(options.maxTrees, T) : T;
+    const int minTrees = std::max(2, options.minTrees);
+    const double tol2 = options.tolerance * options.tolerance;
+    
+    RunningMean acc;
+    for (int k = 0; k < budget; ++k) {
+        acc.add(trees_[treeOrder_[k]]->predict(sample, rowLength));
+        if (acc.n >= minTrees && acc.meanVariance() <= tol2) break;
+    }
+    result.prediction = acc.mean;
+    result.treesUsed  = acc.n;
+    result.variance   = acc.meanVariance();
+    return result;
+}
+
+std::vector<AnytimePrediction> BaggingTrainer::predictAnytime(const std::vector<double>& X,
+                                                              int rowLength,
+                                                              const AnytimeOptions& options) const {
+    const size_t n = rowLength > 0 ? X.size() / rowLength : 0;
+    std::vector<AnytimePrediction> results(n);
+    const int T = static_cast<int>(treeOrder_.size());
+    if (n == 0 || T == 0) return results;
+    
+    const int budget = options.maxTrees > 0 ? std::min(options.maxTrees, T) : T;
+    const int minTrees = std::max(2, options.minTrees);
+    const double tol2 = options.tolerance * options.tolerance;
+    constexpr size_t BLOCK = 256;
+    const size_t numBlocks = (n + BLOCK - 1) / BLOCK;
+    
+    // Tree-major within a block: one tree is applied to all still-active rows
+    // before the next, and converged rows are compacted out, so a block stops
+    // as soon as its slowest row converges
+    #pragma omp parallel for schedule(dynamic) if(numBlocks > 1)
+    for (size_t b = 0; b < numBlocks; ++b) {
+        const size_t begin = b * BLOCK;
+        const size_t end = std::min(n, begin + BLOCK);
+        RunningMean acc[BLOCK];
+        int active[BLOCK];
+        int numActive = 0;
+        for (size_t i = begin; i < end; ++i) active[numActive++] = static_cast<int>(i - begin);
+        
+        for (int k = 0; k < budget && numActive > 0; ++k) {
+            const SingleTreeTrainer& tree = *trees_[treeOrder_[k]];
+            for (int a = 0; a < numActive; ++a) {
+                const int r = active[a];
+                acc[r].add(tree.predict(&X[(begin + r) * rowLength], rowLength));
+            }
+            if (k + 1 < minTrees) continue;
+            int kept = 0;
+            for (int a = 0; a < numActive; ++a) {
+                const int r = active[a];
+                if (acc[r].meanVariance() > tol2) active[kept++] = r;
+            }
+            numActive = kept;
+        }
+        
+        for (size_t i = begin; i < end; ++i) {
+            const RunningMean& a = acc[i - begin];
+            results[i] = {a.mean, a.n, a.meanVariance()};
+        }
+    }
+    return results;
+}
+
 void BaggingTrainer::evaluate(const std::vector<double>& X,
                              int rowLength,
                              const std::vector<double>& y,
@@ -412,36 +801,85 @@ std::vector<double> BaggingTrainer::getFeatureImportance(int numFeatures) const
     return importance;
 }
 
+EnsembleSelection BaggingTrainer::pruneEnsemble(const EnsemblePruner& pruner,
+                                                const std::vector<double>& X_val,
+                                                int rowLength,
+                                                const std::vector<double>& y_val) {
+    std::vector<const Node*> roots;
+    for (const auto& tree : trees_) roots.push_back(tree->getRoot());
+    EnsembleSelection sel = pruner.selectAveraging(roots, X_val, rowLength, y_val);
+    if (sel.trees.empty()) return sel;
+    
+    std::vector<std::unique_ptr<SingleTreeTrainer>> keptTrees;
+    std::vector<std::vector<int>> keptOOB;
+    std::vector<int> keptIds;
+    for (int t : sel.trees) {
+        keptTrees.push_back(std::move(trees_[t]));
+        keptOOB.push_back(std::move(oobIndices_[t]));
+        keptIds.push_back(treeIds_[t]);
+    }
+    trees_ = std::move(keptTrees);
+    oobIndices_ = std::move(keptOOB);
+    treeIds_ = std::move(keptIds);
+    shuffleTreeOrder();
+    
+    oobSum_.clear();
+    oobCount_.clear();
+    oobCurve_.clear();
+    return sel;
+}
+
+std::vector<double> BaggingTrainer::getPermutationImportance(const std::vector<double>& data,
+                                                             int rowLength,
+                                                             const std::vector<double>& labels) const {
+    if (trees_.empty()) {
+        std::cerr << "Error: permutation importance needs a trained forest" << std::endl;
+        return std::vector<double>(rowLength, 0.0);
+    }
+    
+    // Running sums are dropped when the forest is pruned; rebuild them then
+    std::vector<double> sum = oobSum_;
+    std::vector<int> count = oobCount_;
+    if (sum.size() != labels.size()) {
+        accumulateOOB(data, rowLength, static_cast<int>(labels.size()), sum, count);
+    }
+    
+    // Each tree scores its OOB rows; the prediction is their OOB average
+    PermutationImportance::Ensemble ensemble;
+    for (size_t t = 0; t < trees_.size(); ++t) {
+        ensemble.trees.push_back(trees_[t]->getRoot());
+        ensemble.treeWeights.push_back(1.0);
+        ensemble.treeRows.push_back(&oobIndices_[t]);
+    }
+    const size_t n = labels.size();
+    ensemble.rowScale.assign(n, 0.0);
+    std::vector<double> basePred(n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        if (count[i] > 0) {
+            ensemble.rowScale[i] = 1.0 / count[i];
+            basePred[i] = sum[i] / count[i];
+        }
+    }
+    return PermutationImportance::compute(ensemble, data, rowLength, labels, basePred, seed_);
+}
+
 // Batch OOB computation: avoids vector copies
 double BaggingTrainer::getOOBError(const std::vector<double>& data,
                                   int rowLength,
-                                  const std::vector<double>& labels) const {
+                                  const std::vector<double>& labels,
+                                  bool trainingSet) const {
     if (trees_.empty() || oobIndices_.empty()) return 0.0;
     
-    const int dataSize = static_cast<int>(labels.size());
-    std::vector<double> oobPredictions(dataSize, 0.0);
-    std::vector<int> oobCounts(dataSize, 0);
-    
-    // Parallel computation of all OOB predictions
-    #pragma omp parallel for schedule(static) if(trees_.size() > 10)
-    for (size_t t = 0; t < trees_.size(); ++t) {
-        if (!trees_[t]) continue;
-        
-        const auto& oobSet = oobIndices_[t];
-        
-        // Predict for the current tree's OOB samples
-        for (const int idx : oobSet) {
-            const double pred = trees_[t]->predict(&data[idx * rowLength], rowLength);
-            
-            // Thread-safe accumulation
-            #pragma omp atomic
-            oobPredictions[idx] += pred;
-            
-            #pragma omp atomic
-            oobCounts[idx]++;
-        }
+    // Training set: the running sums are already complete
+    if (trainingSet && !oobCurve_.empty() && labels.size() == oobSum_.size()) {
+        return oobCurve_.back();
     }
     
+    const int dataSize = static_cast<int>(labels.size());
+    std::vector<double> oobPredictions;
+    std::vector<int> oobCounts;
+    accumulateOOB(data, rowLength, dataSize, oobPredictions, oobCounts);
+    
     // Calculate OOB error
     double oobMSE = 0.0;
     int validCount = 0;
@@ -458,11 +896,3 @@ double BaggingTrainer::getOOBError(const std::vector<double>& data,
     
     return validCount > 0 ? oobMSE / validCount : 0.0;
 }
-
-// Compatibility method (retains old interface)
-void BaggingTrainer::bootstrapSample(int dataSize,
-                                     std::vector<int>& sampleIndices,
-                                     std::vector<int>& oobIndices) const {
-    thread_local std::mt19937 localGen(gen_());
-    bootstrapSample(dataSize, sampleIndices, oobIndices, localGen);
-}
\ No newline at end of file
@@ -0,0 +1,294 @@
+// =============================================================================
+// src/tree/ensemble/EnsemblePruner.cpp - Greedy / OMP ensemble selection
+// =============================================================================
+#include "ensemble/EnsemblePruner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+double treeOutput(const Node* node, const double* x) {
+    while (node && !node->isLeaf) {
+        node = (x[node->getFeatureIndex()] <= node->getThreshold()) ? node->getLeft() : node->getRight();
+    }
+    return node ? node->getPrediction() : 0.0;
+}
+
+// Solves (G + ridge * I) c = b for symmetric positive semi-definite G (k x k,
+// row-major) by Cholesky; the small ridge keeps near-duplicate trees solvable
+std::vector<double> solveNormal(std::vector<double> G, std::vector<double> b, int k) {
+    double trace = 0.0;
+    for (int i = 0; i < k; ++i) trace += G[i * k + i];
+    const double ridge = 1e-10 * (trace > 0.0 ? trace / k : 1.0);
+    for (int i = 0; i < k; ++i) G[i * k + i] += ridge;
+
+    for (int j = 0; j < k; ++j) {
+        double d = G[j * k + j];
+        for (int p = 0; p < j; ++p) d -= G[j * k + p] * G[j * k + p];
+        d = std::sqrt(std::max(d, ridge));
+        G[j * k + j] = d;
+        for (int i = j + 1; i < k; ++i) {
+            double s = G[i * k + j];
+            for (int p = 0; p < j; ++p) s -= G[i * k + p] * G[j * k + p];
+            G[i * k + j] = s / d;
+        }
+    }
+    for (int i = 0; i < k; ++i) {          // L z = b
+        for (int p = 0; p < i; ++p) b[i] -= G[i * k + p] * b[p];
+        b[i] /= G[i * k + i];
+    }
+    for (int i = k - 1; i >= 0; --i) {     // L^T c = z
+        for (int p = i + 1; p < k; ++p) b[i] -= G[p * k + i] * b[p];
+        b[i] /= G[i * k + i];
+    }
+    return b;
+}
+
+} // namespace
+
+EnsemblePruner::EnsemblePruner(Method method, double tolerance, int maxTrees)
+    : method_(method), tolerance_(std::max(0.0, tolerance)), maxTrees_(maxTrees) {}
+
+EnsemblePruner::Method EnsemblePruner::parseMethod(const std::string& name) {
+    return name == "omp" ? Method::OMP : Method::Greedy;
+}
+
+std::vector<double> EnsemblePruner::cachePredictions(const std::vector<const Node*>& trees,
+                                                     const std::vector<double>& X,
+                                                     int rowLength,
+                                                     size_t n) {
+    const int T = static_cast<int>(trees.size());
+    std::vector<double> P(static_cast<size_t>(T) * n);
+    #pragma omp parallel for schedule(dynamic) if(T > 1)
+    for (int t = 0; t < T; ++t) {
+        double* out = &P[static_cast<size_t>(t) * n];
+        for (size_t i = 0; i < n; ++i) out[i] = treeOutput(trees[t], &X[i * rowLength]);
+    }
+    return P;
+}
+
+EnsembleSelection EnsemblePruner::selectAdditive(const std::vector<const Node*>& trees,
+                                                 const std::vector<double>& factors,
+                                                 double baseScore,
+                                                 const std::vector<double>& X_val,
+                                                 int rowLength,
+                                                 const std::vector<double>& y_val) const {
+    const int T = static_cast<int>(trees.size());
+    const size_t n = y_val.size();
+    EnsembleSelection sel;
+    sel.baseScore = baseScore;
+    if (T == 0 || n == 0) return sel;
+
+    const std::vector<double> P = cachePredictions(trees, X_val, rowLength, n);
+
+    double full = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double pred = baseScore;
+        for (int t = 0; t < T; ++t) pred += factors[t] * P[static_cast<size_t>(t) * n + i];
+        full += (y_val[i] - pred) * (y_val[i] - pred);
+    }
+    full /= n;
+    const double target = full * (1.0 + tolerance_);
+
+    EnsembleSelection out = (method_ == Method::OMP)
+        ? ompAdditive(P, T, n, y_val, target)
+        : greedyAdditive(P, T, n, factors, baseScore, y_val, target);
+    out.fullMSE = full;
+    return out;
+}
+
+EnsembleSelection EnsemblePruner::greedyAdditive(const std::vector<double>& P, int T, size_t n,
+                                                 const std::vector<double>& factors, double baseScore,
+                                                 const std::vector<double>& y, double target) const {
+    const int budget = maxTrees_ > 0 ? std::min(maxTrees_, T) : T;
+    std::vector<double> residual(n);
+    double sse = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        residual[i] = y[i] - baseScore;
+        sse += residual[i] * residual[i];
+    }
+
+    std::vector<char> used(T, 0);
+    std::vector<double> score(T);
+    std::vector<int> order;
+    while (static_cast<int>(order.size()) < budget && sse / n > target) {
+        // SSE after adding t: sse - (2 f P_t.r - f^2 |P_t|^2)
+        #pragma omp parallel for schedule(static) if(T > 16)
+        for (int t = 0; t < T; ++t) {
+            if (used[t]) { score[t] = -std::numeric_limits<double>::infinity(); continue; }
+            const double* p = &P[static_cast<size_t>(t) * n];
+            const double f = factors[t];
+            double dot = 0.0, sq = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                dot += p[i] * residual[i];
+                sq  += p[i] * p[i];
+            }
+            score[t] = 2.0 * f * dot - f * f * sq;
+        }
+        const int best = static_cast<int>(std::max_element(score.begin(), score.end()) - score.begin());
+        used[best] = 1;
+        order.push_back(best);
+        const double* p = &P[static_cast<size_t>(best) * n];
+        sse = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            residual[i] -= factors[best] * p[i];
+            sse += residual[i] * residual[i];
+        }
+    }
+
+    EnsembleSelection sel;
+    sel.baseScore = baseScore;
+    sel.prunedMSE = sse / n;
+    sel.trees = order;
+    std::sort(sel.trees.begin(), sel.trees.end());
+    for (int t : sel.trees) sel.weights.push_back(factors[t]);
+    return sel;
+}
+
+EnsembleSelection EnsemblePruner::ompAdditive(const std::vector<double>& P, int T, size_t n,
+                                              const std::vector<double>& y, double target) const {
+    const int budget = maxTrees_ > 0 ? std::min(maxTrees_, T) : T;
+
+    // Intercept is refit with the weights: work with centred columns
+    double yMean = 0.0;
+    for (size_t i = 0; i < n; ++i) yMean += y[i];
+    yMean /= n;
+    std::vector<double> yc(n), residual(n);
+    double sse = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        yc[i] = residual[i] = y[i] - yMean;
+        sse += yc[i] * yc[i];
+    }
+    std::vector<double> mean(T, 0.0), norm(T, 0.0);
+    #pragma omp parallel for schedule(static) if(T > 16)
+    for (int t = 0; t < T; ++t) {
+        const double* p = &P[static_cast<size_t>(t) * n];
+        double s = 0.0, ss = 0.0;
+        for (size_t i = 0; i < n; ++i) { s += p[i]; ss += p[i] * p[i]; }
+        mean[t] = s / n;
+        norm[t] = std::sqrt(std::max(0.0, ss - s * mean[t]));
+    }
+
+    std::vector<char> used(T, 0);
+    std::vector<double> score(T);
+    std::vector<int> order;
+    std::vector<double> gram, rhs, coef;
+    while (static_cast<int>(order.size()) < budget && sse / n > target) {
+        #pragma omp parallel for schedule(static) if(T > 16)
+        for (int t = 0; t < T; ++t) {
+            if (used[t] || norm[t] <= 0.0) { score[t] = -1.0; continue; }
+            const double* p = &P[static_cast<size_t>(t) * n];
+            double dot = 0.0;
+            for (size_t i = 0; i < n; ++i) dot += (p[i] - mean[t]) * residual[i];
+            score[t] = std::abs(dot) / norm[t];
+        }
+        const int best = static_cast<int>(std::max_element(score.begin(), score.end()) - score.begin());
+        if (score[best] <= 0.0) break;   // Nothing left correlates with the residual
+        used[best] = 1;
+        order.push_back(best);
+
+        // Grow the Gram matrix of the centred kept columns by one row/column
+        const int k = static_cast<int>(order.size());
+        std::vector<double> grown(static_cast<size_t>(k) * k);
+        for (int a = 0; a + 1 < k; ++a) {
+            for (int b = 0; b + 1 < k; ++b) grown[a * k + b] = gram[a * (k - 1) + b];
+        }
+        const double* pb = &P[static_cast<size_t>(best) * n];
+        for (int a = 0; a < k; ++a) {
+            const int ta = order[a];
+            const double* pa = &P[static_cast<size_t>(ta) * n];
+            double g = 0.0;
+            for (size_t i = 0; i < n; ++i) g += (pa[i] - mean[ta]) * (pb[i] - mean[best]);
+            grown[a * k + (k - 1)] = grown[(k - 1) * k + a] = g;
+        }
+        gram.swap(grown);
+        double r = 0.0;
+        for (size_t i = 0; i < n; ++i) r += (pb[i] - mean[best]) * yc[i];
+        rhs.push_back(r);
+
+        coef = solveNormal(gram, rhs, k);
+        sse = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double fit = 0.0;
+            for (int a = 0; a < k; ++a) {
+                const int ta = order[a];
+                fit += coef[a] * (P[static_cast<size_t>(ta) * n + i] - mean[ta]);
+            }
+            residual[i] = yc[i] - fit;
+            sse += residual[i] * residual[i];
+        }
+    }
+
+    EnsembleSelection sel;
+    sel.prunedMSE = sse / n;
+    sel.baseScore = yMean;
+    std::vector<int> byIndex(order.size());
+    for (size_t a = 0; a < order.size(); ++a) byIndex[a] = static_cast<int>(a);
+    std::sort(byIndex.begin(), byIndex.end(), [&](int a, int b) { return order[a] < order[b]; });
+    for (int a : byIndex) {
+        sel.trees.push_back(order[a]);
+        sel.weights.push_back(coef[a]);
+        sel.baseScore -= coef[a] * mean[order[a]];
+    }
+    return sel;
+}
+
+EnsembleSelection EnsemblePruner::selectAveraging(const std::vector<const Node*>& trees,
+                                                  const std::vector<double>& X_val,
+                                                  int rowLength,
+                                                  const std::vector<double>& y_val) const {
+    const int T = static_cast<int>(trees.size());
+    const size_t n = y_val.size();
+    EnsembleSelection sel;
+    if (T == 0 || n == 0) return sel;
+
+    const std::vector<double> P = cachePredictions(trees, X_val, rowLength, n);
+    double full = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double s = 0.0;
+        for (int t = 0; t < T; ++t) s += P[static_cast<size_t>(t) * n + i];
+        const double d = y_val[i] - s / T;
+        full += d * d;
+    }
+    full /= n;
+    const double target = full * (1.0 + tolerance_);
+    const int budget = maxTrees_ > 0 ? std::min(maxTrees_, T) : T;
+
+    // Forward selection on the running sum of the kept trees
+    std::vector<double> sum(n, 0.0);
+    std::vector<char> used(T, 0);
+    std::vector<double> score(T);
+    std::vector<int> order;
+    double mse = std::numeric_limits<double>::infinity();
+    while (static_cast<int>(order.size()) < budget && mse > target) {
+        const double inv = 1.0 / (order.size() + 1);
+        #pragma omp parallel for schedule(static) if(T > 16)
+        for (int t = 0; t < T; ++t) {
+            if (used[t]) { score[t] = std::numeric_limits<double>::infinity(); continue; }
+            const double* p = &P[static_cast<size_t>(t) * n];
+            double sse = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                const double d = y_val[i] - (sum[i] + p[i]) * inv;
+                sse += d * d;
+            }
+            score[t] = sse;
+        }
+        const int best = static_cast<int>(std::min_element(score.begin(), score.end()) - score.begin());
+        used[best] = 1;
+        order.push_back(best);
+        const double* p = &P[static_cast<size_t>(best) * n];
+        for (size_t i = 0; i < n; ++i) sum[i] += p[i];
+        mse = score[best] / n;
+    }
+
+    sel.fullMSE = full;
+    sel.prunedMSE = mse;
+    sel.trees = order;
+    std::sort(sel.trees.begin(), sel.trees.end());
+    sel.weights.assign(sel.trees.size(), 1.0 / sel.trees.size());
+    return sel;
+}
@@ -0,0 +1,151 @@
+// =============================================================================
+// src/tree/ensemble/FlatForest.cpp - Preorder flattening, merge, save/load
+// =============================================================================
+#include "ensemble/FlatForest.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+struct ForestHeader {
+    char          magic[8];
+    std::uint64_t trees;
+    std::uint64_t nodes;
+};
+
+constexpr char FOREST_MAGIC[8] = {'D', 'T', 'F', 'O', 'R', '0', '1', '\0'};
+
+} // namespace
+
+void FlatForest::appendTree(const Node* root) {
+    if (treeStart_.empty()) treeStart_.push_back(0);
+    const std::int64_t base = static_cast<std::int64_t>(nodes_.size());
+
+    // Preorder with an explicit stack; `parent` is the node whose right index
+    // is patched when a right child is emitted
+    struct Pending { const Node* node; std::int64_t parent; };
+    std::vector<Pending> stack{{root, -1}};
+    while (!stack.empty()) {
+        const Pending p = stack.back();
+        stack.pop_back();
+        const std::int64_t index = static_cast<std::int64_t>(nodes_.size());
+        if (p.parent >= 0) nodes_[p.parent].right = static_cast<std::int32_t>(index - base);
+
+        if (!p.node || p.node->isLeaf) {
+            nodes_.push_back({-1, 0, p.node ? p.node->getPrediction() : 0.0});
+            continue;
+        }
+        nodes_.push_back({p.node->getFeatureIndex(), 0, p.node->getThreshold()});
+        stack.push_back({p.node->getRight(), index});
+        stack.push_back({p.node->getLeft(), -1});
+    }
+    treeStart_.push_back(static_cast<std::int64_t>(nodes_.size()));
+}
+
+void FlatForest::append(const FlatForest& other) {
+    const auto sizes = other.treeSizes();
+    appendRaw(other.nodes_.data(), sizes.data(), sizes.size());
+}
+
+void FlatForest::appendRaw(const FlatNode* nodes, const std::int64_t* treeSizes, std::size_t numTrees) {
+    if (treeStart_.empty()) treeStart_.push_back(0);
+    std::int64_t total = 0;
+    for (std::size_t t = 0; t < numTrees; ++t) {
+        total += treeSizes[t];
+        treeStart_.push_back(static_cast<std::int64_t>(nodes_.size()) + total);
+    }
+    nodes_.insert(nodes_.end(), nodes, nodes + total);
+}
+
+std::vector<std::int64_t> FlatForest::treeSizes() const {
+    std::vector<std::int64_t> sizes(numTrees());
+    for (std::size_t t = 0; t < sizes.size(); ++t) sizes[t] = treeStart_[t + 1] - treeStart_[t];
+    return sizes;
+}
+
+double FlatForest::predict(const double* sample) const {
+    const std::size_t T = numTrees();
+    if (T == 0) return 0.0;
+    double sum = 0.0;
+    for (std::size_t t = 0; t < T; ++t) sum += predictTree(t, sample);
+    return sum / static_cast<double>(T);
+}
+
+void FlatForest::predictBatch(const std::vector<double>& X,
+                              int rowLength,
+                              std::vector<double>& predictions) const {
+    const std::size_t n = rowLength > 0 ? X.size() / rowLength : 0;
+    predictions.assign(n, 0.0);
+    const std::size_t T = numTrees();
+    if (T == 0) return;
+
+    // Row blocks walk tree by tree so a tree's nodes stay in cache for the block
+    constexpr std::size_t BLOCK = 256;
+    const double invT = 1.0 / static_cast<double>(T);
+    const long long numBlocks = static_cast<long long>((n + BLOCK - 1) / BLOCK);
+    #pragma omp parallel for schedule(static) if(n > 1000)
+    for (long long b = 0; b < numBlocks; ++b) {
+        const std::size_t begin = static_cast<std::size_t>(b) * BLOCK;
+        const std::size_t end = std::min(n, begin + BLOCK);
+        for (std::size_t t = 0; t < T; ++t) {
+            for (std::size_t i = begin; i < end; ++i) {
+                predictions[i] += predictTree(t, &X[i * rowLength]);
+            }
+        }
+        for (std::size_t i = begin; i < end; ++i) predictions[i] *= invT;
+    }
+}
+
+bool FlatForest::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file: " << filename << std::endl;
+        return false;
+    }
+    ForestHeader header;
+    std::memcpy(header.magic, FOREST_MAGIC, sizeof(FOREST_MAGIC));
+    header.trees = numTrees();
+    header.nodes = nodes_.size();
+    const auto sizes = treeSizes();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sizes.data()),
+               static_cast<std::streamsize>(sizes.size() * sizeof(std::int64_t)));
+    file.write(reinterpret_cast<const char*>(nodes_.data()),
+               static_cast<std::streamsize>(nodes_.size() * sizeof(FlatNode)));
+    return static_cast<bool>(file);
+}
+
+bool FlatForest::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Unable to open file: " << filename << std::endl;
+        return false;
+    }
+    ForestHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, FOREST_MAGIC, sizeof(FOREST_MAGIC)) != 0) {
+        std::cerr << "Not a forest file: " << filename << std::endl;
+        return false;
+    }
+    std::vector<std::int64_t> sizes(header.trees);
+    std::vector<FlatNode> nodes(header.nodes);
+    file.read(reinterpret_cast<char*>(sizes.data()),
+              static_cast<std::streamsize>(sizes.size() * sizeof(std::int64_t)));
+    file.read(reinterpret_cast<char*>(nodes.data()),
+              static_cast<std::streamsize>(nodes.size() * sizeof(FlatNode)));
+    std::int64_t total = 0;
+    for (const auto s : sizes) total += s;
+    if (!file || total != static_cast<std::int64_t>(nodes.size())) {
+        std::cerr << "Truncated forest file: " << filename << std::endl;
+        return false;
+    }
+    nodes_.clear();
+    treeStart_.clear();
+    appendRaw(nodes.data(), sizes.data(), sizes.size());
+    return true;
+}
@@ -0,0 +1,324 @@
+// =============================================================================
+// src/tree/ensemble/ForestHistogramBuilder.cpp - One data pass per forest level
+// =============================================================================
+#include "ensemble/ForestHistogramBuilder.hpp"
+#include <algorithm>
+#include <limits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+struct BinStats {
+    double w  = 0.0;
+    double s  = 0.0;
+    double ss = 0.0;
+};
+
+// A node that is still open, with the statistics of the rows it holds
+struct OpenNode {
+    Node*    node;
+    int      depth;
+    BinStats stats;
+};
+
+struct SplitChoice {
+    int      feature = -1;
+    int      bin     = 0;
+    double   gain    = 0.0;
+    BinStats left;
+};
+
+// Where a row of an open node goes after the level is decided;
+// next slots are -1 for children that became leaves
+struct Routing {
+    int feature   = -1;   // -1: node became a leaf
+    int bin       = 0;
+    int leftSlot  = -1;
+    int rightSlot = -1;
+};
+
+// A (row, tree) pair still inside an open node: the row, the open node
+// (slot) of that tree holding it, and its bootstrap multiplicity
+struct ActivePair {
+    int row;
+    int slot;
+    int weight;
+};
+
+// Histogram budget per thread, in bins, before open nodes are split into
+// several passes (~12 MB of BinStats)
+constexpr std::size_t HIST_BUDGET = std::size_t(1) << 19;
+
+// Budget for the per-(row, tree) state of a default batch, in bytes
+constexpr std::size_t BATCH_BUDGET = std::size_t(256) << 20;
+
+double sse(const BinStats& b) {
+    return b.w > 0.0 ? b.ss - b.s * b.s / b.w : 0.0;
+}
+
+void setStats(Node* node, const BinStats& b) {
+    const double mean = b.s / b.w;
+    node->samples  = static_cast<size_t>(b.w + 0.5);
+    node->metric   = std::max(0.0, b.ss / b.w - mean * mean);
+    node->nodeMean = mean;
+}
+
+} // namespace
+
+ForestHistogramBuilder::ForestHistogramBuilder(int maxBins, int maxDepth,
+                                               int minSamplesLeaf, double minGain)
+    : maxBins_(std::max(2, std::min(maxBins, 65535))),
+      maxDepth_(maxDepth),
+      minSamplesLeaf_(std::max(1, minSamplesLeaf)),
+      minGain_(minGain) {}
+
+void ForestHistogramBuilder::binFeatures(const FeatureMatrix& X,
+                                         AlignedVector<std::uint16_t>& codes,
+                                         std::vector<std::vector<double>>& cuts) const {
+    const std::size_t N = X.numRows();
+    const int D = X.numFeatures();
+    codes.resize(N * static_cast<std::size_t>(D));   // Each column first touched by the thread binning it
+    cuts.assign(D, {});
+
+    #pragma omp parallel for schedule(dynamic) if(D > 1 && N > 10000)
+    for (int f = 0; f < D; ++f) {
+        std::vector<double> sorted(N);
+        X.visitColumn(f, [&](const auto* col) {
+            for (std::size_t i = 0; i < N; ++i) sorted[i] = col[i];
+        });
+        std::sort(sorted.begin(), sorted.end());
+
+        // Walk the distinct values; cut after a value once it closes an
+        // equal-frequency bin (every value closes one when few are distinct)
+        std::vector<double>& c = cuts[f];
+        const double perBin = static_cast<double>(N) / maxBins_;
+        double nextTarget = perBin;
+        std::size_t i = 0;
+        while (i < N) {
+            std::size_t j = i;
+            while (j < N && sorted[j] == sorted[i]) ++j;
+            if (j < N && static_cast<double>(j) >= nextTarget) {
+                c.push_back(0.5 * (sorted[i] + sorted[j]));
+                while (nextTarget <= static_cast<double>(j)) nextTarget += perBin;
+            }
+            i = j;
+        }
+
+        std::uint16_t* out = codes.data() + static_cast<std::size_t>(f) * N;
+        X.visitColumn(f, [&](const auto* col) {
+            for (std::size_t r = 0; r < N; ++r) {
+                const double v = col[r];
+                out[r] = static_cast<std::uint16_t>(
+                    std::lower_bound(c.begin(), c.end(), v) - c.begin());
+            }
+        });
+    }
+}
+
+int ForestHistogramBuilder::maxBatch(std::size_t rows) {
+    // One count per row, plus an ActivePair for the ~63% of rows a
+    // bootstrap sample draws
+    const double perTree = static_cast<double>(rows) *
+                           (sizeof(int) + 0.632 * sizeof(ActivePair));
+    if (perTree <= 0.0) return std::numeric_limits<int>::max();
+    const double fit = static_cast<double>(BATCH_BUDGET) / perTree;
+    return fit >= std::numeric_limits<int>::max()
+               ? std::numeric_limits<int>::max()
+               : std::max(1, static_cast<int>(fit));
+}
+
+std::vector<std::unique_ptr<Node>>
+ForestHistogramBuilder::build(const FeatureMatrix& X,
+                              const std::vector<double>& labels,
+                              const std::vector<std::vector<int>>& counts) const {
+    const std::size_t N = X.numRows();
+    const int D = X.numFeatures();
+    const int T = static_cast<int>(counts.size());
+
+    std::vector<std::unique_ptr<Node>> roots(T);
+    for (auto& r : roots) r = std::make_unique<Node>();
+    if (N == 0 || T == 0) {
+        for (auto& r : roots) r->makeLeaf(0.0);
+        return roots;
+    }
+
+    AlignedVector<std::uint16_t> codes;
+    std::vector<std::vector<double>> cuts;
+    binFeatures(X, codes, cuts);
+    int maxNb = 1;
+    for (const auto& c : cuts) maxNb = std::max(maxNb, static_cast<int>(c.size()) + 1);
+
+    std::vector<OpenNode> open;
+    std::vector<BinStats> rootStats(T);
+    for (std::size_t i = 0; i < N; ++i) {
+        for (int t = 0; t < T; ++t) {
+            const int w = counts[t][i];
+            if (w <= 0) continue;
+            BinStats& b = rootStats[t];
+            b.w  += w;
+            b.s  += w * labels[i];
+            b.ss += w * labels[i] * labels[i];
+        }
+    }
+    const double minLeaf = static_cast<double>(minSamplesLeaf_);
+    std::vector<int> rootSlot(T, -1);
+    for (int t = 0; t < T; ++t) {
+        Node* node = roots[t].get();
+        const BinStats& b = rootStats[t];
+        if (b.w <= 0.0) { node->makeLeaf(0.0); continue; }
+        setStats(node, b);
+        if (maxDepth_ <= 0 || b.w < 2 * minLeaf) {
+            node->makeLeaf(node->nodeMean, node->nodeMean);
+            continue;
+        }
+        rootSlot[t] = static_cast<int>(open.size());
+        open.push_back({node, 0, b});
+    }
+    // (row, tree) pairs still in an open node, in row order so one column
+    // pass serves every tree; shrinks every level, so deep levels only
+    // touch the rows that are left
+    std::vector<ActivePair> pairs;
+    for (std::size_t i = 0; i < N; ++i) {
+        for (int t = 0; t < T; ++t) {
+            if (counts[t][i] > 0 && rootSlot[t] >= 0) {
+                pairs.push_back({static_cast<int>(i), rootSlot[t], counts[t][i]});
+            }
+        }
+    }
+
+    while (!open.empty()) {
+        const int numOpen = static_cast<int>(open.size());
+        std::vector<SplitChoice> best(numOpen);
+
+        // Open nodes beyond the histogram budget take extra passes
+        const int chunk = static_cast<int>(std::max<std::size_t>(1, HIST_BUDGET / maxNb));
+        for (int s0 = 0; s0 < numOpen; s0 += chunk) {
+            const int s1 = std::min(numOpen, s0 + chunk);
+            const int width = s1 - s0;
+
+            #pragma omp parallel
+            {
+                // Kept all-zero between features: only the bins a node touched
+                // (its [lo, hi] code range) are scanned and cleared, so small
+                // nodes at deep levels cost O(rows), not O(bins)
+                std::vector<BinStats> hist(static_cast<std::size_t>(width) * maxNb);
+                std::vector<int> lo(width), hi(width);
+                std::vector<SplitChoice> localBest(width);
+
+                #pragma omp for schedule(dynamic) nowait
+                for (int f = 0; f < D; ++f) {
+                    const int nb = static_cast<int>(cuts[f].size()) + 1;
+                    if (nb < 2) continue;
+                    std::fill(lo.begin(), lo.end(), nb);
+                    std::fill(hi.begin(), hi.end(), -1);
+
+                    // The shared scan: one pass over the column feeds every tree
+                    const std::uint16_t* col = codes.data() + static_cast<std::size_t>(f) * N;
+                    for (const ActivePair& p : pairs) {
+                        const int s = p.slot - s0;
+                        if (s < 0 || s >= width) continue;
+                        const int code = col[p.row];
+                        const double w = p.weight;
+                        const double y = labels[p.row];
+                        BinStats& b = hist[static_cast<std::size_t>(s) * nb + code];
+                        b.w  += w;
+                        b.s  += w * y;
+                        b.ss += w * y * y;
+                        lo[s] = std::min(lo[s], code);
+                        hi[s] = std::max(hi[s], code);
+                    }
+
+                    for (int k = 0; k < width; ++k) {
+                        if (hi[k] < 0) continue;
+                        const BinStats& total = open[s0 + k].stats;
+                        const double parentSSE = sse(total);
+                        BinStats* h = &hist[static_cast<std::size_t>(k) * nb];
+                        BinStats left;
+                        for (int b = lo[k]; b < hi[k]; ++b) {
+                            if (h[b].w == 0.0) continue;   // Same partition as the previous cut
+                            left.w  += h[b].w;
+                            left.s  += h[b].s;
+                            left.ss += h[b].ss;
+                            const double rightW = total.w - left.w;
+                            if (left.w < minLeaf) continue;
+                            if (rightW < minLeaf) break;
+                            const BinStats right{rightW, total.s - left.s, total.ss - left.ss};
+                            // Gain in MSE units, as the single-tree finders report it
+                            const double gain = (parentSSE - sse(left) - sse(right)) / total.w;
+                            SplitChoice& cur = localBest[k];
+                            if (gain > cur.gain || (gain == cur.gain && cur.feature >= 0 && f < cur.feature)) {
+                                cur = {f, b, gain, left};
+                            }
+                        }
+                        std::fill(h + lo[k], h + hi[k] + 1, BinStats{});
+                    }
+                }
+
+                #pragma omp critical(forest_best_reduction)
+                {
+                    for (int k = 0; k < width; ++k) {
+                        const SplitChoice& c = localBest[k];
+                        SplitChoice& g = best[s0 + k];
+                        if (c.feature < 0) continue;
+                        if (c.gain > g.gain || (c.gain == g.gain && (g.feature < 0 || c.feature < g.feature))) {
+                            g = c;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Apply the level's decisions and open the next level
+        std::vector<OpenNode> next;
+        std::vector<Routing> routing(numOpen);
+        for (int s = 0; s < numOpen; ++s) {
+            OpenNode& o = open[s];
+            const SplitChoice& c = best[s];
+            if (c.feature < 0 || c.gain <= 0.0 || c.gain < minGain_) {
+                o.node->makeLeaf(o.node->nodeMean, o.node->nodeMean);
+                continue;
+            }
+            Node* node = o.node;
+            node->makeInternal(c.feature, cuts[c.feature][c.bin]);
+            node->leftChild = std::make_unique<Node>();
+            node->rightChild = std::make_unique<Node>();
+            node->info.internal.left = node->leftChild.get();
+            node->info.internal.right = node->rightChild.get();
+
+            const BinStats right{o.stats.w - c.left.w, o.stats.s - c.left.s, o.stats.ss - c.left.ss};
+            auto openChild = [&](Node* child, const BinStats& b) {
+                setStats(child, b);
+                if (o.depth + 1 >= maxDepth_ || b.w < 2 * minLeaf || sse(b) <= 0.0) {
+                    child->makeLeaf(child->nodeMean, child->nodeMean);
+                    return -1;
+                }
+                next.push_back({child, o.depth + 1, b});
+                return static_cast<int>(next.size()) - 1;
+            };
+            routing[s].feature   = c.feature;
+            routing[s].bin       = c.bin;
+            routing[s].leftSlot  = openChild(node->leftChild.get(), c.left);
+            routing[s].rightSlot = openChild(node->rightChild.get(), right);
+        }
+
+        // Route every active pair into the next level's open nodes
+        const std::size_t numPairs = pairs.size();
+        #pragma omp parallel for schedule(static) if(numPairs > 10000)
+        for (std::size_t k = 0; k < numPairs; ++k) {
+            ActivePair& p = pairs[k];
+            const Routing& r = routing[p.slot];
+            if (r.feature < 0) { p.slot = -1; continue; }
+            const int code = codes[static_cast<std::size_t>(r.feature) * N + p.row];
+            p.slot = (code <= r.bin) ? r.leftSlot : r.rightSlot;
+        }
+        pairs.erase(std::remove_if(pairs.begin(), pairs.end(),
+                                   [](const ActivePair& p) { return p.slot < 0; }),
+                    pairs.end());
+
+        open.swap(next);
+    }
+
+    return roots;
+}
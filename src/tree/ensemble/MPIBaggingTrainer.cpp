@@ -5,6 +5,7 @@
 #include <chrono>
 #include <numeric>
 #include <algorithm>
+#include <climits>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -37,21 +38,6 @@ MPIBaggingTrainer::MPIBaggingTrainer(int numTrees,
     localNumTrees_ = localTrees;
     treeOffset_ = offset;
     
-    // Strong randomization for process independence
-    std::random_device rd;
-    std::mt19937 masterGen(seed);
-    
-    // Generate independent seed sequence
-    std::vector<uint32_t> processSeeds(mpiSize_);
-    for (int i = 0; i < mpiSize_; ++i) {
-        processSeeds[i] = masterGen();
-        processSeeds[i] ^= (i * 2654435761U);  // Large prime
-        processSeeds[i] ^= rd();  // Hardware randomness
-    }
-    
-    uint32_t localSeed = processSeeds[mpiRank_];
-    uint32_t bagSeed = localSeed ^ (treeOffset_ * 1103515245U);
-    
     // Create local bagging trainer
     localBagging_ = std::make_unique<BaggingTrainer>(
         localNumTrees_,
@@ -62,13 +48,16 @@ MPIBaggingTrainer::MPIBaggingTrainer(int numTrees,
         splitMethod_,
         prunerType_,
         prunerParam_,
-        bagSeed
+        baseSeed_
     );
+    // Every tree draws from the stream of its global id, so the forest is the
+    // same for any number of ranks and threads
+    localBagging_->setTreeIdOffset(treeOffset_);
     
     if (mpiRank_ == 0) {
         std::cout << "Enhanced MPI Bagging initialized with " << mpiSize_ << " processes" << std::endl;
         std::cout << "Total trees: " << numTrees_ << std::endl;
-        std::cout << "Strong randomization: enabled" << std::endl;
+        std::cout << "Random streams: keyed by (seed " << baseSeed_ << ", tree id)" << std::endl;
         #ifdef _OPENMP
         std::cout << "OpenMP threads per process: " << omp_get_max_threads() << std::endl;
         #endif
@@ -81,7 +70,13 @@ void MPIBaggingTrainer::train(const std::vector<double>& data,
     
     auto totalStart = std::chrono::high_resolution_clock::now();
     
-    if (mpiRank_ == 0) {
+    // The forest-synchronous builder grows fixed batches; it keeps the static split
+    const bool forestBuild = splitMethod_ == "forest" || splitMethod_.rfind("forest:", 0) == 0;
+    const bool dynamic = dynamic_ && !forestBuild;
+    
+    if (mpiRank_ == 0 && dynamic) {
+        std::cout << "\nStarting distributed training (dynamic chunks from a shared counter)..." << std::endl;
+    } else if (mpiRank_ == 0) {
         std::cout << "\nStarting distributed training..." << std::endl;
         for (int r = 0; r < mpiSize_; ++r) {
             auto [trees, offset] = calculateTreeAssignment(r, mpiSize_, numTrees_);
@@ -104,15 +99,28 @@ void MPIBaggingTrainer::train(const std::vector<double>& data,
         return;
     }
     
-    if (localNumTrees_ > 0) {
+    double queueWait = 0.0;
+    if (dynamic) {
+        queueWait = trainDynamicChunks(data, numFeatures, labels);
+        localNumTrees_ = localBagging_->getTrainedTrees();
+    } else if (localNumTrees_ > 0) {
         localBagging_->train(data, numFeatures, labels);
     }
     
     auto trainEnd = std::chrono::high_resolution_clock::now();
     
+    // Processes that finish early start the OOB reduction while the rest train
+    startOOBReduction(labels.size());
+    
     MPI_Barrier(comm_);
     auto totalEnd = std::chrono::high_resolution_clock::now();
     
+    // Busy: growing trees; idle: waiting on the work counter or for the
+    // slowest process at the barrier
+    const double busy = std::chrono::duration<double>(trainEnd - trainStart).count() - queueWait;
+    const double idle = std::chrono::duration<double>(totalEnd - trainEnd).count() + queueWait;
+    reportLoadBalance(busy, idle);
+    
     // Timing information
     auto localTrainTime = std::chrono::duration_cast<std::chrono::milliseconds>(trainEnd - trainStart).count();
     long maxTrainTime;
@@ -126,7 +134,177 @@ void MPIBaggingTrainer::train(const std::vector<double>& data,
     }
 }
 
+double MPIBaggingTrainer::trainDynamicChunks(const std::vector<double>& data,
+                                             int numFeatures,
+                                             const std::vector<double>& labels) {
+    // Guided chunk table, identical on every process: a chunk covers half a
+    // process's share of the trees left, and never fewer trees than the
+    // largest process has threads
+    int threads = 1;
+    #ifdef _OPENMP
+    threads = omp_get_max_threads();
+    #endif
+    int minChunk = 1;
+    MPI_Allreduce(&threads, &minChunk, 1, MPI_INT, MPI_MAX, comm_);
+    std::vector<int> chunkStart{0};
+    while (chunkStart.back() < numTrees_) {
+        const int left = numTrees_ - chunkStart.back();
+        const int chunk = std::max(minChunk, (left + 2 * mpiSize_ - 1) / (2 * mpiSize_));
+        chunkStart.push_back(std::min(numTrees_, chunkStart.back() + chunk));
+    }
+    const int numChunks = static_cast<int>(chunkStart.size()) - 1;
+    
+    // Shared counter of handed-out chunks, hosted on rank 0
+    int* counter = nullptr;
+    MPI_Win win;
+    MPI_Win_allocate(mpiRank_ == 0 ? sizeof(int) : 0, sizeof(int), MPI_INFO_NULL,
+                     comm_, &counter, &win);
+    if (mpiRank_ == 0) {
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, win);
+        *counter = 0;
+        MPI_Win_unlock(0, win);
+    }
+    MPI_Barrier(comm_);
+    MPI_Win_lock_all(0, win);
+    
+    double waited = 0.0;
+    auto next = [&](int& first, int& count) {
+        auto start = std::chrono::high_resolution_clock::now();
+        const int one = 1;
+        int chunk = 0;
+        MPI_Fetch_and_op(&one, &chunk, MPI_INT, 0, 0, MPI_SUM, win);
+        MPI_Win_flush(0, win);
+        waited += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        if (chunk >= numChunks) return false;
+        first = chunkStart[chunk];
+        count = chunkStart[chunk + 1] - first;
+        return true;
+    };
+    localBagging_->trainDynamic(data, numFeatures, labels, next);
+    
+    MPI_Win_unlock_all(win);
+    MPI_Win_free(&win);
+    
+    if (mpiRank_ == 0) {
+        std::cout << "Dynamic schedule: " << numChunks << " chunks (first " << chunkStart[1]
+                  << " trees, last " << (chunkStart[numChunks] - chunkStart[numChunks - 1])
+                  << ")" << std::endl;
+    }
+    return waited;
+}
+
+void MPIBaggingTrainer::reportLoadBalance(double busySeconds, double idleSeconds) const {
+    const double local[3] = {static_cast<double>(localBagging_ ? localBagging_->getTrainedTrees() : 0),
+                             busySeconds, idleSeconds};
+    std::vector<double> all(mpiRank_ == 0 ? 3 * mpiSize_ : 0);
+    MPI_Gather(local, 3, MPI_DOUBLE, all.data(), 3, MPI_DOUBLE, 0, comm_);
+    if (mpiRank_ != 0) return;
+    
+    double busyTotal = 0.0, wallMax = 0.0;
+    std::cout << "Load balance (busy / idle):" << std::endl;
+    for (int r = 0; r < mpiSize_; ++r) {
+        const double busy = all[3 * r + 1], idle = all[3 * r + 2];
+        busyTotal += busy;
+        wallMax = std::max(wallMax, busy + idle);
+        std::cout << "  Process " << r << ": " << static_cast<int>(all[3 * r]) << " trees, "
+                  << static_cast<long>(busy * 1000) << "ms busy / "
+                  << static_cast<long>(idle * 1000) << "ms idle" << std::endl;
+    }
+    if (wallMax > 0.0) {
+        std::cout << "  Efficiency: " << std::fixed << std::setprecision(1)
+                  << 100.0 * busyTotal / (wallMax * mpiSize_) << "%" << std::endl;
+    }
+}
+
+void MPIBaggingTrainer::gatherForest(int root) {
+    auto gatherStart = std::chrono::high_resolution_clock::now();
+    
+    FlatForest local;
+    if (localNumTrees_ > 0 && localBagging_) {
+        for (const Node* tree : localBagging_->getTreeRoots()) local.appendTree(tree);
+    }
+    const std::vector<int64_t> localSizes = local.treeSizes();
+    std::vector<int> localIds = localBagging_ ? localBagging_->getTreeIds() : std::vector<int>();
+    localIds.resize(localSizes.size());
+    
+    // Per-rank tree and node counts; trees are put back in global id order
+    // below, so the merged forest is the same for any schedule
+    int counts[2] = {static_cast<int>(localSizes.size()), static_cast<int>(local.numNodes())};
+    std::vector<int> allCounts(2 * mpiSize_);
+    MPI_Allgather(counts, 2, MPI_INT, allCounts.data(), 2, MPI_INT, comm_);
+    std::vector<int> treeCounts(mpiSize_), treeDispls(mpiSize_), nodeCounts(mpiSize_), nodeDispls(mpiSize_);
+    long long totalTrees = 0, totalNodes = 0;
+    for (int r = 0; r < mpiSize_; ++r) {
+        treeCounts[r] = allCounts[2 * r];
+        nodeCounts[r] = allCounts[2 * r + 1];
+        treeDispls[r] = static_cast<int>(totalTrees);
+        nodeDispls[r] = static_cast<int>(totalNodes);
+        totalTrees += treeCounts[r];
+        totalNodes += nodeCounts[r];
+    }
+    if (totalNodes > INT_MAX) {
+        if (mpiRank_ == 0) std::cerr << "Error: forest too large to gather (" << totalNodes << " nodes)" << std::endl;
+        return;
+    }
+    
+    // Nodes travel as opaque 16-byte records
+    MPI_Datatype nodeType;
+    MPI_Type_contiguous(static_cast<int>(sizeof(FlatForest::FlatNode)), MPI_BYTE, &nodeType);
+    MPI_Type_commit(&nodeType);
+    
+    const bool receives = root < 0 || root == mpiRank_;
+    std::vector<int64_t> sizes(receives ? totalTrees : 0);
+    std::vector<int> ids(receives ? totalTrees : 0);
+    std::vector<FlatForest::FlatNode> nodes(receives ? totalNodes : 0);
+    if (root < 0) {
+        MPI_Allgatherv(localSizes.data(), counts[0], MPI_INT64_T,
+                       sizes.data(), treeCounts.data(), treeDispls.data(), MPI_INT64_T, comm_);
+        MPI_Allgatherv(localIds.data(), counts[0], MPI_INT,
+                       ids.data(), treeCounts.data(), treeDispls.data(), MPI_INT, comm_);
+        MPI_Allgatherv(local.nodes().data(), counts[1], nodeType,
+                       nodes.data(), nodeCounts.data(), nodeDispls.data(), nodeType, comm_);
+    } else {
+        MPI_Gatherv(localSizes.data(), counts[0], MPI_INT64_T,
+                    sizes.data(), treeCounts.data(), treeDispls.data(), MPI_INT64_T, root, comm_);
+        MPI_Gatherv(localIds.data(), counts[0], MPI_INT,
+                    ids.data(), treeCounts.data(), treeDispls.data(), MPI_INT, root, comm_);
+        MPI_Gatherv(local.nodes().data(), counts[1], nodeType,
+                    nodes.data(), nodeCounts.data(), nodeDispls.data(), nodeType, root, comm_);
+    }
+    MPI_Type_free(&nodeType);
+    
+    mergedForest_.reset();
+    if (receives) {
+        std::vector<int64_t> start(sizes.size() + 1, 0);
+        for (size_t t = 0; t < sizes.size(); ++t) start[t + 1] = start[t] + sizes[t];
+        std::vector<int> order(sizes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return ids[a] < ids[b]; });
+        mergedForest_ = std::make_unique<FlatForest>();
+        for (const int t : order) {
+            mergedForest_->appendRaw(nodes.data() + start[t], &sizes[t], 1);
+        }
+    }
+    forestOnAllRanks_ = root < 0;
+    
+    auto gatherEnd = std::chrono::high_resolution_clock::now();
+    if (mpiRank_ == 0) {
+        std::cout << "Forest gathered " << (root < 0 ? "on all processes" : "on one process")
+                  << ": " << totalTrees << " trees, " << totalNodes << " nodes ("
+                  << (totalNodes * static_cast<long long>(sizeof(FlatForest::FlatNode))) / 1024 << " KB) in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(gatherEnd - gatherStart).count()
+                  << "ms" << std::endl;
+    }
+}
+
+bool MPIBaggingTrainer::saveForest(const std::string& filename) const {
+    if (!mergedForest_) return false;
+    return mergedForest_->save(filename);
+}
+
 double MPIBaggingTrainer::predict(const double* sample, int numFeatures) const {
+    if (forestOnAllRanks_) return mergedForest_->predict(sample);
+    
     double localPred = 0.0;
     
     if (localNumTrees_ > 0 && localBagging_) {
@@ -149,36 +327,67 @@ void MPIBaggingTrainer::predictBatch(const std::vector<double>& X,
         return;
     }
     
-    const size_t n = X.size() / numFeatures;
-    predictions.resize(n);
-    
-    std::vector<double> localPredictions(n, 0.0);
-    
-    if (localNumTrees_ > 0) {
-        #pragma omp parallel for schedule(static, 256) if(n > 1000)
-        for (size_t i = 0; i < n; ++i) {
-            localPredictions[i] = localBagging_->predict(&X[i * numFeatures], numFeatures) * localNumTrees_;
-        }
-    }
-    
-    // Ensure consistent batch sizes across processes
-    int localSize = static_cast<int>(n);
-    int globalSize = 0;
-    MPI_Allreduce(&localSize, &globalSize, 1, MPI_INT, MPI_MAX, comm_);
-    
-    if (localSize != globalSize) {
-        std::cerr << "Process " << mpiRank_ << " ERROR: Inconsistent batch sizes!" << std::endl;
+    if (forestOnAllRanks_) {
+        mergedForest_->predictBatch(X, numFeatures, predictions);
         return;
     }
     
-    MPI_Allreduce(localPredictions.data(), predictions.data(), 
-                  static_cast<int>(n), MPI_DOUBLE, MPI_SUM, comm_);
+    scoreCollective(X, numFeatures, predictions, nullptr);
+}
+
+void MPIBaggingTrainer::scoreCollective(const std::vector<double>& X,
+                                        int numFeatures,
+                                        std::vector<double>& predictions,
+                                        const std::function<void(size_t, size_t)>& onChunk) const {
+    const size_t n = X.size() / numFeatures;
+    predictions.assign(n, 0.0);
+    std::vector<double> localPredictions(n, 0.0);
     
+    const size_t chunkRows = scoringChunkRows_;
+    const size_t numChunks = (n + chunkRows - 1) / chunkRows;
+    // Row block between polls of the reduction in flight
+    constexpr size_t POLL_ROWS = 1024;
     const double invNumTrees = 1.0 / numTrees_;
-    #pragma omp parallel for schedule(static) if(n > 1000)
-    for (size_t i = 0; i < n; ++i) {
-        predictions[i] *= invNumTrees;
+    
+    // Chunk c uses slot c % 2: at most two reductions are in flight
+    MPI_Request requests[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+    
+    auto finishChunk = [&](size_t c) {
+        MPI_Wait(&requests[c % 2], MPI_STATUS_IGNORE);
+        const size_t begin = c * chunkRows;
+        const size_t end = std::min(n, begin + chunkRows);
+        for (size_t i = begin; i < end; ++i) {
+            predictions[i] *= invNumTrees;
+        }
+        if (onChunk) onChunk(begin, end);
+    };
+    
+    for (size_t c = 0; c < numChunks; ++c) {
+        const size_t begin = c * chunkRows;
+        const size_t end = std::min(n, begin + chunkRows);
+        
+        if (localNumTrees_ > 0 && localBagging_) {
+            for (size_t b = begin; b < end; b += POLL_ROWS) {
+                const size_t blockEnd = std::min(end, b + POLL_ROWS);
+                #pragma omp parallel for schedule(static, 64) if(blockEnd - b > 256)
+                for (size_t i = b; i < blockEnd; ++i) {
+                    localPredictions[i] = localBagging_->predict(&X[i * numFeatures], numFeatures) * localNumTrees_;
+                }
+                if (c > 0) {
+                    int done = 0;
+                    MPI_Test(&requests[(c - 1) % 2], &done, MPI_STATUS_IGNORE);
+                }
+            }
+        }
+        
+        MPI_Iallreduce(localPredictions.data() + begin, predictions.data() + begin,
+                       static_cast<int>(end - begin), MPI_DOUBLE, MPI_SUM, comm_, &requests[c % 2]);
+        
+        // MPI_Test above may already have completed (and nulled) the request;
+        // MPI_Wait on MPI_REQUEST_NULL returns at once
+        if (c > 0) finishChunk(c - 1);
     }
+    if (numChunks > 0) finishChunk(numChunks - 1);
 }
 
 void MPIBaggingTrainer::evaluate(const std::vector<double>& X,
@@ -196,29 +405,37 @@ void MPIBaggingTrainer::evaluate(const std::vector<double>& X,
         return;
     }
     
-    // Use batch prediction to avoid MPI communication in OpenMP loops
+    // Errors are accumulated per chunk, so in collective scoring they overlap
+    // the reduction of the next chunk
+    double sumSq = 0.0;
+    double sumAbs = 0.0;
     std::vector<double> predictions;
-    predictBatch(X, numFeatures, predictions);
-    
-    if (predictions.size() != n) {
-        std::cerr << "Process " << mpiRank_ << " ERROR: Prediction size mismatch!" << std::endl;
-        mse = mae = std::numeric_limits<double>::infinity();
-        return;
-    }
-    
-    // Compute MSE and MAE using OpenMP
-    mse = 0.0;
-    mae = 0.0;
-    
-    #pragma omp parallel for reduction(+:mse,mae) schedule(static, 256) if(n > 1000)
-    for (size_t i = 0; i < n; ++i) {
-        const double diff = y[i] - predictions[i];
-        mse += diff * diff;
-        mae += std::abs(diff);
+    auto accumulate = [&](size_t begin, size_t end) {
+        double chunkSq = 0.0, chunkAbs = 0.0;
+        #pragma omp parallel for reduction(+:chunkSq,chunkAbs) schedule(static, 256) if(end - begin > 1000)
+        for (size_t i = begin; i < end; ++i) {
+            const double diff = y[i] - predictions[i];
+            chunkSq += diff * diff;
+            chunkAbs += std::abs(diff);
+        }
+        sumSq += chunkSq;
+        sumAbs += chunkAbs;
+    };
+    
+    if (forestOnAllRanks_) {
+        mergedForest_->predictBatch(X, numFeatures, predictions);
+        if (predictions.size() != n) {
+            std::cerr << "Process " << mpiRank_ << " ERROR: Prediction size mismatch!" << std::endl;
+            mse = mae = std::numeric_limits<double>::infinity();
+            return;
+        }
+        accumulate(0, n);
+    } else {
+        scoreCollective(X, numFeatures, predictions, accumulate);
     }
     
-    mse /= n;
-    mae /= n;
+    mse = sumSq / n;
+    mae = sumAbs / n;
     
     // Only master reports results
     if (mpiRank_ == 0) {
@@ -289,21 +506,50 @@ std::vector<double> MPIBaggingTrainer::getFeatureImportance(int numFeatures) con
     return globalImportance;
 }
 
-double MPIBaggingTrainer::getOOBError(const std::vector<double>& data,
-                                      int numFeatures,
+void MPIBaggingTrainer::startOOBReduction(size_t numRows) {
+    if (oobRequest_ != MPI_REQUEST_NULL) MPI_Wait(&oobRequest_, MPI_STATUS_IGNORE);
+    
+    oobLocal_.assign(2 * numRows, 0.0);
+    if (localBagging_ && localBagging_->getOOBSums().size() == numRows) {
+        const auto& sums = localBagging_->getOOBSums();
+        const auto& counts = localBagging_->getOOBCounts();
+        for (size_t i = 0; i < numRows; ++i) {
+            oobLocal_[i] = sums[i];
+            oobLocal_[numRows + i] = counts[i];
+        }
+    }
+    oobGlobal_.assign(oobLocal_.size(), 0.0);
+    MPI_Iallreduce(oobLocal_.data(), oobGlobal_.data(), static_cast<int>(oobLocal_.size()),
+                   MPI_DOUBLE, MPI_SUM, comm_, &oobRequest_);
+}
+
+double MPIBaggingTrainer::getOOBError(const std::vector<double>& /* data */,
+                                      int /* numFeatures */,
                                       const std::vector<double>& labels) const {
+    if (oobRequest_ != MPI_REQUEST_NULL) MPI_Wait(&oobRequest_, MPI_STATUS_IGNORE);
     
-    // OOB error calculation is complex in distributed setting
-    // For now, return local OOB error on master process
-    if (mpiRank_ == 0 && localNumTrees_ > 0) {
-        return localBagging_->getOOBError(data, numFeatures, labels);
+    const size_t n = labels.size();
+    if (oobGlobal_.size() != 2 * n) {
+        if (mpiRank_ == 0) std::cerr << "Error: OOB sums do not match the labels (train first)" << std::endl;
+        return 0.0;
     }
     
-    return 0.0;
+    double mse = 0.0;
+    size_t valid = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double count = oobGlobal_[n + i];
+        if (count > 0.0) {
+            const double diff = labels[i] - oobGlobal_[i] / count;
+            mse += diff * diff;
+            ++valid;
+        }
+    }
+    return valid > 0 ? mse / valid : 0.0;
 }
 
 MPIBaggingTrainer::~MPIBaggingTrainer() {
-    // MPI cleanup handled by main program
+    // A pending OOB reduction must complete before MPI_Finalize
+    if (oobRequest_ != MPI_REQUEST_NULL) MPI_Wait(&oobRequest_, MPI_STATUS_IGNORE);
 }
 
 std::pair<int, int> MPIBaggingTrainer::calculateTreeAssignment(int rank, int size, int totalTrees) const {
@@ -0,0 +1,153 @@
+// =============================================================================
+// src/tree/ensemble/PermutationImportance.cpp - Re-route only affected rows
+// =============================================================================
+#include "ensemble/PermutationImportance.hpp"
+#include "functions/random/CounterRng.hpp"
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+// A row whose path tests the feature: re-routing starts at `start`, the first
+// node on the path that tests it; `leaf` is the row's unpermuted leaf value
+struct PathEntry {
+    int         row;
+    const Node* start;
+    double      leaf;
+};
+
+// Per-tree entries grouped by feature (feature f at [offsets[f], offsets[f+1]))
+struct TreeCache {
+    std::vector<int>       offsets;
+    std::vector<PathEntry> entries;
+};
+
+void buildCache(const Node* root, const std::vector<int>& rows,
+                const std::vector<double>& data, int rowLength,
+                std::vector<int>& seenStamp, TreeCache& cache) {
+    std::vector<std::pair<int, PathEntry>> found;
+    std::size_t pathBegin = 0;
+    for (const int r : rows) {
+        const double* x = &data[static_cast<std::size_t>(r) * rowLength];
+        pathBegin = found.size();
+        const Node* node = root;
+        while (node && !node->isLeaf) {
+            const int f = node->getFeatureIndex();
+            if (seenStamp[f] != r) {
+                seenStamp[f] = r;
+                found.push_back({f, {r, node, 0.0}});
+            }
+            node = (x[f] <= node->getThreshold()) ? node->getLeft() : node->getRight();
+        }
+        const double leaf = node ? node->getPrediction() : 0.0;
+        for (std::size_t k = pathBegin; k < found.size(); ++k) found[k].second.leaf = leaf;
+    }
+
+    // Counting sort by feature
+    cache.offsets.assign(rowLength + 1, 0);
+    for (const auto& e : found) ++cache.offsets[e.first + 1];
+    for (int f = 0; f < rowLength; ++f) cache.offsets[f + 1] += cache.offsets[f];
+    cache.entries.resize(found.size());
+    std::vector<int> fill(cache.offsets.begin(), cache.offsets.end() - 1);
+    for (const auto& e : found) cache.entries[fill[e.first]++] = e.second;
+}
+
+} // namespace
+
+std::vector<double> PermutationImportance::compute(const Ensemble& ensemble,
+                                                   const std::vector<double>& data,
+                                                   int rowLength,
+                                                   const std::vector<double>& labels,
+                                                   const std::vector<double>& basePred,
+                                                   uint32_t seed) {
+    const int N = static_cast<int>(labels.size());
+    const int T = static_cast<int>(ensemble.trees.size());
+    std::vector<double> importance(rowLength, 0.0);
+    if (N == 0 || T == 0 || rowLength <= 0) return importance;
+
+    std::vector<int> scored;
+    for (int r = 0; r < N; ++r) {
+        if (ensemble.rowScale[r] != 0.0) scored.push_back(r);
+    }
+    if (scored.empty()) return importance;
+
+    // Phase 1: per-tree path caches, parallel over trees
+    std::vector<TreeCache> caches(T);
+    #pragma omp parallel if(T > 1)
+    {
+        std::vector<int> seenStamp(rowLength, -1);
+        std::vector<int> rows;
+        #pragma omp for schedule(dynamic, 1)
+        for (int t = 0; t < T; ++t) {
+            const std::vector<int>* own =
+                t < static_cast<int>(ensemble.treeRows.size()) ? ensemble.treeRows[t] : nullptr;
+            if (own) {
+                rows.clear();
+                for (const int r : *own) {
+                    if (ensemble.rowScale[r] != 0.0) rows.push_back(r);
+                }
+            }
+            std::fill(seenStamp.begin(), seenStamp.end(), -1);
+            buildCache(ensemble.trees[t], own ? rows : scored, data, rowLength, seenStamp, caches[t]);
+        }
+    }
+
+    // Phase 2: one permutation per feature, parallel over features; only
+    // cached rows are re-routed, from their first node testing the feature
+    const double invN = 1.0 / static_cast<double>(scored.size());
+    #pragma omp parallel if(rowLength > 1)
+    {
+        std::vector<double> delta(N, 0.0);
+        std::vector<double> permCol(N, 0.0);
+        std::vector<char> touched(N, 0);
+        std::vector<int> touchedRows;
+        std::vector<int> perm;
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int f = 0; f < rowLength; ++f) {
+            perm = scored;
+            CounterRng rng(seed, RngPurpose::Permutation, static_cast<uint32_t>(f));
+            rng.shuffle(perm.begin(), perm.end());
+            for (std::size_t k = 0; k < scored.size(); ++k) {
+                permCol[scored[k]] = data[static_cast<std::size_t>(perm[k]) * rowLength + f];
+            }
+
+            for (int t = 0; t < T; ++t) {
+                const TreeCache& c = caches[t];
+                const double w = ensemble.treeWeights[t];
+                for (int k = c.offsets[f]; k < c.offsets[f + 1]; ++k) {
+                    const PathEntry& e = c.entries[k];
+                    const double* x = &data[static_cast<std::size_t>(e.row) * rowLength];
+                    const Node* node = e.start;
+                    while (node && !node->isLeaf) {
+                        const int g = node->getFeatureIndex();
+                        const double v = (g == f) ? permCol[e.row] : x[g];
+                        node = (v <= node->getThreshold()) ? node->getLeft() : node->getRight();
+                    }
+                    const double leaf = node ? node->getPrediction() : 0.0;
+                    if (leaf == e.leaf) continue;
+                    if (!touched[e.row]) {
+                        touched[e.row] = 1;
+                        touchedRows.push_back(e.row);
+                    }
+                    delta[e.row] += w * (leaf - e.leaf);
+                }
+            }
+
+            // Only re-routed rows change the squared error
+            double increase = 0.0;
+            for (const int r : touchedRows) {
+                const double before = labels[r] - basePred[r];
+                const double after = before - ensemble.rowScale[r] * delta[r];
+                increase += after * after - before * before;
+                delta[r] = 0.0;
+                touched[r] = 0;
+            }
+            touchedRows.clear();
+            importance[f] = increase * invN;
+        }
+    }
+    return importance;
+}
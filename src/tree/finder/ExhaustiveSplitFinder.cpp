@@ -1,5 +1,6 @@
 // src/tree/finder/ExhaustiveSplitFinder.cpp 
 #include "finder/ExhaustiveSplitFinder.hpp"
+#include "tuning/ParallelCalibration.hpp"
 #include <algorithm>
 #include <vector>
 #include <cmath>
@@ -9,42 +10,87 @@
 #include <omp.h>
 #endif
 
+namespace {
+
+// Unit weight for the plain (unweighted) entry points
+struct UnitWeight {
+    double operator()(int) const { return 1.0; }
+};
+
+// Per-node order: copies the node's rows into `buf` and sorts them by feature f
+struct SortPerNode {
+    const int*  rows;
+    std::size_t count;
+
+    template <typename Column>
+    const int* operator()(int /*f*/, const Column& col, std::vector<int>& buf) const {
+        buf.assign(rows, rows + count);
+        std::sort(buf.begin(), buf.end(),
+                  [&](int a, int b) {
+                      return col[a] < col[b];
+                  });
+        return buf.data();
+    }
+};
+
+// Presorted order: the builder already keeps the node's rows sorted per feature
+struct PresortedOrder {
+    SortedRows node;
+
+    template <typename Column>
+    const int* operator()(int f, const Column& /*col*/, std::vector<int>& /*buf*/) const {
+        return node.order(f);
+    }
+};
+
+// Core search, written once for both layouts. `columnOf(f)` returns something
+// indexable by row: a contiguous column pointer or a StridedColumn view.
+// `orderOf(f, col, buf)` yields the node's N rows in ascending order of
+// feature f, sorting into `buf` unless the order is presorted.
+// `weightOf(row)` is the row's multiplicity; counts below are weighted, so a
+// row drawn k times by the bootstrap is scanned once and counted k times.
+template <typename ColumnOf, typename OrderOf, typename WeightOf = UnitWeight>
 std::tuple<int, double, double>
-ExhaustiveSplitFinder::findBestSplit(const std::vector<double>& data,
-                                     int                       rowLength,
-                                     const std::vector<double>& labels,
-                                     const std::vector<int>&    indices,
-                                     double /*currentMetric*/, // Not used in this implementation (assuming MSE based gain)
-                                     const ISplitCriterion&     /*criterion*/) const // Not used in this implementation
+exhaustiveSearch(ColumnOf                    columnOf,
+                 int                         rowLength,
+                 const std::vector<double>&  labels,
+                 const int*                  indices,
+                 std::size_t                 N,
+                 OrderOf                     orderOf,
+                 WeightOf                    weightOf = WeightOf{})
 {
-    const size_t N = indices.size();
     if (N < 2) return {-1, 0.0, 0.0};
 
     
     double totalSum   = 0.0;
     double totalSumSq = 0.0;
+    double totalW     = 0.0;
     
-    // Choose whether to use parallelization based on data size
-    bool useParallel = N > 1000;
+    // Choose whether to use parallelization based on data size (calibrated per machine)
+    bool useParallel = N > ParallelCalibration::cutoffs().finderParallelMinSamples;
     
     if (useParallel) {
-        #pragma omp parallel for reduction(+:totalSum,totalSumSq) schedule(static)
+        #pragma omp parallel for reduction(+:totalSum,totalSumSq,totalW) schedule(static)
         for (size_t i = 0; i < N; ++i) {
+            const double w = weightOf(indices[i]);
             const double y = labels[indices[i]];
-            totalSum   += y;
-            totalSumSq += y * y;
+            totalSum   += w * y;
+            totalSumSq += w * y * y;
+            totalW     += w;
         }
     } else {
         // For small datasets, use serial computation
         for (size_t i = 0; i < N; ++i) {
+            const double w = weightOf(indices[i]);
             const double y = labels[indices[i]];
-            totalSum   += y;
-            totalSumSq += y * y;
+            totalSum   += w * y;
+            totalSumSq += w * y * y;
+            totalW     += w;
         }
     }
     
-    const double parentMean = totalSum / static_cast<double>(N);
-    const double parentMSE  = totalSumSq / static_cast<double>(N) - parentMean * parentMean;
+    const double parentMean = totalSum / totalW;
+    const double parentMSE  = totalSumSq / totalW - parentMean * parentMean;
 
     int    globalBestFeat = -1;
     double globalBestThr  = 0.0;
@@ -61,50 +107,50 @@ ExhaustiveSplitFinder::findBestSplit(const std::vector<double>& data,
             double localBestGain = 0.0;
             
             // Thread-local buffer (avoids repeated allocation)
-            std::vector<int> localSortedIdx(N);
+            std::vector<int> localSortedBuf;
             
             #pragma omp for schedule(dynamic) nowait // Dynamic scheduling for load balancing, no barrier here
             for (int f = 0; f < rowLength; ++f) {
-                /* --- Copy current indices and sort by feature value --- */
-                std::copy(indices.begin(), indices.end(), localSortedIdx.begin());
-                std::sort(localSortedIdx.begin(), localSortedIdx.end(),
-                          [&](int a, int b) {
-                              return data[a * rowLength + f] < data[b * rowLength + f];
-                          });
+                const auto col = columnOf(f);
+                /* --- Rows in ascending order of the feature value --- */
+                const int* localSortedIdx = orderOf(f, col, localSortedBuf);
 
                 /* --- Single loop to accumulate left subset statistics and evaluate splits immediately --- */
                 double leftSum   = 0.0;
                 double leftSumSq = 0.0;
+                double leftW     = 0.0;
 
                 for (size_t i = 0; i < N - 1; ++i) {
                     const int    idx = localSortedIdx[i];
+                    const double w   = weightOf(idx);
                     const double y   = labels[idx];
-                    leftSum   += y;
-                    leftSumSq += y * y;
+                    leftSum   += w * y;
+                    leftSumSq += w * y * y;
+                    leftW     += w;
 
                     /* Check if adjacent samples have different feature values to allow a split */
-                    const double currentVal = data[idx * rowLength + f];
-                    const double nextVal    = data[localSortedIdx[i + 1] * rowLength + f];
+                    const double currentVal = col[idx];
+                    const double nextVal    = col[localSortedIdx[i + 1]];
 
                     if (currentVal + EPS < nextVal) { // Only consider splits between distinct feature values
-                        const size_t leftCnt  = i + 1;
-                        const size_t rightCnt = N - leftCnt;
+                        const double leftCnt  = leftW;
+                        const double rightCnt = totalW - leftW;
 
                         /* Right subset statistics can be derived from total minus left subset */
                         const double rightSum   = totalSum   - leftSum;
                         const double rightSumSq = totalSumSq - leftSumSq;
 
                         /* Calculate variance for left and right subsets (MSE as variance) */
-                        const double leftMean  = leftSum  / static_cast<double>(leftCnt);
-                        const double rightMean = rightSum / static_cast<double>(rightCnt);
+                        const double leftMean  = leftSum  / leftCnt;
+                        const double rightMean = rightSum / rightCnt;
 
-                        const double leftMSE  = leftSumSq  / static_cast<double>(leftCnt)  - leftMean  * leftMean;
-                        const double rightMSE = rightSumSq / static_cast<double>(rightCnt) - rightMean * rightMean;
+                        const double leftMSE  = leftSumSq  / leftCnt  - leftMean  * leftMean;
+                        const double rightMSE = rightSumSq / rightCnt - rightMean * rightMean;
 
                         /* Information Gain (Reduction in MSE) */
                         const double gain = parentMSE -
-                                             (leftMSE * static_cast<double>(leftCnt) +
-                                              rightMSE * static_cast<double>(rightCnt)) / static_cast<double>(N);
+                                             (leftMSE * leftCnt +
+                                              rightMSE * rightCnt) / totalW;
 
                         if (gain > localBestGain) {
                             localBestGain = gain;
@@ -127,49 +173,49 @@ ExhaustiveSplitFinder::findBestSplit(const std::vector<double>& data,
         }
     } else {
         // Serial version for small datasets
-        std::vector<int> sortedIdx(N);
+        std::vector<int> sortedBuf;
         
         for (int f = 0; f < rowLength; ++f) {
-            /* --- Copy current indices and sort by feature value --- */
-            std::copy(indices.begin(), indices.end(), sortedIdx.begin());
-            std::sort(sortedIdx.begin(), sortedIdx.end(),
-                      [&](int a, int b) {
-                          return data[a * rowLength + f] < data[b * rowLength + f];
-                      });
+            const auto col = columnOf(f);
+            /* --- Rows in ascending order of the feature value --- */
+            const int* sortedIdx = orderOf(f, col, sortedBuf);
 
             /* --- Single loop to accumulate left subset statistics and evaluate splits immediately --- */
             double leftSum   = 0.0;
             double leftSumSq = 0.0;
+            double leftW     = 0.0;
 
             for (size_t i = 0; i < N - 1; ++i) {
                 const int    idx = sortedIdx[i];
+                const double w   = weightOf(idx);
                 const double y   = labels[idx];
-                leftSum   += y;
-                leftSumSq += y * y;
+                leftSum   += w * y;
+                leftSumSq += w * y * y;
+                leftW     += w;
 
                 /* Check if adjacent samples have different feature values to allow a split */
-                const double currentVal = data[idx * rowLength + f];
-                const double nextVal    = data[sortedIdx[i + 1] * rowLength + f];
+                const double currentVal = col[idx];
+                const double nextVal    = col[sortedIdx[i + 1]];
 
                 if (currentVal + EPS < nextVal) {
-                    const size_t leftCnt  = i + 1;
-                    const size_t rightCnt = N - leftCnt;
+                    const double leftCnt  = leftW;
+                    const double rightCnt = totalW - leftW;
 
                     /* Right subset statistics can be derived from total minus left subset */
                     const double rightSum   = totalSum   - leftSum;
                     const double rightSumSq = totalSumSq - leftSumSq;
 
                     /* Calculate variance for left and right subsets (MSE as variance) */
-                    const double leftMean  = leftSum  / static_cast<double>(leftCnt);
-                    const double rightMean = rightSum / static_cast<double>(rightCnt);
+                    const double leftMean  = leftSum  / leftCnt;
+                    const double rightMean = rightSum / rightCnt;
 
-                    const double leftMSE  = leftSumSq  / static_cast<double>(leftCnt)  - leftMean  * leftMean;
-                    const double rightMSE = rightSumSq / static_cast<double>(rightCnt) - rightMean * rightMean;
+                    const double leftMSE  = leftSumSq  / leftCnt  - leftMean  * leftMean;
+                    const double rightMSE = rightSumSq / rightCnt - rightMean * rightMean;
 
                     /* Information Gain (Reduction in MSE) */
                     const double gain = parentMSE -
-                                         (leftMSE * static_cast<double>(leftCnt) +
-                                          rightMSE * static_cast<double>(rightCnt)) / static_cast<double>(N);
+                                         (leftMSE * leftCnt +
+                                          rightMSE * rightCnt) / totalW;
 
                     if (gain > globalBestGain) {
                         globalBestGain = gain;
@@ -182,4 +228,78 @@ ExhaustiveSplitFinder::findBestSplit(const std::vector<double>& data,
     }
 
     return {globalBestFeat, globalBestThr, globalBestGain};
-}
\ No newline at end of file
+}
+
+} // namespace
+
+std::tuple<int, double, double>
+ExhaustiveSplitFinder::findBestSplit(const std::vector<double>& data,
+                                     int                       rowLength,
+                                     const std::vector<double>& labels,
+                                     const std::vector<int>&    indices,
+                                     double /*currentMetric*/, // Not used in this implementation (assuming MSE based gain)
+                                     const ISplitCriterion&     /*criterion*/) const // Not used in this implementation
+{
+    const double* base = data.data();
+    const size_t stride = static_cast<size_t>(rowLength);
+    return exhaustiveSearch([=](int f) { return StridedColumn{base + f, stride}; },
+                            rowLength, labels, indices.data(), indices.size(),
+                            SortPerNode{indices.data(), indices.size()});
+}
+
+std::tuple<int, double, double>
+ExhaustiveSplitFinder::findBestSplit(const FeatureMatrix&      X,
+                                     const std::vector<double>& labels,
+                                     const std::vector<int>&    indices,
+                                     double /*currentMetric*/,
+                                     const ISplitCriterion&     /*criterion*/) const
+{
+    // One instantiation per storage type; loads widen to double inside the kernel
+    return X.visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        return exhaustiveSearch([&X](int f) { return X.columnAs<T>(f); },
+                                X.numFeatures(), labels, indices.data(), indices.size(),
+                                SortPerNode{indices.data(), indices.size()});
+    });
+}
+
+std::tuple<int, double, double>
+ExhaustiveSplitFinder::findBestSplit(const FeatureMatrix&      X,
+                                     const std::vector<double>& labels,
+                                     const std::vector<int>&    indices,
+                                     const std::vector<int>&    counts,
+                                     double /*currentMetric*/,
+                                     const ISplitCriterion&     /*criterion*/) const
+{
+    const int* w = counts.data();
+    return X.visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        return exhaustiveSearch([&X](int f) { return X.columnAs<T>(f); },
+                                X.numFeatures(), labels, indices.data(), indices.size(),
+                                SortPerNode{indices.data(), indices.size()},
+                                [w](int row) { return static_cast<double>(w[row]); });
+    });
+}
+
+std::tuple<int, double, double>
+ExhaustiveSplitFinder::findBestSplit(const FeatureMatrix&      X,
+                                     const std::vector<double>& labels,
+                                     const SortedRows&          node,
+                                     const std::vector<int>*    counts,
+                                     double /*currentMetric*/,
+                                     const ISplitCriterion&     /*criterion*/) const
+{
+    // Same scan as above with the per-feature sort taken from the builder
+    return X.visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        auto columnOf = [&X](int f) { return X.columnAs<T>(f); };
+        if (counts) {
+            const int* w = counts->data();
+            return exhaustiveSearch(columnOf, X.numFeatures(), labels,
+                                    node.order(0), node.count, PresortedOrder{node},
+                                    [w](int row) { return static_cast<double>(w[row]); });
+        }
+        return exhaustiveSearch(columnOf, X.numFeatures(), labels,
+                                node.order(0), node.count, PresortedOrder{node});
+    });
+}
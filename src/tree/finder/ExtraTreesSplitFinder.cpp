@@ -0,0 +1,201 @@
+// src/tree/finder/ExtraTreesSplitFinder.cpp
+#include "finder/ExtraTreesSplitFinder.hpp"
+#include "tuning/ParallelCalibration.hpp"
+#include "functions/random/CounterRng.hpp"
+#include <limits>
+#include <vector>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+struct UnitWeight {
+    double operator()(int) const { return 1.0; }
+};
+
+// (weight, sum, sum of squares) of the rows falling between two thresholds
+struct Bucket {
+    double w;
+    double s;
+    double ss;
+};
+
+// Same contract as the random finder's kernel: `columnOf(f)` yields a
+// row-indexable view of feature f, `weightOf(row)` the row's multiplicity.
+template <typename ColumnOf, typename WeightOf = UnitWeight>
+std::tuple<int, double, double>
+extraSearch(ColumnOf                     columnOf,
+            int                          D,
+            const std::vector<double>&   y,
+            const int*                   idx,
+            int                          nIdx,
+            double                       parentMetric,
+            int                          k,
+            uint32_t                     seed,
+            WeightOf                     weightOf = WeightOf{})
+{
+    if (nIdx < 2) {
+        return {-1, 0.0, 0.0};
+    }
+
+    const bool useParallel =
+        static_cast<size_t>(nIdx) >= ParallelCalibration::cutoffs().finderParallelMinSamples;
+
+    // Draws per (node, feature); the node is identified by its row set
+    const uint32_t nodeKey = CounterRng::digest(idx, idx + nIdx);
+
+    std::vector<double> bestThrPerFeature(D, 0.0);
+    std::vector<double> bestGainPerFeature(D, -std::numeric_limits<double>::infinity());
+
+    auto processFeature = [&](int f) {
+        const auto col = columnOf(f);
+
+        // 1) Range of the feature in this node
+        double vMin = col[idx[0]];
+        double vMax = vMin;
+        for (int i = 1; i < nIdx; ++i) {
+            const double v = col[idx[i]];
+            vMin = std::min(vMin, v);
+            vMax = std::max(vMax, v);
+        }
+        if (vMax - vMin < 1e-12) {
+            return;   // Constant in this node
+        }
+
+        // 2) k thresholds drawn uniformly in [min, max), sorted so one pass
+        //    can bucket every row between consecutive thresholds
+        static thread_local std::vector<double> thr;
+        static thread_local std::vector<Bucket> buckets;
+        thr.resize(k);
+        CounterRng rng(seed, RngPurpose::SplitThreshold, nodeKey, static_cast<uint32_t>(f));
+        for (int r = 0; r < k; ++r) {
+            thr[r] = vMin + rng.uniform() * (vMax - vMin);
+        }
+        std::sort(thr.begin(), thr.end());
+        buckets.assign(k + 1, Bucket{0.0, 0.0, 0.0});
+
+        // 3) One pass: bucket b holds rows with thr[b-1] < x <= thr[b]
+        for (int i = 0; i < nIdx; ++i) {
+            const int row = idx[i];
+            const double v = col[row];
+            const int b = (k == 1)
+                ? (v > thr[0] ? 1 : 0)
+                : static_cast<int>(std::lower_bound(thr.begin(), thr.end(), v) - thr.begin());
+            const double w = weightOf(row);
+            const double yi = y[row];
+            buckets[b].w  += w;
+            buckets[b].s  += w * yi;
+            buckets[b].ss += w * yi * yi;
+        }
+
+        double totW = 0.0, totS = 0.0, totSS = 0.0;
+        for (const Bucket& b : buckets) {
+            totW += b.w;
+            totS += b.s;
+            totSS += b.ss;
+        }
+
+        // 4) Threshold r splits off buckets [0, r] to the left
+        double nL = 0.0, sumL = 0.0, sumSqL = 0.0;
+        double localBestGain = -std::numeric_limits<double>::infinity();
+        double localBestThr  = 0.0;
+        for (int r = 0; r < k; ++r) {
+            nL     += buckets[r].w;
+            sumL   += buckets[r].s;
+            sumSqL += buckets[r].ss;
+            const double nR = totW - nL;
+            if (nL <= 0.0 || nR <= 0.0) continue;   // Empty child
+
+            const double mL = sumL / nL;
+            const double varL = sumSqL / nL - mL * mL;
+            const double sumR = totS - sumL;
+            const double mR = sumR / nR;
+            const double varR = (totSS - sumSqL) / nR - mR * mR;
+            const double gain = parentMetric - (varL * nL + varR * nR) / totW;
+
+            if (gain > localBestGain) {
+                localBestGain = gain;
+                localBestThr  = thr[r];
+            }
+        }
+
+        bestGainPerFeature[f] = localBestGain;
+        bestThrPerFeature[f]  = localBestThr;
+    };
+
+    if (useParallel) {
+        #pragma omp parallel for schedule(dynamic)
+        for (int f = 0; f < D; ++f) {
+            processFeature(f);
+        }
+    } else {
+        for (int f = 0; f < D; ++f) {
+            processFeature(f);
+        }
+    }
+
+    // Reduce in feature order so the result does not depend on scheduling
+    int    bestFeat = -1;
+    double bestThr  = 0.0;
+    double bestGain = -std::numeric_limits<double>::infinity();
+    for (int f = 0; f < D; ++f) {
+        if (bestGainPerFeature[f] > bestGain) {
+            bestGain = bestGainPerFeature[f];
+            bestFeat = f;
+            bestThr  = bestThrPerFeature[f];
+        }
+    }
+    return {bestFeat, bestThr, bestGain};
+}
+
+} // namespace
+
+std::tuple<int, double, double>
+ExtraTreesSplitFinder::findBestSplit(const std::vector<double>& X,
+                                     int                          D,
+                                     const std::vector<double>&   y,
+                                     const std::vector<int>&      idx,
+                                     double                       parentMetric,
+                                     const ISplitCriterion&       /*crit*/) const
+{
+    const double* base = X.data();
+    const size_t stride = static_cast<size_t>(D);
+    return extraSearch([=](int f) { return StridedColumn{base + f, stride}; },
+                       D, y, idx.data(), static_cast<int>(idx.size()),
+                       parentMetric, k_, seed_);
+}
+
+std::tuple<int, double, double>
+ExtraTreesSplitFinder::findBestSplit(const FeatureMatrix&         X,
+                                     const std::vector<double>&   y,
+                                     const std::vector<int>&      idx,
+                                     double                       parentMetric,
+                                     const ISplitCriterion&       /*crit*/) const
+{
+    return X.visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        return extraSearch([&X](int f) { return X.columnAs<T>(f); },
+                           X.numFeatures(), y, idx.data(), static_cast<int>(idx.size()),
+                           parentMetric, k_, seed_);
+    });
+}
+
+std::tuple<int, double, double>
+ExtraTreesSplitFinder::findBestSplit(const FeatureMatrix&         X,
+                                     const std::vector<double>&   y,
+                                     const std::vector<int>&      idx,
+                                     const std::vector<int>&      counts,
+                                     double                       parentMetric,
+                                     const ISplitCriterion&       /*crit*/) const
+{
+    const int* w = counts.data();
+    return X.visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        return extraSearch([&X](int f) { return X.columnAs<T>(f); },
+                           X.numFeatures(), y, idx.data(), static_cast<int>(idx.size()),
+                           parentMetric, k_, seed_,
+                           [w](int row) { return static_cast<double>(w[row]); });
+    });
+}
@@ -6,21 +6,36 @@
 #include <limits>
 #include <vector>
 #include <omp.h>   
+namespace {
+
+// Core search for both layouts; `columnOf(f)` yields a row-indexable view.
+// With `presorted` set, feature f's values are read in the builder's order
+// (no sort) and `counts`, if given, weights the rows: quartiles are taken
+// over the weighted sample and child metrics use the weighted criterion.
+template <typename ColumnOf>
 std::tuple<int, double, double>
-QuartileSplitFinder::findBestSplit(const std::vector<double>& X,   // Feature matrix (row-major)
-                                   int                        D,   // Number of features per row
-                                   const std::vector<double>& y,   // Labels
-                                   const std::vector<int>&    idx, // Current sample indices
-                                   double                     parentMetric,
-                                   const ISplitCriterion&     crit) const
+quartileSearch(ColumnOf                   columnOf,
+               int                        D,   // Number of features per row
+               const std::vector<double>& y,   // Labels
+               const int*                 idx, // Current sample indices
+               size_t                     N,   // Number of (distinct) samples
+               double                     parentMetric,
+               const ISplitCriterion&     crit,
+               const SortedRows*          presorted = nullptr,
+               const std::vector<int>*    counts = nullptr)
 {
-    if (idx.size() < 4) return {-1, 0.0, 0.0};   // Return if insufficient data
+    // Weighted node size; equals N unless training on a weighted view
+    size_t W = N;
+    if (counts) {
+        W = 0;
+        for (size_t i = 0; i < N; ++i) W += (*counts)[idx[i]];
+    }
+    if (W < 4) return {-1, 0.0, 0.0};   // Return if insufficient data
 
     int    bestFeat = -1;
     double bestThr  = 0.0;
     double bestGain = -std::numeric_limits<double>::infinity();
 
-    const size_t N = idx.size(); // Number of samples in current node
     const double EPS = 1e-12;    // Epsilon for floating-point comparisons
 
     /* Iterate over each feature 'f' in parallel */
@@ -33,25 +48,34 @@ QuartileSplitFinder::findBestSplit(const std::vector<double>& X,   // Feature ma
         // ---- Thread-private buffers ----
         std::vector<double> vals;
         vals.reserve(N);
+        std::vector<size_t> cumW;   // Weighted sample count through each sorted value
 
         std::vector<int> leftBuf, rightBuf;
         leftBuf.reserve(N);
         rightBuf.reserve(N);
 
         /* -------- Collect current feature values -------- */
-        for (int i : idx) {
-            vals.emplace_back(X[i * D + f]);
+        const auto col = columnOf(f);
+        const int* rows = presorted ? presorted->order(f) : idx;
+        for (size_t i = 0; i < N; ++i) {
+            vals.emplace_back(col[rows[i]]);
         }
-        if (vals.size() < 4) {
-            continue;  // Re-check: skip if too few values
+        if (counts) {
+            cumW.resize(N);
+            size_t acc = 0;
+            for (size_t i = 0; i < N; ++i) cumW[i] = (acc += (*counts)[rows[i]]);
         }
 
         /* -------- Sort once to get quartiles directly -------- */
-        std::sort(vals.begin(), vals.end());
-        const size_t nVals    = vals.size();
-        const double q1       = vals[static_cast<size_t>(0.25 * (nVals - 1))];
-        const double q2       = vals[static_cast<size_t>(0.50 * (nVals - 1))];
-        const double q3       = vals[static_cast<size_t>(0.75 * (nVals - 1))];
+        if (!presorted) std::sort(vals.begin(), vals.end());
+        auto quantile = [&](double q) {
+            const size_t pos = static_cast<size_t>(q * (W - 1));
+            if (!counts) return vals[pos];
+            return vals[std::upper_bound(cumW.begin(), cumW.end(), pos) - cumW.begin()];
+        };
+        const double q1       = quantile(0.25);
+        const double q2       = quantile(0.50);
+        const double q3       = quantile(0.75);
 
         /* -------- Organize unique thresholds -------- */
         double thrList[3];
@@ -64,20 +88,37 @@ QuartileSplitFinder::findBestSplit(const std::vector<double>& X,   // Feature ma
         for (int t = 0; t < thrCnt; ++t) {
             const double thr = thrList[t];
 
-            leftBuf.clear();
-            rightBuf.clear();
-            for (int i : idx) {
-                if (X[i * D + f] <= thr)
-                    leftBuf.emplace_back(i);
-                else
-                    rightBuf.emplace_back(i);
+            if (presorted) {
+                // Sorted rows: the left child is a prefix
+                const size_t pos = std::upper_bound(vals.begin(), vals.end(), thr) - vals.begin();
+                leftBuf.assign(rows, rows + pos);
+                rightBuf.assign(rows + pos, rows + N);
+            } else {
+                leftBuf.clear();
+                rightBuf.clear();
+                for (size_t i = 0; i < N; ++i) {
+                    if (col[idx[i]] <= thr)
+                        leftBuf.emplace_back(idx[i]);
+                    else
+                        rightBuf.emplace_back(idx[i]);
+                }
             }
             if (leftBuf.empty() || rightBuf.empty()) continue; // Skip if a child node is empty
 
-            const double mL = crit.nodeMetric(y, leftBuf);
-            const double mR = crit.nodeMetric(y, rightBuf);
+            double mL, mR, nL, nR;
+            if (counts) {
+                mL = crit.nodeMetric(y, leftBuf, *counts);
+                mR = crit.nodeMetric(y, rightBuf, *counts);
+                nL = static_cast<double>(cumW[leftBuf.size() - 1]);
+                nR = static_cast<double>(W) - nL;
+            } else {
+                mL = crit.nodeMetric(y, leftBuf);
+                mR = crit.nodeMetric(y, rightBuf);
+                nL = static_cast<double>(leftBuf.size());
+                nR = static_cast<double>(rightBuf.size());
+            }
             const double gain = parentMetric -
-                                (mL * leftBuf.size() + mR * rightBuf.size()) / static_cast<double>(N);
+                                (mL * nL + mR * nR) / static_cast<double>(W);
 
             if (gain > localBestGain) {
                 localBestGain = gain;
@@ -97,4 +138,51 @@ QuartileSplitFinder::findBestSplit(const std::vector<double>& X,   // Feature ma
     } // End of parallel for loop
 
     return {bestFeat, bestThr, bestGain};
-}
\ No newline at end of file
+}
+
+} // namespace
+
+std::tuple<int, double, double>
+QuartileSplitFinder::findBestSplit(const std::vector<double>& X,   // Feature matrix (row-major)
+                                   int                        D,   // Number of features per row
+                                   const std::vector<double>& y,   // Labels
+                                   const std::vector<int>&    idx, // Current sample indices
+                                   double                     parentMetric,
+                                   const ISplitCriterion&     crit) const
+{
+    const double* base = X.data();
+    const size_t stride = static_cast<size_t>(D);
+    return quartileSearch([=](int f) { return StridedColumn{base + f, stride}; },
+                          D, y, idx.data(), idx.size(), parentMetric, crit);
+}
+
+std::tuple<int, double, double>
+QuartileSplitFinder::findBestSplit(const FeatureMatrix&       X,
+                                   const std::vector<double>& y,
+                                   const std::vector<int>&    idx,
+                                   double                     parentMetric,
+                                   const ISplitCriterion&     crit) const
+{
+    // One instantiation per storage type; loads widen to double inside the kernel
+    return X.visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        return quartileSearch([&X](int f) { return X.columnAs<T>(f); },
+                              X.numFeatures(), y, idx.data(), idx.size(), parentMetric, crit);
+    });
+}
+
+std::tuple<int, double, double>
+QuartileSplitFinder::findBestSplit(const FeatureMatrix&       X,
+                                   const std::vector<double>& y,
+                                   const SortedRows&          node,
+                                   const std::vector<int>*    counts,
+                                   double                     parentMetric,
+                                   const ISplitCriterion&     crit) const
+{
+    return X.visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        return quartileSearch([&X](int f) { return X.columnAs<T>(f); },
+                              X.numFeatures(), y, node.order(0), node.count,
+                              parentMetric, crit, &node, counts);
+    });
+}
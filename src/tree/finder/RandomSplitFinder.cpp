@@ -1,7 +1,8 @@
 // src/tree/finder/RandomSplitFinder.cpp
 #include "finder/RandomSplitFinder.hpp"
+#include "tuning/ParallelCalibration.hpp"
+#include "functions/random/CounterRng.hpp"
 #include <limits>
-#include <random>
 #include <vector>
 #include <algorithm>
 #include <cmath>
@@ -9,85 +10,102 @@
 #include <omp.h>
 #endif
 
+namespace {
+
+struct UnitWeight {
+    double operator()(int) const { return 1.0; }
+};
+
+struct Sample {
+    double x;
+    double y;
+    double w;
+};
+
+// Core search shared by the row-major and column-major entry points;
+// `columnOf(f)` yields a row-indexable view of feature f and `weightOf(row)`
+// the row's multiplicity (1 unless training on a weighted bootstrap view).
+// With `presorted` set, the node's rows are read in the builder's per-feature
+// order and the per-node sort is skipped; `idx` is unused then.
+template <typename ColumnOf, typename WeightOf = UnitWeight>
 std::tuple<int, double, double>
-RandomSplitFinder::findBestSplit(const std::vector<double>& X,
-                                 int                          D,
-                                 const std::vector<double>&   y,
-                                 const std::vector<int>&      idx,
-                                 double                       parentMetric, // Parent node's impurity metric (e.g., MSE)
-                                 const ISplitCriterion&       crit) const // Not directly used for gain calculation in this optimized version
+randomSearch(ColumnOf                     columnOf,
+             int                          D,
+             const std::vector<double>&   y,
+             const int*                   idx,
+             int                          nIdx,         // Number of samples in the current node
+             double                       parentMetric, // Parent node's impurity metric (e.g., MSE)
+             int                          k_,
+             uint32_t                     seed,
+             WeightOf                     weightOf = WeightOf{},
+             const SortedRows*            presorted = nullptr)
 {
-    const int nIdx = static_cast<int>(idx.size()); // Number of samples in the current node
     if (nIdx < 2) {
         return {-1, 0.0, 0.0}; // Not enough samples to split
     }
 
     // Adaptive threshold: Use serial processing for small nodes
-    const int PARALLEL_THRESHOLD = 1000;
-    bool useParallel = (nIdx >= PARALLEL_THRESHOLD);
+    bool useParallel = (static_cast<size_t>(nIdx) >= ParallelCalibration::cutoffs().finderParallelMinSamples);
 
     int    globalBestFeat  = -1;
     double globalBestThr   = 0.0;
     double globalBestGain  = -std::numeric_limits<double>::infinity();
 
-    // Prepare seeds for each thread for parallel execution
-    int maxThreads = 1;
-#ifdef _OPENMP
-    maxThreads = omp_get_max_threads();
-#endif
-    std::vector<uint32_t> threadSeeds(maxThreads);
-    {
-        // Serially generate unique seeds for each thread
-        std::mt19937 seedGen(gen_()); // Use the finder's base generator as initial seed
-        std::uniform_int_distribution<uint32_t> seedDist(0, 0xFFFFFFFF);
-        for (int t = 0; t < maxThreads; ++t) {
-            threadSeeds[t] = seedDist(seedGen);
-        }
-    }
+    // Thresholds come from a counter-based stream per (node, feature); the
+    // node is identified by its row set, so the draws do not depend on the
+    // thread count, the scheduling or the order in which nodes are split
+    const uint32_t nodeKey = CounterRng::digest(idx, idx + nIdx);
 
-    // Thread-local storage for best split found by each thread
-    std::vector<int>    bestFeatPerThread(maxThreads, -1);
-    std::vector<double> bestThrPerThread(maxThreads, 0.0);
-    std::vector<double> bestGainPerThread(maxThreads,
-                                          -std::numeric_limits<double>::infinity());
+    // Best split found for each feature, reduced in feature order
+    std::vector<double> bestThrPerFeature(D, 0.0);
+    std::vector<double> bestGainPerFeature(D,
+                                           -std::numeric_limits<double>::infinity());
 
     // Lambda function to encapsulate the logic for processing a single feature
     // This will be called by each thread (or serially)
-    auto processFeature = [&](int f, int tid) {
+    auto processFeature = [&](int f) {
         // 1) Extract feature values and corresponding labels for current node samples
-        static thread_local std::vector<std::pair<double,double>> vals; // Thread-local buffer
+        static thread_local std::vector<Sample> vals; // Thread-local buffer
         vals.clear();
         vals.reserve(nIdx);
+        const auto col = columnOf(f);
+        const int* rows = presorted ? presorted->order(f) : idx;
         for (int i = 0; i < nIdx; ++i) {
-            int sampleIdx = idx[i];
-            double xv = X[sampleIdx * D + f];
-            vals.emplace_back(xv, y[sampleIdx]);
+            int sampleIdx = rows[i];
+            double xv = col[sampleIdx];
+            vals.push_back({xv, y[sampleIdx], weightOf(sampleIdx)});
         }
 
-        // 2) Sort by feature value
-        std::sort(vals.begin(), vals.end(),
-                  [](auto &a, auto &b) { return a.first < b.first; });
+        // 2) Sort by feature value (already in order when presorted)
+        if (!presorted) {
+            std::sort(vals.begin(), vals.end(),
+                      [](const Sample& a, const Sample& b) { return a.x < b.x; });
+        }
 
         // 3) Construct prefix sum arrays:
         //    prefixSum[i] = sum of labels up to index i-1
         //    prefixSumSq[i] = sum of squared labels up to index i-1
         //    sortedX stores the sorted feature values
-        static thread_local std::vector<double> prefixSum, prefixSumSq, sortedX; // Thread-local buffers
+        //    prefixW[i] = total weight up to index i-1 (= i when unweighted)
+        static thread_local std::vector<double> prefixSum, prefixSumSq, prefixW, sortedX; // Thread-local buffers
         prefixSum.resize(nIdx + 1);
         prefixSumSq.resize(nIdx + 1);
+        prefixW.resize(nIdx + 1);
         sortedX.resize(nIdx);
         prefixSum[0]   = 0.0;
         prefixSumSq[0] = 0.0;
+        prefixW[0]     = 0.0;
         for (int i = 0; i < nIdx; ++i) {
-            sortedX[i] = vals[i].first;
-            double yi  = vals[i].second;
-            prefixSum[i+1]   = prefixSum[i]   + yi;
-            prefixSumSq[i+1] = prefixSumSq[i] + yi * yi;
+            sortedX[i] = vals[i].x;
+            double yi  = vals[i].y;
+            double wi  = vals[i].w;
+            prefixSum[i+1]   = prefixSum[i]   + wi * yi;
+            prefixSumSq[i+1] = prefixSumSq[i] + wi * yi * yi;
+            prefixW[i+1]     = prefixW[i]     + wi;
         }
 
         // 4) Perform k_ random threshold trials based on parentMetric (MSE)
-        std::mt19937 localGen(threadSeeds[tid]); // Thread-specific random generator
-        std::uniform_real_distribution<double> uni01(0.0, 1.0); // For generating random thresholds
+        CounterRng rng(seed, RngPurpose::SplitThreshold, nodeKey, static_cast<uint32_t>(f));
 
         double vMin = sortedX.front();
         double vMax = sortedX.back();
@@ -99,7 +117,7 @@ RandomSplitFinder::findBestSplit(const std::vector<double>& X,
         double localBestThr  = 0.0;
 
         for (int r = 0; r < k_; ++r) {
-            double thr = vMin + uni01(localGen) * (vMax - vMin); // Generate random threshold within range
+            double thr = vMin + rng.uniform() * (vMax - vMin); // Generate random threshold within range
             
             // Binary search to find position 'pos' (first element > thr)
             int pos = int(std::upper_bound(sortedX.begin(), sortedX.end(), thr) - sortedX.begin());
@@ -111,7 +129,7 @@ RandomSplitFinder::findBestSplit(const std::vector<double>& X,
             // Left child: [0, pos), Right child: [pos, nIdx)
             double sumL   = prefixSum[pos];
             double sumSqL = prefixSumSq[pos];
-            double nL     = static_cast<double>(pos);
+            double nL     = prefixW[pos];
             double mL     = sumL / nL;
             double varL   = (sumSqL / nL) - (mL * mL); // Variance (MSE) of left child
 
@@ -119,14 +137,14 @@ RandomSplitFinder::findBestSplit(const std::vector<double>& X,
             double sumSqTotal = prefixSumSq[nIdx];
             double sumR       = sumTotal - sumL;
             double sumSqR     = sumSqTotal - sumSqL;
-            double nR         = static_cast<double>(nIdx - pos);
+            double nR         = prefixW[nIdx] - nL;
             double mR         = sumR / nR;
             double varR       = (sumSqR / nR) - (mR * mR); // Variance (MSE) of right child
 
             // Gain calculation: parent MSE - weighted average of child MSEs
             double msel = varL;
             double mser = varR;
-            double gain = parentMetric - (msel * nL + mser * nR) / (double)nIdx;
+            double gain = parentMetric - (msel * nL + mser * nR) / prefixW[nIdx];
 
             if (gain > localBestGain) {
                 localBestGain = gain;
@@ -134,43 +152,106 @@ RandomSplitFinder::findBestSplit(const std::vector<double>& X,
             }
         }
 
-        // Update thread-local best result for the current feature
-        if (localBestGain > bestGainPerThread[tid]) {
-            bestGainPerThread[tid] = localBestGain;
-            bestFeatPerThread[tid] = f;
-            bestThrPerThread[tid]  = localBestThr;
-        }
+        bestGainPerFeature[f] = localBestGain;
+        bestThrPerFeature[f]  = localBestThr;
     };
 
     // **Parallel or serial iteration over features**
     if (useParallel) {
-        #pragma omp parallel
-        {
-            int tid = 0;
-#ifdef _OPENMP
-            tid = omp_get_thread_num(); // Get current thread ID
-#endif
-            #pragma omp for schedule(dynamic) // Dynamic scheduling for better load balancing
-            for (int f = 0; f < D; ++f) {
-                processFeature(f, tid); // Each feature is processed by a thread
-            }
+        #pragma omp parallel for schedule(dynamic) // Dynamic scheduling for better load balancing
+        for (int f = 0; f < D; ++f) {
+            processFeature(f); // Each feature is processed by a thread
         }
     } else {
         // Serial iteration for all features
         for (int f = 0; f < D; ++f) {
-            processFeature(f, /*tid=*/0); // Pass 0 for the single thread
+            processFeature(f);
         }
     }
 
-    // **Reduce local bests from all threads to find the global best**
-    for (int t = 0; t < maxThreads; ++t) {
-        double gain = bestGainPerThread[t];
+    // **Reduce per-feature bests in feature order to find the global best**
+    for (int f = 0; f < D; ++f) {
+        double gain = bestGainPerFeature[f];
         if (gain > globalBestGain) {
             globalBestGain  = gain;
-            globalBestFeat  = bestFeatPerThread[t];
-            globalBestThr   = bestThrPerThread[t];
+            globalBestFeat  = f;
+            globalBestThr   = bestThrPerFeature[f];
         }
     }
 
     return {globalBestFeat, globalBestThr, globalBestGain};
-}
\ No newline at end of file
+}
+
+} // namespace
+
+std::tuple<int, double, double>
+RandomSplitFinder::findBestSplit(const std::vector<double>& X,
+                                 int                          D,
+                                 const std::vector<double>&   y,
+                                 const std::vector<int>&      idx,
+                                 double                       parentMetric,
+                                 const ISplitCriterion&       /*crit*/) const // Not directly used for gain calculation in this optimized version
+{
+    const double* base = X.data();
+    const size_t stride = static_cast<size_t>(D);
+    return randomSearch([=](int f) { return StridedColumn{base + f, stride}; },
+                        D, y, idx.data(), static_cast<int>(idx.size()),
+                        parentMetric, k_, seed_);
+}
+
+std::tuple<int, double, double>
+RandomSplitFinder::findBestSplit(const FeatureMatrix&         X,
+                                 const std::vector<double>&   y,
+                                 const std::vector<int>&      idx,
+                                 double                       parentMetric,
+                                 const ISplitCriterion&       /*crit*/) const
+{
+    // One instantiation per storage type; loads widen to double inside the kernel
+    return X.visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        return randomSearch([&X](int f) { return X.columnAs<T>(f); },
+                            X.numFeatures(), y, idx.data(), static_cast<int>(idx.size()),
+                            parentMetric, k_, seed_);
+    });
+}
+
+std::tuple<int, double, double>
+RandomSplitFinder::findBestSplit(const FeatureMatrix&         X,
+                                 const std::vector<double>&   y,
+                                 const std::vector<int>&      idx,
+                                 const std::vector<int>&      counts,
+                                 double                       parentMetric,
+                                 const ISplitCriterion&       /*crit*/) const
+{
+    const int* w = counts.data();
+    return X.visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        return randomSearch([&X](int f) { return X.columnAs<T>(f); },
+                            X.numFeatures(), y, idx.data(), static_cast<int>(idx.size()),
+                            parentMetric, k_, seed_,
+                            [w](int row) { return static_cast<double>(w[row]); });
+    });
+}
+
+std::tuple<int, double, double>
+RandomSplitFinder::findBestSplit(const FeatureMatrix&         X,
+                                 const std::vector<double>&   y,
+                                 const SortedRows&            node,
+                                 const std::vector<int>*      counts,
+                                 double                       parentMetric,
+                                 const ISplitCriterion&       /*crit*/) const
+{
+    const int n = static_cast<int>(node.count);
+    return X.visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        auto columnOf = [&X](int f) { return X.columnAs<T>(f); };
+        if (counts) {
+            const int* w = counts->data();
+            return randomSearch(columnOf, X.numFeatures(), y, node.order(0), n,
+                                parentMetric, k_, seed_,
+                                [w](int row) { return static_cast<double>(w[row]); }, &node);
+        }
+        return randomSearch(columnOf, X.numFeatures(), y, node.order(0), n,
+                            parentMetric, k_, seed_, UnitWeight{}, &node);
+    });
+}
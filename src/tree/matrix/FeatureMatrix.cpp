@@ -0,0 +1,119 @@
+// =============================================================================
+// src/tree/matrix/FeatureMatrix.cpp - Row-major -> column-major transpose
+// =============================================================================
+#include "tree/FeatureMatrix.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+FeatureMatrix::FeatureMatrix(const std::vector<double>& rowMajor,
+                             int numFeatures,
+                             Layout layout,
+                             Storage storage)
+    : rows_(numFeatures > 0 ? rowMajor.size() / numFeatures : 0),
+      cols_(numFeatures),
+      storage_(storage == Storage::Auto ? narrowestExact(rowMajor) : storage) {
+    // Pad every column to a whole number of cache lines so each one starts aligned
+    const std::size_t perLine = kAlignment / bytesPerValue();
+    stride_ = ((rows_ + perLine - 1) / perLine) * perLine;
+
+    replicas_.resize(NumaPlacement::replicaCount());
+    switch (storage_) {
+        case Storage::Float32: transpose<float>(rowMajor); break;
+        case Storage::Int16:   transpose<std::int16_t>(rowMajor); break;
+        default:               transpose<double>(rowMajor); break;
+    }
+
+    if (layout == Layout::Both) rowMajor_ = &rowMajor;
+}
+
+template <typename T>
+void FeatureMatrix::transpose(const std::vector<double>& rowMajor) {
+    // Sized but unwritten: every page is first touched inside the parallel
+    // fill, by the thread owning its rows, instead of by one zeroing thread
+    for (Buffers& b : replicas_) bufferOf<T>(b).resize(stride_ * static_cast<std::size_t>(cols_));
+
+    // Blocked transpose: read a tile of rows once, write each column run contiguously
+    constexpr std::size_t BLOCK = 256;
+    const std::size_t numBlocks = (rows_ + BLOCK - 1) / BLOCK;
+
+    if (replicas_.size() == 1) {
+        T* out = bufferOf<T>(replicas_.front()).data();
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ > 100000)
+        for (std::size_t b = 0; b < numBlocks; ++b) {
+            transposeRows(rowMajor, out, b * BLOCK, std::min(rows_, (b + 1) * BLOCK));
+        }
+        return;
+    }
+
+    // One copy per node, each filled by that node's threads
+    NumaPlacement::forEachReplicaThread([&](int slot, int rank, int count) {
+        T* out = bufferOf<T>(replicas_[slot]).data();
+        const std::size_t b0 = numBlocks * rank / count;
+        const std::size_t b1 = numBlocks * (rank + 1) / count;
+        for (std::size_t b = b0; b < b1; ++b) {
+            transposeRows(rowMajor, out, b * BLOCK, std::min(rows_, (b + 1) * BLOCK));
+        }
+    });
+}
+
+template <typename T>
+void FeatureMatrix::transposeRows(const std::vector<double>& rowMajor, T* out,
+                                  std::size_t begin, std::size_t end) const {
+    for (int f = 0; f < cols_; ++f) {
+        T* dst = out + f * stride_;
+        for (std::size_t i = begin; i < end; ++i) {
+            dst[i] = static_cast<T>(rowMajor[i * cols_ + f]);
+        }
+        if (end == rows_) std::fill(dst + rows_, dst + stride_, T{});
+    }
+}
+
+FeatureMatrix::Storage FeatureMatrix::narrowestExact(const std::vector<double>& values) {
+    bool fitsInt16 = true;
+    bool fitsFloat = true;
+
+    #pragma omp parallel for reduction(&&:fitsInt16,fitsFloat) schedule(static) if(values.size() > 100000)
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        const double v = values[i];
+        fitsInt16 = fitsInt16 && v == std::trunc(v) &&
+                    v >= std::numeric_limits<std::int16_t>::min() &&
+                    v <= std::numeric_limits<std::int16_t>::max();
+        fitsFloat = fitsFloat && static_cast<double>(static_cast<float>(v)) == v;
+    }
+
+    if (fitsInt16) return Storage::Int16;
+    if (fitsFloat) return Storage::Float32;
+    return Storage::Float64;
+}
+
+const char* FeatureMatrix::storageName(Storage storage) {
+    switch (storage) {
+        case Storage::Auto:    return "auto";
+        case Storage::Float32: return "float32";
+        case Storage::Int16:   return "int16";
+        default:               return "float64";
+    }
+}
+
+std::size_t FeatureMatrix::bytesPerValue() const {
+    return visit([](auto tag) { return sizeof(typename decltype(tag)::type); });
+}
+
+std::vector<double> FeatureMatrix::toRowMajor() const {
+    std::vector<double> out(rows_ * cols_);
+    visit([&](auto tag) {
+        using T = typename decltype(tag)::type;
+        const T* src = buffer<T>().data();
+        #pragma omp parallel for schedule(static) if(rows_ * cols_ > 100000)
+        for (std::size_t i = 0; i < rows_; ++i) {
+            for (int f = 0; f < cols_; ++f) {
+                out[i * cols_ + f] = static_cast<double>(src[f * stride_ + i]);
+            }
+        }
+    });
+    return out;
+}
@@ -0,0 +1,41 @@
+// =============================================================================
+// src/tree/matrix/PresortedIndex.cpp - One sort per feature for a whole forest
+// =============================================================================
+#include "tree/PresortedIndex.hpp"
+#include <algorithm>
+#include <numeric>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+PresortedIndex::PresortedIndex(const FeatureMatrix& X)
+    : rows_(X.numRows()), cols_(X.numFeatures()) {
+    order_.resize(rows_ * static_cast<std::size_t>(cols_));
+
+    #pragma omp parallel for schedule(dynamic) if(cols_ > 1 && rows_ > 10000)
+    for (int f = 0; f < cols_; ++f) {
+        int* out = order_.data() + static_cast<std::size_t>(f) * rows_;
+        std::iota(out, out + rows_, 0);
+        X.visitColumn(f, [&](const auto* col) {
+            std::stable_sort(out, out + rows_,
+                             [col](int a, int b) { return col[a] < col[b]; });
+        });
+    }
+}
+
+std::size_t PresortedIndex::filter(const std::vector<int>& counts, std::vector<int>& out) const {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < rows_; ++i) kept += (counts[i] > 0);
+
+    out.resize(kept * static_cast<std::size_t>(cols_));
+    const int* w = counts.data();
+    for (int f = 0; f < cols_; ++f) {
+        const int* src = order(f);
+        int* dst = out.data() + static_cast<std::size_t>(f) * kept;
+        for (std::size_t i = 0; i < rows_; ++i) {
+            const int row = src[i];
+            if (w[row] > 0) *dst++ = row;
+        }
+    }
+    return kept;
+}
@@ -0,0 +1,118 @@
+#include "pruner/CostComplexityCV.hpp"
+#include "pruner/CostComplexityPruner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+// Adds the squared error of every candidate alpha for one held-out row.
+// Critical alphas never increase from root to leaf, so as alpha grows the
+// collapse point only moves up the path and one sweep covers all candidates.
+void accumulateRow(const Node* root,
+                   const std::unordered_map<const Node*, double>& alphas,
+                   const double* sample, double target,
+                   const std::vector<double>& candidates,
+                   std::vector<const Node*>& path,
+                   std::vector<double>& sse) {
+    path.clear();
+    const Node* cur = root;
+    while (cur && !cur->isLeaf && cur->getLeft() && cur->getRight()) {
+        path.push_back(cur);
+        cur = (sample[cur->getFeatureIndex()] <= cur->getThreshold())
+                ? cur->getLeft() : cur->getRight();
+    }
+    const double leafPred = cur ? cur->getPrediction() : 0.0;
+
+    size_t top = path.size();   // First collapsed node on the path; size() = none
+    for (size_t j = 0; j < candidates.size(); ++j) {
+        while (top > 0 && alphas.at(path[top - 1]) <= candidates[j]) --top;
+        const double pred = (top < path.size()) ? path[top]->getNodePrediction() : leafPred;
+        const double diff = target - pred;
+        sse[j] += diff * diff;
+    }
+}
+
+} // namespace
+
+CostComplexityCV::Result CostComplexityCV::select(const Node* fullTree) const {
+    Result result;
+    const auto path = CostComplexityPruner::computePath(fullTree);
+    if (path.alphas.empty()) return result;
+
+    // Breiman's representatives: geometric mean of each alpha interval
+    const size_t K = path.alphas.size();
+    for (size_t k = 0; k < K; ++k) {
+        const double a = path.alphas[k];
+        result.candidates.push_back(k + 1 < K ? std::sqrt(a * path.alphas[k + 1]) : a);
+        result.leaves.push_back(path.leaves[k]);
+    }
+    result.cvError.assign(K, 0.0);
+
+    const size_t n = y_.size();
+    const int folds = std::max(2, std::min<int>(folds_, static_cast<int>(n)));
+    if (n < 2 || K == 1) {
+        result.alpha = result.candidates.front();
+        return result;
+    }
+
+    std::vector<int> foldOf(n);
+    {
+        std::vector<int> perm(n);
+        std::iota(perm.begin(), perm.end(), 0);
+        std::mt19937 gen(seed_);
+        std::shuffle(perm.begin(), perm.end(), gen);
+        for (size_t i = 0; i < n; ++i) foldOf[perm[i]] = static_cast<int>(i % folds);
+    }
+
+    std::vector<std::vector<double>> foldSSE(folds, std::vector<double>(K, 0.0));
+
+    // Folds are independent; each trains on its own copy of the other folds' rows
+    #pragma omp parallel for schedule(dynamic)
+    for (int f = 0; f < folds; ++f) {
+        std::vector<double> Xf, yf;
+        Xf.reserve((n - n / folds + 1) * D_);
+        yf.reserve(n - n / folds + 1);
+        for (size_t i = 0; i < n; ++i) {
+            if (foldOf[i] == f) continue;
+            Xf.insert(Xf.end(), X_.begin() + i * D_, X_.begin() + (i + 1) * D_);
+            yf.push_back(y_[i]);
+        }
+
+        auto trainer = factory_();
+        trainer->train(Xf, D_, yf);
+        const Node* root = trainer->getRoot();
+        const auto alphas = CostComplexityPruner::criticalAlphas(root);
+
+        std::vector<const Node*> pathBuf;
+        for (size_t i = 0; i < n; ++i) {
+            if (foldOf[i] != f) continue;
+            accumulateRow(root, alphas, &X_[i * D_], y_[i],
+                          result.candidates, pathBuf, foldSSE[f]);
+        }
+    }
+
+    for (int f = 0; f < folds; ++f) {
+        for (size_t k = 0; k < K; ++k) result.cvError[k] += foldSSE[f][k];
+    }
+    for (double& e : result.cvError) e /= static_cast<double>(n);
+
+    // Lowest error; ties go to the larger alpha (smaller tree)
+    size_t best = 0;
+    for (size_t k = 1; k < K; ++k) {
+        if (result.cvError[k] <= result.cvError[best]) best = k;
+    }
+    result.alpha = result.candidates[best];
+    return result;
+}
+
+void CostComplexityCV::prune(std::unique_ptr<Node>& root) const {
+    if (!root) return;
+    last_ = select(root.get());
+    CostComplexityPruner(last_.alpha).prune(root);
+}
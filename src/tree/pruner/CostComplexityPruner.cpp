@@ -1,56 +1,142 @@
 #include "pruner/CostComplexityPruner.hpp"
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <queue>
 
-// Helper function: Counts the number of leaf nodes in a subtree
-static int countLeaves(const Node* node) {
-    if (!node || node->isLeaf) return 1; // A null node or a leaf is 1 leaf
-    return countLeaves(node->getLeft()) + countLeaves(node->getRight());
+namespace {
+
+// As a function of alpha, the cost R(T') + alpha * |T'| of the best pruned
+// subtree T' of a node is concave and piecewise linear. It is stored as its
+// last piece (valid beyond every breakpoint) plus a max-heap of breakpoints,
+// each recording by how many leaves the slope drops there. Collapsing a node
+// only ever removes the largest breakpoints of its subtree, so the heap can be
+// popped from the top and children heaps merged small-into-large.
+struct Breakpoint {
+    double alpha;
+    int    leafDrop;
+    bool operator<(const Breakpoint& o) const { return alpha < o.alpha; }
+};
+
+struct CostFunction {
+    std::priority_queue<Breakpoint> breakpoints;
+    double intercept = 0.0;   // Last piece: intercept + slope * alpha
+    int    slope     = 1;
+};
+
+// Post-order pass; records each internal node's raw collapse alpha
+CostFunction buildCost(const Node* node, std::unordered_map<const Node*, double>& raw) {
+    CostFunction fn;
+    const double leafRisk = node->metric * static_cast<double>(node->samples);
+    if (node->isLeaf || !node->getLeft() || !node->getRight()) {
+        fn.intercept = leafRisk;
+        return fn;
+    }
+
+    CostFunction left  = buildCost(node->getLeft(), raw);
+    CostFunction right = buildCost(node->getRight(), raw);
+    if (left.breakpoints.size() < right.breakpoints.size()) std::swap(left, right);
+    while (!right.breakpoints.empty()) {
+        left.breakpoints.push(right.breakpoints.top());
+        right.breakpoints.pop();
+    }
+    fn.breakpoints = std::move(left.breakpoints);
+    fn.intercept = left.intercept + right.intercept;
+    fn.slope     = left.slope + right.slope;
+
+    // Walk back from the last piece until the leaf line leafRisk + alpha meets it
+    double alpha = (leafRisk - fn.intercept) / static_cast<double>(fn.slope - 1);
+    while (!fn.breakpoints.empty() && alpha < fn.breakpoints.top().alpha) {
+        const Breakpoint bp = fn.breakpoints.top();
+        fn.breakpoints.pop();
+        fn.intercept -= bp.leafDrop * bp.alpha;
+        fn.slope     += bp.leafDrop;
+        alpha = (leafRisk - fn.intercept) / static_cast<double>(fn.slope - 1);
+    }
+    alpha = std::max(alpha, 0.0);
+
+    raw[node] = alpha;
+    fn.breakpoints.push({alpha, fn.slope - 1});
+    fn.intercept = leafRisk;
+    fn.slope     = 1;
+    return fn;
+}
+
+// A node also disappears once any ancestor collapses
+void propagateDown(const Node* node, double bound,
+                   std::unordered_map<const Node*, double>& alphas) {
+    if (node->isLeaf || !node->getLeft() || !node->getRight()) return;
+    double& a = alphas[node];
+    a = std::min(a, bound);
+    propagateDown(node->getLeft(), a, alphas);
+    propagateDown(node->getRight(), a, alphas);
 }
 
-// Recursively prunes a subtree and returns its total error (cost without alpha)
-double CostComplexityPruner::pruneRec(Node* n) const {
-    if (n->isLeaf) {
-        // For a leaf node, return its total error (error * number of samples)
-        // Use n->metric, which represents the impurity (e.g., MSE) for this node.
-        return n->metric * n->samples;
+void collapse(Node* node, double alpha, const std::unordered_map<const Node*, double>& alphas) {
+    if (node->isLeaf || !node->getLeft() || !node->getRight()) return;
+    if (alphas.at(node) <= alpha) {
+        const double mean = node->getNodePrediction();
+        node->makeLeaf(mean, mean);
+        return;
     }
-    
-    // Recursively prune child subtrees
-    double errLeft  = pruneRec(n->getLeft());
-    double errRight = pruneRec(n->getRight());
-    
-    // Total error of the current subtree (sum of errors from its children)
-    double subtreeError = errLeft + errRight;
-    
-    // Calculate the number of leaves in the current subtree
-    int subtreeLeaves = countLeaves(n->getLeft()) + countLeaves(n->getRight());
-    
-    // CART complexity comparison:
-    // Cost if this node becomes a leaf: (current node's error * samples) + alpha * 1 (for 1 leaf)
-    double leafCost = n->metric * n->samples + alpha_;
-    
-    // Cost if the subtree is kept: (sum of children's errors) + alpha * (number of leaves in subtree)
-    double subtreeCost = subtreeError + alpha_ * subtreeLeaves;
-    
-    // If making this node a leaf is cheaper or equal in cost, prune it
-    if (leafCost <= subtreeCost) {
-        // The prediction value after pruning this internal node into a leaf
-        // For an internal node being pruned, its prediction becomes the mean of its samples.
-        // getNodePrediction() should provide this mean.
-        double nodePred = n->getNodePrediction(); 
-        
-        // Transform the current node into a leaf node
-        n->makeLeaf(nodePred, nodePred); // Assuming second parameter is also prediction for consistency
-        
-        // Return the total error of the new single leaf node
-        return n->metric * n->samples;  
+    collapse(node->getLeft(), alpha, alphas);
+    collapse(node->getRight(), alpha, alphas);
+}
+
+} // namespace
+
+std::unordered_map<const Node*, double> CostComplexityPruner::criticalAlphas(const Node* root) {
+    std::unordered_map<const Node*, double> alphas;
+    if (!root) return alphas;
+    buildCost(root, alphas);
+    propagateDown(root, std::numeric_limits<double>::infinity(), alphas);
+    return alphas;
+}
+
+CostComplexityPath CostComplexityPruner::computePath(const Node* root) {
+    CostComplexityPath path;
+    if (!root) return path;
+
+    std::unordered_map<const Node*, double> raw;
+    CostFunction fn = buildCost(root, raw);
+
+    // Surviving breakpoints are exactly the critical alphas; unwind them from
+    // the root-only piece back to alpha = 0, then reverse into ascending order.
+    std::vector<double> alphas;
+    std::vector<int> leaves;
+    std::vector<double> risks;
+    while (!fn.breakpoints.empty()) {
+        const Breakpoint bp = fn.breakpoints.top();
+        fn.breakpoints.pop();
+        alphas.push_back(bp.alpha);
+        leaves.push_back(fn.slope);
+        risks.push_back(fn.intercept);
+        fn.intercept -= bp.leafDrop * bp.alpha;
+        fn.slope     += bp.leafDrop;
     }
-    
-    // If keeping the subtree is cheaper, return the total error of the subtree
-    return subtreeError;
+    alphas.push_back(0.0);
+    leaves.push_back(fn.slope);
+    risks.push_back(fn.intercept);
+
+    // Ties (several links with the same alpha, up to round-off of the
+    // intercept updates) collapse into one step
+    constexpr double TIE_TOL = 1e-9;
+    for (size_t k = alphas.size(); k-- > 0;) {
+        if (!path.alphas.empty() && alphas[k] - path.alphas.back() <= TIE_TOL * path.alphas.back()) {
+            path.leaves.back() = leaves[k];
+            path.risks.back()  = risks[k];
+            continue;
+        }
+        path.alphas.push_back(alphas[k]);
+        path.leaves.push_back(leaves[k]);
+        path.risks.push_back(risks[k]);
+    }
+    return path;
 }
 
 // Entry point for pruning the entire tree
 void CostComplexityPruner::prune(std::unique_ptr<Node>& root) const {
-    if (root) pruneRec(root.get()); // Only prune if the root exists
-}
\ No newline at end of file
+    if (!root) return;
+    const auto alphas = criticalAlphas(root.get());
+    collapse(root.get(), alpha_, alphas);
+}
@@ -1,82 +1,116 @@
 #include "pruner/ReducedErrorPruner.hpp"
+#include "tuning/ParallelCalibration.hpp"
 #include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
-// Validates the Mean Squared Error (MSE) of the tree (or subtree) on the validation set.
-double ReducedErrorPruner::validate(Node* n) const {
-    double mse = 0.0;
-    for (size_t i = 0; i < yv_.size(); ++i) {
-        const double* sample = &Xv_[i * D_]; // Get validation sample features
-        Node* cur = n; // Start traversal from the given node
-        // Traverse down the tree until a leaf node is reached
-        while (!cur->isLeaf) {
-            cur = (sample[cur->getFeatureIndex()] <= cur->getThreshold())
-                    ? cur->getLeft() : cur->getRight();
-        }
-        // Calculate squared difference between actual and predicted value
-        double diff = yv_[i] - cur->getPrediction();
-        mse += diff * diff;
-    }
-    return mse / yv_.size(); // Return average MSE
+namespace {
+
+inline bool isSplit(const Node* n) {
+    return !n->isLeaf && n->getLeft() && n->getRight();
 }
 
-// Recursively prunes the tree based on Reduced Error Pruning logic.
-void ReducedErrorPruner::pruneRec(std::unique_ptr<Node>& n) const {
-    if (!n || n->isLeaf) return; // Base case: if node is null or already a leaf, do nothing
-    
-    // First, recursively prune the child subtrees
-    pruneRec(n->leftChild);
-    pruneRec(n->rightChild);
-    
-    // Backup the current node's state before attempting to prune
-    bool oldIsLeaf = n->isLeaf;
-    double oldPred = n->isLeaf ? n->getPrediction() : 0.0; // Backup prediction if it was a leaf
-    
-    // Temporarily move child nodes to backups to allow modification of 'n'
-    auto leftBackup  = std::move(n->leftChild);
-    auto rightBackup = std::move(n->rightChild);
+// Prediction a node gives once it is (or is turned into) a leaf
+inline double leafValue(const Node* n) {
+    return n->isLeaf ? n->getPrediction() : n->getNodePrediction();
+}
 
-    // Attempt to transform the current node into a leaf node
-    // Calculate the prediction value if it were a leaf (e.g., mean of samples in this node)
-    double leafPrediction = n->getNodePrediction(); // Assumes this method computes the mean for the node's samples
-    if (leafPrediction == 0.0 && !oldIsLeaf) { // Fallback if getNodePrediction is not implemented or returns 0.0 for internal nodes
-        // If no node prediction stored, use existing prediction if it was already a leaf, or default 0.0
-        // This part needs careful consideration based on actual Node class implementation.
-        // For a regression tree, typically `getNodePrediction` for an internal node would calculate the mean of its training labels.
-        leafPrediction = 0.0; 
+void collapseMarked(Node* n, int id, const std::vector<char>& prune,
+                    const std::vector<int>& leftId, const std::vector<int>& rightId) {
+    if (!isSplit(n)) return;
+    if (prune[id]) {
+        const double pred = n->getNodePrediction();
+        n->makeLeaf(pred, pred);
+        return;
     }
-    
-    // Make the current node a leaf with the calculated prediction
-    n->makeLeaf(leafPrediction, leafPrediction); // Assuming two arguments for prediction
+    collapseMarked(n->getLeft(), leftId[id], prune, leftId, rightId);
+    collapseMarked(n->getRight(), rightId[id], prune, leftId, rightId);
+}
 
-    // Validate the MSE of the tree *after* pruning this specific node (and its already pruned children)
-    double msePruned = validate(n.get());
-    
-    // Restore the node's original subtree state to calculate its original error
-    n->isLeaf = oldIsLeaf; // Restore leaf status
-    n->leftChild  = std::move(leftBackup);  // Restore left child
-    n->rightChild = std::move(rightBackup); // Restore right child
-    
-    // Update internal pointers if it was an internal node
-    if (!n->isLeaf) {
-        n->info.internal.left = n->leftChild.get();
-        n->info.internal.right = n->rightChild.get();
-    } else {
-        // Restore leaf prediction if it was originally a leaf (shouldn't happen here if `oldIsLeaf` is true from start)
-        n->info.leaf.prediction = oldPred;
-    }
-    
-    // Validate the MSE of the tree *before* pruning this specific node (original subtree)
-    double mseOriginal = validate(n.get());
+} // namespace
 
-    // If pruning this node (making it a leaf) does not increase validation MSE (or decreases it), keep it pruned.
-    if (msePruned <= mseOriginal) {
-        // Finalize pruning: make the node a leaf
-        n->makeLeaf(leafPrediction, leafPrediction);
+std::vector<double> ReducedErrorPruner::leafErrors(const std::vector<const Node*>& nodes,
+                                                   const std::vector<int>& leftId,
+                                                   const std::vector<int>& rightId) const {
+    const size_t numNodes = nodes.size();
+    const size_t n = yv_.size();
+    std::vector<double> err(numNodes, 0.0);
+    const bool useParallel = n > ParallelCalibration::cutoffs().reductionParallelMinSamples;
+
+    #pragma omp parallel if(useParallel)
+    {
+        std::vector<double> localErr(numNodes, 0.0);
+
+        #pragma omp for schedule(static)
+        for (size_t i = 0; i < n; ++i) {
+            const double* sample = &Xv_[i * D_];
+            const double y = yv_[i];
+            int id = 0;
+            for (;;) {
+                const Node* cur = nodes[id];
+                const double diff = y - leafValue(cur);
+                localErr[id] += diff * diff;
+                if (!isSplit(cur)) break;
+                id = (sample[cur->getFeatureIndex()] <= cur->getThreshold())
+                         ? leftId[id] : rightId[id];
+            }
+        }
+
+        #pragma omp critical
+        {
+            for (size_t k = 0; k < numNodes; ++k) err[k] += localErr[k];
+        }
     }
-    // Otherwise, the node's state has already been restored to its original (unpruned) form by the backup/restore steps.
+    return err;
 }
 
-// Entry point for pruning the entire tree.
 void ReducedErrorPruner::prune(std::unique_ptr<Node>& root) const {
-    pruneRec(root);
-}
\ No newline at end of file
+    if (!root || yv_.empty()) return;
+
+    // Preorder ids, so every child id is larger than its parent's
+    std::vector<const Node*> nodes;
+    std::vector<int> leftId, rightId;
+    {
+        std::vector<std::pair<const Node*, int>> stack{{root.get(), -1}};  // (node, parent id)
+        while (!stack.empty()) {
+            auto [node, parent] = stack.back();
+            stack.pop_back();
+            const int id = static_cast<int>(nodes.size());
+            nodes.push_back(node);
+            leftId.push_back(-1);
+            rightId.push_back(-1);
+            if (parent >= 0) {
+                (nodes[parent]->getLeft() == node ? leftId : rightId)[parent] = id;
+            }
+            if (isSplit(node)) {
+                stack.push_back({node->getRight(), id});
+                stack.push_back({node->getLeft(), id});
+            }
+        }
+    }
+
+    const std::vector<double> asLeaf = leafErrors(nodes, leftId, rightId);
+
+    // Children have larger preorder ids, so a reverse sweep is bottom-up.
+    // Pruning a node only changes the error of the rows that reach it, so the
+    // local comparison equals comparing whole-set validation MSE.
+    const int numNodes = static_cast<int>(nodes.size());
+    std::vector<double> subtreeErr(numNodes);
+    std::vector<char> prune(numNodes, 0);
+    for (int id = numNodes - 1; id >= 0; --id) {
+        if (!isSplit(nodes[id])) {
+            subtreeErr[id] = asLeaf[id];
+            continue;
+        }
+        const double kept = subtreeErr[leftId[id]] + subtreeErr[rightId[id]];
+        if (asLeaf[id] <= kept) {
+            prune[id] = 1;
+            subtreeErr[id] = asLeaf[id];
+        } else {
+            subtreeErr[id] = kept;
+        }
+    }
+
+    collapseMarked(root.get(), 0, prune, leftId, rightId);
+}
@@ -4,6 +4,7 @@
 #include "tree/trainer/SingleTreeTrainer.hpp"
 #include "tree/Node.hpp"
 #include "pruner/MinGainPrePruner.hpp" // For pre-pruning check
+#include "tuning/ParallelCalibration.hpp" // Per-machine parallel cutoffs
 #include <numeric>     // For std::iota
 #include <cmath>       // For std::abs
 #include <iostream>    // For std::cout
@@ -95,10 +96,61 @@ SingleTreeTrainer::SingleTreeTrainer(std::unique_ptr<ISplitFinder> finder,
 void SingleTreeTrainer::train(const std::vector<double>& data,
                               int rowLength,
                               const std::vector<double>& labels) {
+    // Transpose once so every per-feature scan below reads contiguous memory
+    const FeatureMatrix X(data, rowLength);
+    train(X, labels);
+}
+
+void SingleTreeTrainer::train(const FeatureMatrix& X,
+                              const std::vector<double>& labels) {
+    sampleCounts_ = nullptr;
+    std::vector<int> rootIndices(labels.size());
+    std::iota(rootIndices.begin(), rootIndices.end(), 0); // Fill with 0, 1, 2, ... N-1
+    trainOnRows(X, labels, std::move(rootIndices));
+}
+
+void SingleTreeTrainer::train(const FeatureMatrix& X,
+                              const std::vector<double>& labels,
+                              const std::vector<int>& counts) {
+    // Distinct rows only; duplicates are carried by their count
+    std::vector<int> rootIndices;
+    rootIndices.reserve(labels.size());
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (counts[i] > 0) rootIndices.push_back(static_cast<int>(i));
+    }
+    sampleCounts_ = &counts;
+    trainOnRows(X, labels, std::move(rootIndices));
+    sampleCounts_ = nullptr;
+}
+
+void SingleTreeTrainer::train(const FeatureMatrix& X,
+                              const std::vector<double>& labels,
+                              const std::vector<int>& counts,
+                              const PresortedIndex& presort) {
+    sampleCounts_ = &counts;
+    presorted_ = &presort;
+    trainOnRows(X, labels, {});   // Rows come from the presorted order
+    presorted_ = nullptr;
+    sampleCounts_ = nullptr;
+}
+
+void SingleTreeTrainer::train(const FeatureMatrix& X,
+                              const std::vector<double>& labels,
+                              const PresortedIndex& presort) {
+    sampleCounts_ = nullptr;
+    presorted_ = &presort;
+    trainOnRows(X, labels, {});
+    presorted_ = nullptr;
+}
+
+void SingleTreeTrainer::trainOnRows(const FeatureMatrix& X,
+                                    const std::vector<double>& labels,
+                                    std::vector<int>&& rootIndices) {
     
     auto trainStart = std::chrono::high_resolution_clock::now(); // Start timing tree building
     
     root_ = std::make_unique<Node>(); // Initialize the root node
+    rowLeaf_.assign(labels.size(), nullptr);
     
     // **Removed omp_set_num_threads call, now controlled by environment variable**
     int numThreads = 1;
@@ -107,27 +159,29 @@ void SingleTreeTrainer::train(const std::vector<double>& data,
     std::cout << "Using " << numThreads << " OpenMP threads (controlled by OMP_NUM_THREADS)" << std::endl;
     #endif
     
-    // Pre-allocate and fill root indices
-    std::vector<int> rootIndices(labels.size());
-    std::iota(rootIndices.begin(), rootIndices.end(), 0); // Fill with 0, 1, 2, ... N-1
-    
     // **Professor's suggested task queue/thread pool pattern**
-    // Use task queue for large datasets and multiple threads
-    const bool useTaskQueue = (labels.size() > 1000 && numThreads > 1);
-    
-    if (useTaskQueue) {
+    // Use task queue for large datasets and multiple threads (cutoff is calibrated per machine)
+    const auto& cutoffs = ParallelCalibration::cutoffs();
+    const bool useTaskQueue = (rootIndices.size() > cutoffs.taskQueueMinSamples && numThreads > 1);
+    
+    if (presorted_) {
+        std::cout << "Presorted features, using sort-free recursive strategy" << std::endl;
+        buildPresorted(X, labels);
+    } else if (useTaskQueue) {
         std::cout << "Large dataset detected, using task queue strategy" << std::endl;
-        buildTreeWithTaskQueue(data, rowLength, labels, std::move(rootIndices));
+        buildTreeWithTaskQueue(X, labels, std::move(rootIndices));
     } else {
         std::cout << "Small dataset, using optimized recursive strategy" << std::endl;
         // Use optimized recursive split for smaller datasets
-        splitNodeOptimized(root_.get(), data, rowLength, labels, rootIndices, 0);
+        splitNodeOptimized(root_.get(), X, labels, rootIndices, 0);
     }
     
     auto splitEnd = std::chrono::high_resolution_clock::now(); // End timing tree building
     
     // Post-pruning phase
     auto pruneStart = std::chrono::high_resolution_clock::now(); // Start timing pruning
+    int grownDepth = 0, grownLeaves = 0;
+    calculateTreeStats(root_.get(), 0, grownDepth, grownLeaves);
     pruner_->prune(root_); // Apply the chosen pruner
     auto pruneEnd = std::chrono::high_resolution_clock::now();   // End timing pruning
     
@@ -140,6 +194,7 @@ void SingleTreeTrainer::train(const std::vector<double>& data,
     
     int treeDepth = 0, leafCount = 0;
     calculateTreeStats(root_.get(), 0, treeDepth, leafCount); // Calculate tree depth and leaf count
+    if (leafCount != grownLeaves) rowLeaf_.clear(); // Pruned leaves were freed
     
     std::cout << "Tree training completed:" << std::endl;
     std::cout << "  Depth: " << treeDepth << " | Leaves: " << leafCount << std::endl;
@@ -149,8 +204,7 @@ void SingleTreeTrainer::train(const std::vector<double>& data,
 }
 
 // **New method: Task queue driven tree building**
-void SingleTreeTrainer::buildTreeWithTaskQueue(const std::vector<double>& data,
-                                               int rowLength,
+void SingleTreeTrainer::buildTreeWithTaskQueue(const FeatureMatrix& X,
                                                const std::vector<double>& labels,
                                                std::vector<int>&& rootIndices) {
     
@@ -163,7 +217,8 @@ void SingleTreeTrainer::buildTreeWithTaskQueue(const std::vector<double>& data,
     taskQueue.push(std::move(rootTask));
     totalTasks++; // Increment total tasks counter
     
-    const int numWorkers = std::min(omp_get_max_threads(), 8); // Limit maximum worker threads
+    const int numWorkers = std::min(omp_get_max_threads(),
+                                    ParallelCalibration::cutoffs().taskQueueMaxWorkers); // Limit maximum worker threads
     
     #pragma omp parallel num_threads(numWorkers) // Create a team of threads
     {
@@ -176,7 +231,7 @@ void SingleTreeTrainer::buildTreeWithTaskQueue(const std::vector<double>& data,
             activeWorkers++; // Increment active worker count
             
             // Process the current task
-            processTask(data, rowLength, labels, std::move(task), taskQueue, totalTasks);
+            processTask(X, labels, std::move(task), taskQueue, totalTasks);
             
             activeWorkers--; // Decrement active worker count
             
@@ -192,8 +247,7 @@ void SingleTreeTrainer::buildTreeWithTaskQueue(const std::vector<double>& data,
 }
 
 // **Task processing method (called by worker threads)**
-void SingleTreeTrainer::processTask(const std::vector<double>& data,
-                                    int rowLength,
+void SingleTreeTrainer::processTask(const FeatureMatrix& X,
                                     const std::vector<double>& labels,
                                     std::unique_ptr<SplitTask> task,
                                     TaskQueue& taskQueue,
@@ -208,40 +262,36 @@ void SingleTreeTrainer::processTask(const std::vector<double>& data,
         return;
     }
     
-    // Calculate node's impurity metric and sample count
-    node->metric = criterion_->nodeMetric(labels, indices);
-    node->samples = indices.size();
+    // Calculate node's impurity metric and sample count (weighted on bootstrap views)
+    const size_t nodeSamples = sampleWeight(indices.data(), indices.data() + indices.size());
+    node->metric = nodeMetric(labels, indices);
+    node->samples = nodeSamples;
     
     // **Efficiently calculate node prediction value (mean of labels)**
-    double sum = 0.0;
-    for (size_t i = 0; i < indices.size(); ++i) {
-        sum += labels[indices[i]];
-    }
-    const double nodePrediction = sum / indices.size();
+    const double nodePrediction = labelSum(labels, indices) / nodeSamples;
+    node->nodeMean = nodePrediction; // Post-pruners collapse internal nodes to this
     
     // **Stopping condition checks**
     if (depth >= maxDepth_ ||                           // Max depth reached
-        indices.size() < 2 * static_cast<size_t>(minSamplesLeaf_) || // Not enough samples to split into two valid leaves
-        indices.size() < 2) {                           // Less than 2 samples (cannot split)
-        node->makeLeaf(nodePrediction, nodePrediction);
+        nodeSamples < 2 * static_cast<size_t>(minSamplesLeaf_) || // Not enough samples to split into two valid leaves
+        indices.size() < 2) {                           // Less than 2 distinct rows (cannot split)
+        makeLeaf(node, nodePrediction, indices);
         return;
     }
 
     // **Find the best split for the current node**
-    auto [bestFeat, bestThr, bestGain] =
-        finder_->findBestSplit(data, rowLength, labels, indices,
-                               node->metric, *criterion_);
+    auto [bestFeat, bestThr, bestGain] = findSplit(X, labels, indices, node->metric);
 
     // If no valid split found (bestFeat < 0) or no gain (bestGain <= 0)
     if (bestFeat < 0 || bestGain <= 0) {
-        node->makeLeaf(nodePrediction, nodePrediction);
+        makeLeaf(node, nodePrediction, indices);
         return;
     }
 
     // **Pre-pruning check (using MinGainPrePruner if available)**
     if (auto* prePruner = dynamic_cast<const MinGainPrePruner*>(pruner_.get())) {
         if (bestGain < prePruner->minGain()) {
-            node->makeLeaf(nodePrediction, nodePrediction);
+            makeLeaf(node, nodePrediction, indices);
             return;
         }
     }
@@ -251,18 +301,20 @@ void SingleTreeTrainer::processTask(const std::vector<double>& data,
     leftIndices.reserve(indices.size());  // Reserve capacity to reduce reallocations
     rightIndices.reserve(indices.size());
     
-    for (int idx_val : indices) { // Renamed 'idx' to 'idx_val' to avoid conflict with 'idx' parameter
-        if (data[idx_val * rowLength + bestFeat] <= bestThr) {
-            leftIndices.push_back(idx_val);
-        } else {
-            rightIndices.push_back(idx_val);
+    X.visitColumn(bestFeat, [&](const auto* splitColumn) {
+        for (int idx_val : indices) { // Renamed 'idx' to 'idx_val' to avoid conflict with 'idx' parameter
+            if (splitColumn[idx_val] <= bestThr) {
+                leftIndices.push_back(idx_val);
+            } else {
+                rightIndices.push_back(idx_val);
+            }
         }
-    }
+    });
     
     // Check if both child nodes meet the minimum sample leaf requirement
-    if (leftIndices.size() < static_cast<size_t>(minSamplesLeaf_) || 
-        rightIndices.size() < static_cast<size_t>(minSamplesLeaf_)) {
-        node->makeLeaf(nodePrediction, nodePrediction); // If not, make current node a leaf
+    if (sampleWeight(leftIndices.data(), leftIndices.data() + leftIndices.size()) < static_cast<size_t>(minSamplesLeaf_) || 
+        sampleWeight(rightIndices.data(), rightIndices.data() + rightIndices.size()) < static_cast<size_t>(minSamplesLeaf_)) {
+        makeLeaf(node, nodePrediction, indices); // If not, make current node a leaf
         return;
     }
 
@@ -291,8 +343,7 @@ void SingleTreeTrainer::processTask(const std::vector<double>& data,
 
 // **Optimized recursive node splitting (retained for smaller datasets)**
 void SingleTreeTrainer::splitNodeOptimized(Node* node,
-                                           const std::vector<double>& data,
-                                           int rowLength,
+                                           const FeatureMatrix& X,
                                            const std::vector<double>& labels,
                                            std::vector<int>& indices, // Indices are mutable for in-place partition
                                            int depth) {
@@ -301,49 +352,36 @@ void SingleTreeTrainer::splitNodeOptimized(Node* node,
         return;
     }
     
-    // Calculate node's impurity metric and sample count
-    node->metric = criterion_->nodeMetric(labels, indices);
-    node->samples = indices.size();
+    // Calculate node's impurity metric and sample count (weighted on bootstrap views)
+    const size_t numSamples = sampleWeight(indices.data(), indices.data() + indices.size());
+    node->metric = nodeMetric(labels, indices);
+    node->samples = numSamples;
     
     // **Efficiently calculate node prediction value (mean of labels)**
-    double sum = 0.0;
-    const size_t numSamples = indices.size();
-    
-    // **Professor's suggestion: Avoid parallel overhead for small datasets**
-    if (numSamples > 1000) {
-        #pragma omp parallel for reduction(+:sum) schedule(static) num_threads(4) // Use 4 threads for sum reduction
-        for (size_t i = 0; i < numSamples; ++i) {
-            sum += labels[indices[i]];
-        }
-    } else {
-        for (size_t i = 0; i < numSamples; ++i) {
-            sum += labels[indices[i]];
-        }
-    }
-    const double nodePrediction = sum / numSamples;
+    const auto& cutoffs = ParallelCalibration::cutoffs();
+    const double nodePrediction = labelSum(labels, indices) / numSamples;
+    node->nodeMean = nodePrediction; // Post-pruners collapse internal nodes to this
     
     // Stopping condition checks (similar to task queue version)
     if (depth >= maxDepth_ || 
-        indices.size() < 2 * static_cast<size_t>(minSamplesLeaf_) ||
+        numSamples < 2 * static_cast<size_t>(minSamplesLeaf_) ||
         indices.size() < 2) {
-        node->makeLeaf(nodePrediction, nodePrediction);
+        makeLeaf(node, nodePrediction, indices);
         return;
     }
 
     // Find the best split
-    auto [bestFeat, bestThr, bestGain] =
-        finder_->findBestSplit(data, rowLength, labels, indices,
-                               node->metric, *criterion_);
+    auto [bestFeat, bestThr, bestGain] = findSplit(X, labels, indices, node->metric);
 
     if (bestFeat < 0 || bestGain <= 0) {
-        node->makeLeaf(nodePrediction, nodePrediction);
+        makeLeaf(node, nodePrediction, indices);
         return;
     }
 
     // Pre-pruning check
     if (auto* prePruner = dynamic_cast<const MinGainPrePruner*>(pruner_.get())) {
         if (bestGain < prePruner->minGain()) {
-            node->makeLeaf(nodePrediction, nodePrediction);
+            makeLeaf(node, nodePrediction, indices);
             return;
         }
     }
@@ -352,18 +390,21 @@ void SingleTreeTrainer::splitNodeOptimized(Node* node,
     // Rearranges elements in 'indices' such that elements satisfying the predicate
     // are moved to the beginning. 'partitionPoint' points to the first element
     // of the second group (elements for right child).
-    auto partitionPoint = std::partition(indices.begin(), indices.end(),
-        [&](int idx_val) { // Renamed 'idx' to 'idx_val'
-            return data[idx_val * rowLength + bestFeat] <= bestThr;
-        });
+    auto partitionPoint = X.visitColumn(bestFeat, [&](const auto* splitColumn) {
+        return std::partition(indices.begin(), indices.end(),
+            [&](int idx_val) { // Renamed 'idx' to 'idx_val'
+                return splitColumn[idx_val] <= bestThr;
+            });
+    });
     
-    const size_t leftSize = std::distance(indices.begin(), partitionPoint);
-    const size_t rightSize = indices.size() - leftSize;
+    const size_t leftSize = sampleWeight(indices.data(),
+                                         indices.data() + std::distance(indices.begin(), partitionPoint));
+    const size_t rightSize = numSamples - leftSize;
     
     // Check min samples per leaf after partitioning
     if (leftSize < static_cast<size_t>(minSamplesLeaf_) || 
         rightSize < static_cast<size_t>(minSamplesLeaf_)) {
-        node->makeLeaf(nodePrediction, nodePrediction);
+        makeLeaf(node, nodePrediction, indices);
         return;
     }
 
@@ -382,33 +423,218 @@ void SingleTreeTrainer::splitNodeOptimized(Node* node,
     
     // **Careful parallel recursion (only for the first few levels)**
     // This uses OpenMP sections for splitting the recursive calls.
-    const bool useParallelRecursion = (depth <= 2) &&           // Only parallelize at shallow depths
-                                     (indices.size() > 2000) && // Only for larger nodes
-                                     (leftIndices.size() > 500 && rightIndices.size() > 500); // Both children are substantial
+    const bool useParallelRecursion = (depth <= cutoffs.recursionMaxDepth) &&           // Only parallelize at shallow depths
+                                     (indices.size() > cutoffs.recursionMinSamples) && // Only for larger nodes
+                                     (leftIndices.size() > cutoffs.recursionMinChildSamples &&
+                                      rightIndices.size() > cutoffs.recursionMinChildSamples); // Both children are substantial
     
     if (useParallelRecursion) {
         #pragma omp parallel sections num_threads(2) // Create 2 sections (threads)
         {
             #pragma omp section // First section for left child
             {
-                splitNodeOptimized(node->leftChild.get(), data, rowLength, 
+                splitNodeOptimized(node->leftChild.get(), X, 
                                   labels, leftIndices, depth + 1);
             }
             #pragma omp section  // Second section for right child
             {
-                splitNodeOptimized(node->rightChild.get(), data, rowLength, 
+                splitNodeOptimized(node->rightChild.get(), X, 
                                   labels, rightIndices, depth + 1);
             }
         }
     } else {
         // Serial recursive processing for deeper levels or smaller nodes
-        splitNodeOptimized(node->leftChild.get(), data, rowLength, 
+        splitNodeOptimized(node->leftChild.get(), X, 
                           labels, leftIndices, depth + 1);
-        splitNodeOptimized(node->rightChild.get(), data, rowLength, 
+        splitNodeOptimized(node->rightChild.get(), X, 
                           labels, rightIndices, depth + 1);
     }
 }
 
+void SingleTreeTrainer::buildPresorted(const FeatureMatrix& X,
+                                       const std::vector<double>& labels) {
+    // O(N) per feature: the replica's sorted order is the global one filtered
+    // by its counts (or copied whole when unweighted), so no tree ever sorts
+    std::vector<int> sorted;
+    size_t m = presorted_->numRows();
+    if (sampleCounts_) {
+        m = presorted_->filter(*sampleCounts_, sorted);
+    } else {
+        sorted.assign(presorted_->order(0), presorted_->order(0) + m * presorted_->numFeatures());
+    }
+    std::vector<char> goesLeft(labels.size(), 0);
+    splitNodePresorted(root_.get(), X, labels, sorted, m, 0, m, 0, goesLeft);
+}
+
+void SingleTreeTrainer::splitNodePresorted(Node* node,
+                                           const FeatureMatrix& X,
+                                           const std::vector<double>& labels,
+                                           std::vector<int>& sorted,
+                                           size_t stride,
+                                           size_t begin,
+                                           size_t end,
+                                           int depth,
+                                           std::vector<char>& goesLeft) {
+    const size_t n = end - begin;
+    if (n == 0) {
+        node->makeLeaf(0.0);
+        return;
+    }
+    const SortedRows rows{sorted.data() + begin, stride, n};
+    
+    // Node statistics are order-free; any feature's run lists the node's rows
+    const std::vector<int> indices(rows.order(0), rows.order(0) + n);
+    const size_t numSamples = sampleWeight(indices.data(), indices.data() + n);
+    node->metric = nodeMetric(labels, indices);
+    node->samples = numSamples;
+    
+    const double nodePrediction = labelSum(labels, indices) / numSamples;
+    node->nodeMean = nodePrediction; // Post-pruners collapse internal nodes to this
+    
+    if (depth >= maxDepth_ ||
+        numSamples < 2 * static_cast<size_t>(minSamplesLeaf_) ||
+        n < 2) {
+        makeLeaf(node, nodePrediction, indices);
+        return;
+    }
+
+    auto [bestFeat, bestThr, bestGain] =
+        finder_->findBestSplit(X, labels, rows, sampleCounts_, node->metric, *criterion_);
+
+    if (bestFeat < 0 || bestGain <= 0) {
+        makeLeaf(node, nodePrediction, indices);
+        return;
+    }
+
+    if (auto* prePruner = dynamic_cast<const MinGainPrePruner*>(pruner_.get())) {
+        if (bestGain < prePruner->minGain()) {
+            makeLeaf(node, nodePrediction, indices);
+            return;
+        }
+    }
+
+    // Mark each row's side once; every feature run is then partitioned by it
+    size_t nLeft = 0;
+    X.visitColumn(bestFeat, [&](const auto* splitColumn) {
+        for (int row : indices) {
+            const bool left = splitColumn[row] <= bestThr;
+            goesLeft[row] = left;
+            nLeft += left;
+        }
+    });
+    const int* splitRun = rows.order(bestFeat);   // Left rows are its prefix
+    const size_t leftSize = sampleWeight(splitRun, splitRun + nLeft);
+    const size_t rightSize = numSamples - leftSize;
+    
+    if (leftSize < static_cast<size_t>(minSamplesLeaf_) ||
+        rightSize < static_cast<size_t>(minSamplesLeaf_)) {
+        makeLeaf(node, nodePrediction, indices);
+        return;
+    }
+
+    // Stable partition keeps both children sorted on every feature
+    std::vector<int> rightBuf(n - nLeft);
+    for (int f = 0; f < X.numFeatures(); ++f) {
+        int* run = sorted.data() + f * stride + begin;
+        size_t l = 0, r = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const int row = run[i];
+            if (goesLeft[row]) run[l++] = row;
+            else               rightBuf[r++] = row;
+        }
+        std::copy(rightBuf.begin(), rightBuf.end(), run + nLeft);
+    }
+
+    node->makeInternal(bestFeat, bestThr);
+    node->leftChild = std::make_unique<Node>();
+    node->rightChild = std::make_unique<Node>();
+    node->info.internal.left = node->leftChild.get();
+    node->info.internal.right = node->rightChild.get();
+
+    // Children own disjoint ranges and rows, so they can grow concurrently
+    const auto& cutoffs = ParallelCalibration::cutoffs();
+    const size_t mid = begin + nLeft;
+    const bool useParallelRecursion = (depth <= cutoffs.recursionMaxDepth) &&
+                                     (n > cutoffs.recursionMinSamples) &&
+                                     (nLeft > cutoffs.recursionMinChildSamples &&
+                                      n - nLeft > cutoffs.recursionMinChildSamples);
+    
+    if (useParallelRecursion) {
+        #pragma omp parallel sections num_threads(2)
+        {
+            #pragma omp section
+            {
+                splitNodePresorted(node->leftChild.get(), X, labels, sorted,
+                                   stride, begin, mid, depth + 1, goesLeft);
+            }
+            #pragma omp section
+            {
+                splitNodePresorted(node->rightChild.get(), X, labels, sorted,
+                                   stride, mid, end, depth + 1, goesLeft);
+            }
+        }
+    } else {
+        splitNodePresorted(node->leftChild.get(), X, labels, sorted,
+                           stride, begin, mid, depth + 1, goesLeft);
+        splitNodePresorted(node->rightChild.get(), X, labels, sorted,
+                           stride, mid, end, depth + 1, goesLeft);
+    }
+}
+
+void SingleTreeTrainer::makeLeaf(Node* node, double prediction, const std::vector<int>& rows) {
+    node->makeLeaf(prediction, prediction);
+    // Sibling subtrees own disjoint rows, so concurrent builders never share a slot
+    for (const int row : rows) rowLeaf_[row] = node;
+}
+
+size_t SingleTreeTrainer::sampleWeight(const int* begin, const int* end) const {
+    if (!sampleCounts_) return static_cast<size_t>(end - begin);
+    const int* counts = sampleCounts_->data();
+    size_t weight = 0;
+    for (const int* it = begin; it != end; ++it) weight += counts[*it];
+    return weight;
+}
+
+double SingleTreeTrainer::labelSum(const std::vector<double>& labels,
+                                   const std::vector<int>& indices) const {
+    double sum = 0.0;
+    const size_t numSamples = indices.size();
+    const int* counts = sampleCounts_ ? sampleCounts_->data() : nullptr;
+    
+    // **Professor's suggestion: Avoid parallel overhead for small datasets**
+    const auto& cutoffs = ParallelCalibration::cutoffs();
+    const int reductionThreads = cutoffs.reductionThreads;
+    if (counts) {
+        #pragma omp parallel for reduction(+:sum) schedule(static) num_threads(reductionThreads) if(numSamples > cutoffs.reductionParallelMinSamples)
+        for (size_t i = 0; i < numSamples; ++i) {
+            sum += counts[indices[i]] * labels[indices[i]];
+        }
+    } else {
+        #pragma omp parallel for reduction(+:sum) schedule(static) num_threads(reductionThreads) if(numSamples > cutoffs.reductionParallelMinSamples)
+        for (size_t i = 0; i < numSamples; ++i) {
+            sum += labels[indices[i]];
+        }
+    }
+    return sum;
+}
+
+double SingleTreeTrainer::nodeMetric(const std::vector<double>& labels,
+                                     const std::vector<int>& indices) const {
+    return sampleCounts_ ? criterion_->nodeMetric(labels, indices, *sampleCounts_)
+                         : criterion_->nodeMetric(labels, indices);
+}
+
+std::tuple<int, double, double>
+SingleTreeTrainer::findSplit(const FeatureMatrix& X,
+                             const std::vector<double>& labels,
+                             const std::vector<int>& indices,
+                             double metric) const {
+    if (sampleCounts_) {
+        return finder_->findBestSplit(X, labels, indices, *sampleCounts_, metric, *criterion_);
+    }
+    return finder_->findBestSplit(X, labels, indices, metric, *criterion_);
+}
+
 // Predicts the label for a single sample by traversing the tree
 double SingleTreeTrainer::predict(const double* sample, int /* rowLength */) const {
     const Node* cur = root_.get(); // Start from the root
@@ -431,8 +657,11 @@ void SingleTreeTrainer::evaluate(const std::vector<double>& X,
     
     // **Parallel prediction and error calculation, using num_threads clause**
     // Apply OpenMP parallel for with reduction for mse and mae, static scheduling
-    // Use 4 threads if dataset size 'n' is greater than 1000
-    #pragma omp parallel for reduction(+:mse,mae) schedule(static, 256) num_threads(4) if(n > 1000)
+    // Thread count and size cutoff come from the calibrated profile
+    const auto& cutoffs = ParallelCalibration::cutoffs();
+    const int evalThreads = cutoffs.reductionThreads;
+    const size_t evalCutoff = cutoffs.reductionParallelMinSamples;
+    #pragma omp parallel for reduction(+:mse,mae) schedule(static, 256) num_threads(evalThreads) if(n > evalCutoff)
     for (size_t i = 0; i < n; ++i) {
         const double pred = predict(&X[i * rowLength], rowLength); // Predict for current sample
         const double diff = y[i] - pred;                            // Calculate difference
@@ -462,31 +691,28 @@ void SingleTreeTrainer::calculateTreeStats(const Node* node, int currentDepth,
 
 // Compatibility method: Converts const ref to mutable copy for splitNodeOptimized
 void SingleTreeTrainer::splitNode(Node* node,
-                                  const std::vector<double>& data,
-                                  int rowLength,
+                                  const FeatureMatrix& X,
                                   const std::vector<double>& labels,
                                   const std::vector<int>& indices,
                                   int depth) {
     std::vector<int> mutableIndices = indices; // Create a mutable copy
-    splitNodeOptimized(node, data, rowLength, labels, mutableIndices, depth); // Call optimized method
+    splitNodeOptimized(node, X, labels, mutableIndices, depth); // Call optimized method
 }
 
 // Compatibility method: Direct call to splitNodeOptimized (assuming indices are mutable)
 void SingleTreeTrainer::splitNodeInPlace(Node* node,
-                                         const std::vector<double>& data,
-                                         int rowLength,
+                                         const FeatureMatrix& X,
                                          const std::vector<double>& labels,
                                          std::vector<int>& indices, // Indices are already mutable
                                          int depth) {
-    splitNodeOptimized(node, data, rowLength, labels, indices, depth);
+    splitNodeOptimized(node, X, labels, indices, depth);
 }
 
 // Compatibility method: Direct call to splitNodeOptimized (assuming indices are mutable)
 void SingleTreeTrainer::splitNodeInPlaceParallel(Node* node,
-                                                 const std::vector<double>& data,
-                                                 int rowLength,
+                                                 const FeatureMatrix& X,
                                                  const std::vector<double>& labels,
                                                  std::vector<int>& indices, // Indices are already mutable
                                                  int depth) {
-    splitNodeOptimized(node, data, rowLength, labels, indices, depth);
+    splitNodeOptimized(node, X, labels, indices, depth);
 }
\ No newline at end of file
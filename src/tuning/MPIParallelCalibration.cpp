@@ -0,0 +1,35 @@
+// =============================================================================
+// src/tuning/MPIParallelCalibration.cpp - Host leader resolves, host ranks adopt
+// =============================================================================
+#include "tuning/MPIParallelCalibration.hpp"
+#include <chrono>
+#include <thread>
+#include <type_traits>
+
+const ParallelCutoffs& MPIParallelCalibration::share(MPI_Comm comm) {
+    static_assert(std::is_trivially_copyable<ParallelCutoffs>::value,
+                  "ParallelCutoffs is broadcast as raw bytes");
+
+    MPI_Comm host;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &host);
+    int hostRank = 0;
+    MPI_Comm_rank(host, &hostRank);
+
+    // Only the leader touches the profile file or runs the microbenchmarks
+    ParallelCutoffs shared;
+    if (hostRank == 0) shared = ParallelCalibration::cutoffs();
+    MPI_Request request;
+    MPI_Ibcast(&shared, static_cast<int>(sizeof(shared)), MPI_BYTE, 0, host, &request);
+    // Waiting ranks sleep instead of spinning in a blocking collective, which
+    // would steal the cores the leader is timing
+    int done = 0;
+    MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+    while (!done) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+    }
+    if (hostRank != 0) ParallelCalibration::setOverride(shared);
+
+    MPI_Comm_free(&host);
+    return ParallelCalibration::cutoffs();
+}
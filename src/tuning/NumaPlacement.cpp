@@ -0,0 +1,282 @@
+// =============================================================================
+// src/tuning/NumaPlacement.cpp - Topology from sysfs, pinning via OpenMP places
+// =============================================================================
+#include "tuning/NumaPlacement.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+std::mutex g_mutex;
+bool g_initialized = false;
+NumaPlacement::Policy g_policy = NumaPlacement::Policy::Off;
+NumaTopology g_topology;
+bool g_topologyDetected = false;
+
+int g_replicas = 1;
+std::vector<int> g_threadsPerNode;   // Pinned threads on each topology node
+int g_runtimeBound = 0;              // Threads the runtime had already placed
+thread_local int t_node = -1;        // Topology node the thread is pinned to
+thread_local int t_replica = 0;
+
+// "0-3,8,10-11" -> {0,1,2,3,8,10,11}
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        try {
+            const auto dash = range.find('-');
+            const int lo = std::stoi(range.substr(0, dash));
+            const int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+            for (int c = lo; c <= hi; ++c) cpus.push_back(c);
+        } catch (...) {}
+    }
+    return cpus;
+}
+
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::ostringstream os;
+    for (std::size_t i = 0; i < cpus.size();) {
+        std::size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (i > 0) os << ',';
+        os << cpus[i];
+        if (j > i) os << '-' << cpus[j];
+        i = j + 1;
+    }
+    return os.str();
+}
+
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &set)) cpus.push_back(c);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        const int n = std::max(1u, std::thread::hardware_concurrency());
+        for (int c = 0; c < n; ++c) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+NumaTopology detectTopology() {
+    NumaTopology topo;
+    const std::vector<int> allowed = allowedCpus();
+
+#ifdef __linux__
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        std::vector<int> ids;
+        while (const dirent* entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                ids.push_back(std::stoi(name.substr(4)));
+            }
+        }
+        closedir(dir);
+        std::sort(ids.begin(), ids.end());
+
+        for (const int id : ids) {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+            std::string list;
+            if (!std::getline(in, list)) continue;
+            // Memory-only nodes and CPUs outside our affinity mask are dropped
+            std::vector<int> cpus;
+            for (const int c : parseCpuList(list)) {
+                if (std::binary_search(allowed.begin(), allowed.end(), c)) cpus.push_back(c);
+            }
+            if (cpus.empty()) continue;
+            topo.nodeIds.push_back(id);
+            topo.nodeCpus.push_back(std::move(cpus));
+        }
+        topo.fromSysfs = !topo.nodeCpus.empty();
+    }
+#endif
+
+    if (topo.nodeCpus.empty()) {
+        topo.nodeIds = {0};
+        topo.nodeCpus = {allowed};
+    }
+    return topo;
+}
+
+int nodeOfCpu(int cpu) {
+    for (int n = 0; n < g_topology.numNodes(); ++n) {
+        const auto& cpus = g_topology.nodeCpus[n];
+        if (std::binary_search(cpus.begin(), cpus.end(), cpu)) return n;
+    }
+    return 0;
+}
+
+// Binds every thread of the default team and records its node. Thread t of
+// T takes CPU t * C / T of the node-major CPU list, so consecutive thread
+// ids (the chunks of a static schedule) share a node.
+void pinThreadsLocked() {
+    std::vector<int> cpuOrder;
+    for (const auto& cpus : g_topology.nodeCpus) {
+        cpuOrder.insert(cpuOrder.end(), cpus.begin(), cpus.end());
+    }
+
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+    std::vector<int> nodeOf(numThreads, -1);
+    std::vector<int> runtimeBound(numThreads, 0);
+
+    #pragma omp parallel
+    {
+        int t = 0, T = 1;
+#ifdef _OPENMP
+        t = omp_get_thread_num();
+        T = omp_get_num_threads();
+#endif
+        int node = -1;
+#if defined(_OPENMP) && _OPENMP >= 201511
+        // Honour places the runtime already bound us to
+        const int place = omp_get_place_num();
+        if (place >= 0 && omp_get_place_num_procs(place) > 0) {
+            std::vector<int> procs(omp_get_place_num_procs(place));
+            omp_get_place_proc_ids(place, procs.data());
+            node = nodeOfCpu(procs.front());
+            runtimeBound[t] = 1;
+        }
+#endif
+#ifdef __linux__
+        if (node < 0 && !cpuOrder.empty()) {
+            const int cpu = cpuOrder[static_cast<std::size_t>(t) * cpuOrder.size() / T];
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            if (sched_setaffinity(0, sizeof(set), &set) == 0) node = nodeOfCpu(cpu);
+        }
+#endif
+        t_node = node;
+        if (t < static_cast<int>(nodeOf.size())) nodeOf[t] = node;
+    }
+
+    // Dense replica slots over the nodes that got threads; unpinned threads
+    // read slot 0
+    g_threadsPerNode.assign(g_topology.numNodes(), 0);
+    g_runtimeBound = 0;
+    for (int t = 0; t < numThreads; ++t) {
+        if (nodeOf[t] >= 0) ++g_threadsPerNode[nodeOf[t]];
+        g_runtimeBound += runtimeBound[t];
+    }
+    std::vector<int> slotOfNode(g_topology.numNodes(), 0);
+    int slots = 0;
+    for (int n = 0; n < g_topology.numNodes(); ++n) {
+        if (g_threadsPerNode[n] > 0) slotOfNode[n] = slots++;
+    }
+    g_replicas = g_policy == NumaPlacement::Policy::Replicate ? std::max(1, slots) : 1;
+
+    // Keyed by the OS thread (t_node), not the team id, which the runtime
+    // may hand out differently in the next region
+    #pragma omp parallel
+    {
+        t_replica = t_node >= 0 ? slotOfNode[t_node] : 0;
+    }
+}
+
+void applyLocked(NumaPlacement::Policy policy) {
+    g_policy = policy;
+    if (!g_topologyDetected) {
+        g_topology = detectTopology();
+        g_topologyDetected = true;
+    }
+    g_replicas = 1;
+    if (policy == NumaPlacement::Policy::Off) return;
+
+    pinThreadsLocked();
+    NumaPlacement::print(std::cout);
+}
+
+} // namespace
+
+NumaPlacement::Policy NumaPlacement::policy() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_initialized) {
+        Policy policy = Policy::Off;
+        if (const char* env = std::getenv("DT_NUMA")) {
+            if (env[0] != '\0' && !parsePolicy(env, policy)) {
+                std::cerr << "Warning: unknown DT_NUMA value '" << env
+                          << "' (expected off, partition or replicate); NUMA placement disabled" << std::endl;
+            }
+        }
+        applyLocked(policy);
+        g_initialized = true;
+    }
+    return g_policy;
+}
+
+void NumaPlacement::configure(Policy policy) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    applyLocked(policy);
+    g_initialized = true;
+}
+
+const NumaTopology& NumaPlacement::topology() {
+    policy();
+    return g_topology;
+}
+
+int NumaPlacement::replicaCount() {
+    policy();
+    return g_replicas;
+}
+
+int NumaPlacement::currentReplica() {
+    // Slots recorded under an earlier replicate policy may exceed the current count
+    return t_replica < g_replicas ? t_replica : 0;
+}
+
+bool NumaPlacement::parsePolicy(const std::string& name, Policy& policy) {
+    if (name == "off" || name == "0")  { policy = Policy::Off;       return true; }
+    if (name == "partition" || name == "1") { policy = Policy::Partition; return true; }
+    if (name == "replicate") { policy = Policy::Replicate; return true; }
+    return false;
+}
+
+const char* NumaPlacement::policyName(Policy policy) {
+    switch (policy) {
+        case Policy::Partition: return "partition";
+        case Policy::Replicate: return "replicate";
+        default:                return "off";
+    }
+}
+
+void NumaPlacement::print(std::ostream& os) {
+    const NumaTopology& topo = g_topology;
+    os << "NUMA topology: " << topo.numNodes() << (topo.numNodes() == 1 ? " node" : " nodes")
+       << (topo.fromSysfs ? "" : " (no sysfs NUMA information, assuming one)") << std::endl;
+    for (int n = 0; n < topo.numNodes(); ++n) {
+        os << "  node " << topo.nodeIds[n] << ": " << topo.nodeCpus[n].size() << " CPUs ["
+           << formatCpuList(topo.nodeCpus[n]) << "]";
+        if (n < static_cast<int>(g_threadsPerNode.size())) {
+            os << ", " << g_threadsPerNode[n] << " pinned threads";
+        }
+        os << std::endl;
+    }
+    os << "NUMA policy: " << policyName(g_policy) << " | replicas: " << g_replicas;
+    if (g_runtimeBound > 0) os << " | " << g_runtimeBound << " threads kept OMP_PLACES binding";
+    if (topo.numNodes() == 1) os << " | single node: pinning only";
+    os << std::endl;
+}
@@ -0,0 +1,444 @@
+// =============================================================================
+// src/tuning/ParallelCalibration.cpp - Microbenchmark-driven parallel cutoffs
+// =============================================================================
+#include "tuning/ParallelCalibration.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+constexpr std::size_t NEVER = std::numeric_limits<std::size_t>::max() / 4;
+
+std::mutex g_mutex;
+bool g_initialized = false;
+ParallelCutoffs g_cutoffs;
+
+int maxThreads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// Best-of-2 wall time of `reps` invocations, in seconds
+template <typename Fn>
+double timeKernel(Fn&& fn, int reps) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int trial = 0; trial < 2; ++trial) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) fn();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+    return best;
+}
+
+// Enough repetitions to keep the measured interval well above timer noise
+int repsFor(std::size_t n) {
+    return static_cast<int>(std::max<std::size_t>(1, (1u << 18) / std::max<std::size_t>(n, 1)));
+}
+
+// Smallest size from which the parallel variant wins at every larger size too
+std::size_t crossover(const std::vector<std::size_t>& sizes,
+                      const std::vector<double>& serial,
+                      const std::vector<double>& parallel) {
+    std::size_t cut = NEVER;
+    for (int i = static_cast<int>(sizes.size()) - 1; i >= 0; --i) {
+        if (parallel[i] < 0.9 * serial[i]) cut = sizes[i];
+        else break;
+    }
+    return cut;
+}
+
+volatile double g_sink = 0.0;
+
+// ---- Kernel 1: indexed label reduction (node mean, evaluate) ----
+void calibrateReduction(ParallelCutoffs& c, int threads,
+                        const std::vector<double>& y, const std::vector<int>& idx) {
+    // Thread count for large reductions: more threads is not always faster
+    const std::size_t big = idx.size();
+    double bestTime = std::numeric_limits<double>::infinity();
+    int bestThreads = 1;
+    for (int t = 2; ; t = std::min(t * 2, threads)) {
+        double tt = timeKernel([&] {
+            double s = 0.0;
+            #pragma omp parallel for reduction(+:s) schedule(static) num_threads(t)
+            for (std::size_t i = 0; i < big; ++i) s += y[idx[i]];
+            g_sink = s;
+        }, 4);
+        if (tt < bestTime) { bestTime = tt; bestThreads = t; }
+        if (t == threads) break;
+    }
+    c.reductionThreads = bestThreads;
+
+    std::vector<std::size_t> sizes;
+    std::vector<double> ser, par;
+    for (std::size_t n = 256; n <= big; n *= 2) {
+        const int reps = repsFor(n);
+        sizes.push_back(n);
+        ser.push_back(timeKernel([&] {
+            double s = 0.0;
+            for (std::size_t i = 0; i < n; ++i) s += y[idx[i]];
+            g_sink = s;
+        }, reps));
+        par.push_back(timeKernel([&] {
+            double s = 0.0;
+            #pragma omp parallel for reduction(+:s) schedule(static) num_threads(bestThreads)
+            for (std::size_t i = 0; i < n; ++i) s += y[idx[i]];
+            g_sink = s;
+        }, reps));
+    }
+    c.reductionParallelMinSamples = crossover(sizes, ser, par);
+}
+
+// ---- Kernel 2: per-feature sort + prefix scan (exhaustive split search) ----
+void calibrateFinder(ParallelCutoffs& c,
+                     const std::vector<double>& x, const std::vector<double>& y) {
+    constexpr int D = 8;
+    const std::size_t rows = y.size();
+
+    auto scanFeature = [&](const std::vector<int>& node, std::vector<int>& buf, int f) {
+        buf.assign(node.begin(), node.end());
+        std::sort(buf.begin(), buf.end(), [&](int a, int b) {
+            return x[(a * D + f) % rows] < x[(b * D + f) % rows];
+        });
+        double s = 0.0;
+        for (int i : buf) s += y[i];
+        return s;
+    };
+
+    std::vector<std::size_t> sizes;
+    std::vector<double> ser, par, sections;
+    for (std::size_t n = 128; n <= 16384; n *= 2) {
+        std::vector<int> node(n);
+        std::iota(node.begin(), node.end(), 0);
+        const int reps = std::max(1, repsFor(n * 16));
+        sizes.push_back(n);
+        ser.push_back(timeKernel([&] {
+            std::vector<int> buf;
+            double s = 0.0;
+            for (int f = 0; f < D; ++f) s += scanFeature(node, buf, f);
+            g_sink = s;
+        }, reps));
+        par.push_back(timeKernel([&] {
+            double s = 0.0;
+            #pragma omp parallel reduction(+:s)
+            {
+                std::vector<int> buf;
+                #pragma omp for schedule(dynamic)
+                for (int f = 0; f < D; ++f) s += scanFeature(node, buf, f);
+            }
+            g_sink = s;
+        }, reps));
+        // Two sibling subtrees of n/2 samples built side by side
+        std::vector<int> half(node.begin(), node.begin() + n / 2);
+        sections.push_back(timeKernel([&] {
+            double a = 0.0, b = 0.0;
+            #pragma omp parallel sections num_threads(2)
+            {
+                #pragma omp section
+                { std::vector<int> buf; for (int f = 0; f < D; ++f) a += scanFeature(half, buf, f); }
+                #pragma omp section
+                { std::vector<int> buf; for (int f = 0; f < D; ++f) b += scanFeature(half, buf, f); }
+            }
+            g_sink = a + b;
+        }, reps));
+    }
+    c.finderParallelMinSamples = crossover(sizes, ser, par);
+
+    // Serial cost of two halves is roughly the serial cost of the whole node
+    c.recursionMinSamples = crossover(sizes, ser, sections);
+    c.recursionMinChildSamples = c.recursionMinSamples == NEVER ? NEVER : c.recursionMinSamples / 4;
+}
+
+// ---- Kernel 3: element-wise update (residuals, prediction updates) ----
+void calibrateElementwise(ParallelCutoffs& c, int threads) {
+    const std::size_t big = 1u << 17;
+    std::vector<double> pred(big, 0.0), tree(big, 1.0);
+
+    int bestChunk = c.elementwiseChunkSize;
+    double bestTime = std::numeric_limits<double>::infinity();
+    for (int chunk = 512; chunk <= 8192; chunk *= 2) {
+        double t = timeKernel([&] {
+            #pragma omp parallel for schedule(static, chunk) num_threads(threads)
+            for (std::size_t i = 0; i < big; ++i) pred[i] += 0.1 * tree[i];
+        }, 4);
+        if (t < bestTime) { bestTime = t; bestChunk = chunk; }
+    }
+    c.elementwiseChunkSize = bestChunk;
+
+    std::vector<std::size_t> sizes;
+    std::vector<double> ser, par;
+    for (std::size_t n = 256; n <= big; n *= 2) {
+        const int reps = repsFor(n);
+        sizes.push_back(n);
+        ser.push_back(timeKernel([&] {
+            for (std::size_t i = 0; i < n; ++i) pred[i] += 0.1 * tree[i];
+        }, reps));
+        par.push_back(timeKernel([&] {
+            #pragma omp parallel for schedule(static, bestChunk) num_threads(threads)
+            for (std::size_t i = 0; i < n; ++i) pred[i] += 0.1 * tree[i];
+        }, reps));
+    }
+    g_sink = pred[big / 2];
+    c.elementwiseParallelMinSamples = crossover(sizes, ser, par);
+}
+
+std::string hostName() {
+#if defined(__unix__) || defined(__APPLE__)
+    char buf[256] = {0};
+    if (gethostname(buf, sizeof(buf) - 1) == 0 && buf[0] != '\0') return buf;
+#endif
+    return "localhost";
+}
+
+void ensureParentDirectory(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+    // mkdir -p on every prefix of the directory part
+    for (auto slash = path.find('/', 1); slash != std::string::npos;
+         slash = path.find('/', slash + 1)) {
+        ::mkdir(path.substr(0, slash).c_str(), 0755);
+    }
+#endif
+}
+
+// "never" keeps the profile readable for kernels that should stay serial
+void readSize(std::istringstream& in, std::size_t& value) {
+    std::string token;
+    in >> token;
+    if (token == "never") { value = NEVER; return; }
+    try { value = static_cast<std::size_t>(std::stoull(token)); } catch (...) {}
+}
+
+std::string sizeToString(std::size_t value) {
+    return value >= NEVER ? "never" : std::to_string(value);
+}
+
+// Keys print() writes and load() requires
+constexpr std::size_t kProfileKeys = 12;
+
+// Applies one `key=value` profile entry; false for unknown keys
+bool parseEntry(const std::string& key, const std::string& text, ParallelCutoffs& c) {
+    std::istringstream value(text);
+    if (key == "threads") value >> c.calibratedThreads;
+    else if (key == "finder_parallel_min_samples") readSize(value, c.finderParallelMinSamples);
+    else if (key == "reduction_parallel_min_samples") readSize(value, c.reductionParallelMinSamples);
+    else if (key == "reduction_threads") value >> c.reductionThreads;
+    else if (key == "task_queue_min_samples") readSize(value, c.taskQueueMinSamples);
+    else if (key == "task_queue_max_workers") value >> c.taskQueueMaxWorkers;
+    else if (key == "recursion_max_depth") value >> c.recursionMaxDepth;
+    else if (key == "recursion_min_samples") readSize(value, c.recursionMinSamples);
+    else if (key == "recursion_min_child_samples") readSize(value, c.recursionMinChildSamples);
+    else if (key == "leafwise_parallel_min_samples") readSize(value, c.leafwiseParallelMinSamples);
+    else if (key == "elementwise_parallel_min_samples") readSize(value, c.elementwiseParallelMinSamples);
+    else if (key == "elementwise_chunk_size") value >> c.elementwiseChunkSize;
+    else return false;
+    return true;
+}
+
+void clampCounts(ParallelCutoffs& c) {
+    c.reductionThreads = std::max(1, c.reductionThreads);
+    c.taskQueueMaxWorkers = std::max(1, c.taskQueueMaxWorkers);
+    c.elementwiseChunkSize = std::max(1, c.elementwiseChunkSize);
+}
+
+// DT_PARALLEL_<KEY> (profile key in upper case, e.g.
+// DT_PARALLEL_FINDER_PARALLEL_MIN_SAMPLES=5000) replaces a single cutoff
+void applyEnvironment(ParallelCutoffs& c) {
+    for (const char* key : {"finder_parallel_min_samples", "reduction_parallel_min_samples",
+                            "reduction_threads", "task_queue_min_samples",
+                            "task_queue_max_workers", "recursion_max_depth",
+                            "recursion_min_samples", "recursion_min_child_samples",
+                            "leafwise_parallel_min_samples", "elementwise_parallel_min_samples",
+                            "elementwise_chunk_size"}) {
+        std::string name = "DT_PARALLEL_";
+        for (const char* p = key; *p; ++p) name += static_cast<char>(std::toupper(*p));
+        if (const char* env = std::getenv(name.c_str())) {
+            if (env[0] != '\0') parseEntry(key, env, c);
+        }
+    }
+    clampCounts(c);
+}
+
+void initializeLocked() {
+    const int threads = maxThreads();
+    const std::string path = ParallelCalibration::profilePath();
+    const char* force = std::getenv("DT_RECALIBRATE");
+    const bool recalibrate = force && std::string(force) != "0";
+
+    ParallelCutoffs loaded;
+    if (!recalibrate && ParallelCalibration::load(path, loaded) &&
+        loaded.calibratedThreads == threads) {
+        g_cutoffs = loaded;
+    } else {
+        // Status goes to stderr: this runs inside train() and must not
+        // interleave with the apps' result output
+        std::cerr << "Calibrating parallel cutoffs for " << threads << " threads..." << std::endl;
+        g_cutoffs = ParallelCalibration::calibrate();
+        if (ParallelCalibration::save(path, g_cutoffs)) {
+            std::cerr << "Parallel profile saved to " << path << std::endl;
+        } else {
+            std::cerr << "Warning: could not write parallel profile " << path << std::endl;
+        }
+    }
+    // Overrides are applied on top and never written back to the profile
+    applyEnvironment(g_cutoffs);
+}
+
+} // namespace
+
+const ParallelCutoffs& ParallelCalibration::cutoffs() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_initialized) {
+        initializeLocked();
+        g_initialized = true;
+    }
+    return g_cutoffs;
+}
+
+void ParallelCalibration::setOverride(const ParallelCutoffs& cutoffs) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_cutoffs = cutoffs;
+    g_initialized = true;
+}
+
+ParallelCutoffs ParallelCalibration::calibrate(bool verbose) {
+    ParallelCutoffs c;
+    const int threads = maxThreads();
+    c.calibratedThreads = threads;
+    c.taskQueueMaxWorkers = threads;
+    c.recursionMaxDepth = std::max(0, static_cast<int>(std::ceil(std::log2(std::max(threads, 1)))) - 1);
+
+    if (threads <= 1) {
+        // Nothing to gain from parallel regions; keep every kernel serial
+        c.finderParallelMinSamples = NEVER;
+        c.reductionParallelMinSamples = NEVER;
+        c.reductionThreads = 1;
+        c.taskQueueMinSamples = NEVER;
+        c.recursionMinSamples = NEVER;
+        c.recursionMinChildSamples = NEVER;
+        c.leafwiseParallelMinSamples = NEVER;
+        c.elementwiseParallelMinSamples = NEVER;
+        if (verbose) print(c, std::cout);
+        return c;
+    }
+
+    const std::size_t rows = 1u << 16;
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::vector<double> y(rows), x(rows);
+    for (std::size_t i = 0; i < rows; ++i) { y[i] = uni(gen); x[i] = uni(gen); }
+    std::vector<int> idx(rows);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::shuffle(idx.begin(), idx.end(), gen);
+
+    // Warm up the OpenMP thread pool so the first measurement is not penalized
+    #pragma omp parallel
+    { g_sink = 0.0; }
+
+    calibrateReduction(c, threads, y, idx);
+    calibrateFinder(c, x, y);
+    calibrateElementwise(c, threads);
+
+    c.taskQueueMinSamples = c.finderParallelMinSamples;
+    c.leafwiseParallelMinSamples = std::max(c.finderParallelMinSamples,
+                                            c.reductionParallelMinSamples);
+    if (verbose) print(c, std::cout);
+    return c;
+}
+
+std::string ParallelCalibration::profilePath() {
+    if (const char* env = std::getenv("DT_PARALLEL_PROFILE")) {
+        if (env[0] != '\0') return env;
+    }
+    if (const char* home = std::getenv("HOME")) {
+        if (home[0] != '\0') {
+            return std::string(home) + "/.decision_tree/parallel_profile_" + hostName() + ".cfg";
+        }
+    }
+    return "parallel_profile.cfg";
+}
+
+bool ParallelCalibration::load(const std::string& path, ParallelCutoffs& out) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+
+    ParallelCutoffs c;
+    std::set<std::string> seen;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        const auto eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        const std::string key = line.substr(0, eq);
+        if (parseEntry(key, line.substr(eq + 1), c)) seen.insert(key);
+    }
+    // A truncated or foreign file would silently mix in defaults
+    if (seen.size() != kProfileKeys) return false;
+    clampCounts(c);
+    out = c;
+    return true;
+}
+
+bool ParallelCalibration::save(const std::string& path, const ParallelCutoffs& c) {
+    ensureParentDirectory(path);
+    // Written aside and renamed into place, so concurrent readers see either
+    // the old profile or the complete new one
+    std::string tmpPath = path + ".tmp";
+#if defined(__unix__) || defined(__APPLE__)
+    tmpPath += "." + std::to_string(::getpid());
+#endif
+    {
+        std::ofstream outFile(tmpPath);
+        if (!outFile.is_open()) return false;
+        outFile << "# Parallel granularity profile for " << hostName()
+                << " (delete to recalibrate)\n";
+        print(c, outFile);
+        outFile.close();
+        if (!outFile) {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void ParallelCalibration::print(const ParallelCutoffs& c, std::ostream& os) {
+    os << "threads=" << c.calibratedThreads << "\n"
+       << "finder_parallel_min_samples=" << sizeToString(c.finderParallelMinSamples) << "\n"
+       << "reduction_parallel_min_samples=" << sizeToString(c.reductionParallelMinSamples) << "\n"
+       << "reduction_threads=" << c.reductionThreads << "\n"
+       << "task_queue_min_samples=" << sizeToString(c.taskQueueMinSamples) << "\n"
+       << "task_queue_max_workers=" << c.taskQueueMaxWorkers << "\n"
+       << "recursion_max_depth=" << c.recursionMaxDepth << "\n"
+       << "recursion_min_samples=" << sizeToString(c.recursionMinSamples) << "\n"
+       << "recursion_min_child_samples=" << sizeToString(c.recursionMinChildSamples) << "\n"
+       << "leafwise_parallel_min_samples=" << sizeToString(c.leafwiseParallelMinSamples) << "\n"
+       << "elementwise_parallel_min_samples=" << sizeToString(c.elementwiseParallelMinSamples) << "\n"
+       << "elementwise_chunk_size=" << c.elementwiseChunkSize << "\n";
+}
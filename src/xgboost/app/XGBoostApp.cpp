@@ -5,6 +5,25 @@
 #include <chrono>
 #include <iomanip>
 
+// Prunes in place and reports validation/test MSE before and after
+static void pruneXGBoostEnsemble(XGBoostTrainer& trainer,
+                                 const XGBoostAppOptions& opts,
+                                 const std::vector<double>& X_val,
+                                 const std::vector<double>& y_val,
+                                 const DataParams& dp) {
+    if (opts.pruneMethod.empty() || y_val.empty()) return;
+    double before, after, mae;
+    trainer.evaluate(dp.X_test, dp.rowLength, dp.y_test, before, mae);
+    const size_t fullTrees = trainer.getXGBModel()->getTreeCount();
+    EnsemblePruner pruner(EnsemblePruner::parseMethod(opts.pruneMethod), opts.pruneTol);
+    const EnsembleSelection sel = trainer.pruneEnsemble(pruner, X_val, dp.rowLength, y_val);
+    trainer.evaluate(dp.X_test, dp.rowLength, dp.y_test, after, mae);
+    std::cout << "Ensemble pruning (" << opts.pruneMethod << "): " << sel.trees.size()
+              << "/" << fullTrees << " trees | Val MSE " << std::fixed << std::setprecision(6)
+              << sel.fullMSE << " -> " << sel.prunedMSE
+              << " | Test MSE " << before << " -> " << after << std::endl;
+}
+
 void runXGBoostApp(const XGBoostAppOptions& opts) {
     auto totalStart = std::chrono::high_resolution_clock::now();
     
@@ -25,22 +44,11 @@ void runXGBoostApp(const XGBoostAppOptions& opts) {
     // Create trainer
     auto trainer = createXGBoostTrainer(opts);
     
-    // Set validation data (if early stopping is needed)
-    if (opts.earlyStoppingRounds > 0 && opts.valSplit > 0) {
-        // Split out validation set from training data
-        size_t trainSize = dp.y_train.size();
-        size_t valSize = static_cast<size_t>(trainSize * opts.valSplit);
-        
-        if (valSize > 0) {
-            std::vector<double> X_val(dp.X_train.begin() + (trainSize - valSize) * dp.rowLength,
-                                     dp.X_train.end());
-            std::vector<double> y_val(dp.y_train.begin() + (trainSize - valSize),
-                                     dp.y_train.end());
-            
-            // Resize training set
-            dp.X_train.resize((trainSize - valSize) * dp.rowLength);
-            dp.y_train.resize(trainSize - valSize);
-            
+    // Hold out validation rows (early stopping and/or ensemble pruning)
+    std::vector<double> X_val, y_val;
+    if ((opts.earlyStoppingRounds > 0 || !opts.pruneMethod.empty()) && opts.valSplit > 0) {
+        holdOutValidation(dp, opts.valSplit, X_val, y_val);
+        if (opts.earlyStoppingRounds > 0 && !y_val.empty()) {
             trainer->setValidationData(X_val, y_val, dp.rowLength);
         }
     }
@@ -59,6 +67,8 @@ void runXGBoostApp(const XGBoostAppOptions& opts) {
     trainer->evaluate(dp.X_train, dp.rowLength, dp.y_train, trainMSE, trainMAE);
     trainer->evaluate(dp.X_test, dp.rowLength, dp.y_test, testMSE, testMAE);
     
+    pruneXGBoostEnsemble(*trainer, opts, X_val, y_val, dp);
+    
     auto totalEnd = std::chrono::high_resolution_clock::now();
     
     // Output results
@@ -102,6 +112,7 @@ std::unique_ptr<XGBoostTrainer> createXGBoostTrainer(const XGBoostAppOptions& op
     config.lambda = opts.lambda;
     config.gamma = opts.gamma;
     config.subsample = opts.subsample;
+    config.seed = opts.seed;
     config.colsampleByTree = opts.colsampleByTree;
     config.verbose = opts.verbose;
     config.earlyStoppingRounds = opts.earlyStoppingRounds;
@@ -0,0 +1,251 @@
+// =============================================================================
+// src/xgboost/trainer/MPIBoostingTrainer.cpp - Sharded rows, allreduced histograms
+// =============================================================================
+#include "xgboost/trainer/MPIBoostingTrainer.hpp"
+#include "xgboost/loss/XGBoostLossFactory.hpp"
+#include "histogram/MPIQuantileSketch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+// Smallest hessian sum a child may have, whatever minChildWeight says
+constexpr double MIN_CHILD_HESSIAN = 1e-6;
+
+} // namespace
+
+MPIBoostingTrainer::MPIBoostingTrainer(const XGBoostConfig& config, MPI_Comm comm)
+    : config_(config),
+      comm_(comm),
+      loss_(XGBoostLossFactory::create(config.objective)),
+      criterion_(config.lambda) {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+    config_.maxBins = std::max(2, std::min(config_.maxBins, 256));
+}
+
+void MPIBoostingTrainer::shardRange(std::size_t n, int rank, int size,
+                                    std::size_t& begin, std::size_t& end) {
+    begin = n * static_cast<std::size_t>(rank) / static_cast<std::size_t>(size);
+    end = n * static_cast<std::size_t>(rank + 1) / static_cast<std::size_t>(size);
+}
+
+void MPIBoostingTrainer::train(const std::vector<double>& data,
+                               int numFeatures,
+                               const std::vector<double>& labels) {
+    model_.clear();
+    trainingLoss_.clear();
+    histSeconds_ = 0.0;
+    allreduceSeconds_ = 0.0;
+    localRows_ = labels.size();
+
+    cuts_ = MPIQuantileSketch::computeCuts(comm_, data, localRows_, numFeatures, config_.maxBins);
+    MPIQuantileSketch::binColumns(cuts_, data, localRows_, bins_);
+    binOffset_ = MPIQuantileSketch::binOffsets(cuts_);
+    totalBins_ = binOffset_.back();
+
+    double sums[2] = {std::accumulate(labels.begin(), labels.end(), 0.0),
+                      static_cast<double>(localRows_)};
+    MPI_Allreduce(MPI_IN_PLACE, sums, 2, MPI_DOUBLE, MPI_SUM, comm_);
+    const double globalRows = sums[1];
+    const double baseScore = globalRows > 0.0 ? sums[0] / globalRows : 0.0;
+    model_.setGlobalBaseScore(baseScore);
+
+    std::vector<double> predictions(localRows_, baseScore);
+    std::vector<double> gradients, hessians;
+    std::vector<GradPair> gh(localRows_);
+
+    for (int round = 0; round < config_.numRounds; ++round) {
+        double roundLoss = 0.0;
+        #pragma omp parallel for reduction(+:roundLoss) schedule(static) if(localRows_ > 2000)
+        for (std::size_t i = 0; i < localRows_; ++i) {
+            roundLoss += loss_->loss(labels[i], predictions[i]);
+        }
+        MPI_Allreduce(MPI_IN_PLACE, &roundLoss, 1, MPI_DOUBLE, MPI_SUM, comm_);
+        trainingLoss_.push_back(globalRows > 0.0 ? roundLoss / globalRows : 0.0);
+
+        loss_->computeGradientsHessians(labels, predictions, gradients, hessians);
+        for (std::size_t i = 0; i < localRows_; ++i) gh[i] = {gradients[i], hessians[i]};
+
+        auto tree = growTree(gh, predictions);
+        model_.addTree(std::move(tree), config_.eta);
+
+        if (config_.verbose && rank_ == 0 && (round % 10 == 0 || round + 1 == config_.numRounds)) {
+            std::cout << "Round " << round << " | Train Loss: " << trainingLoss_.back() << std::endl;
+        }
+    }
+}
+
+void MPIBoostingTrainer::buildHistograms(const std::vector<const std::vector<int>*>& rows,
+                                         const std::vector<GradPair>& gh,
+                                         std::vector<GradPair>& hist) {
+    const int K = static_cast<int>(rows.size());
+    const int F = static_cast<int>(binOffset_.size()) - 1;
+    hist.assign(static_cast<std::size_t>(K) * totalBins_, GradPair{0.0, 0.0});
+
+    const double t0 = MPI_Wtime();
+    // (node, feature) pairs own disjoint slices, so no thread-local copies
+    #pragma omp parallel for collapse(2) schedule(dynamic)
+    for (int k = 0; k < K; ++k) {
+        for (int f = 0; f < F; ++f) {
+            GradPair* h = &hist[static_cast<std::size_t>(k) * totalBins_ + binOffset_[f]];
+            const std::uint8_t* col = &bins_[static_cast<std::size_t>(f) * localRows_];
+            for (const int r : *rows[k]) {
+                GradPair& slot = h[col[r]];
+                slot.g += gh[r].g;
+                slot.h += gh[r].h;
+            }
+        }
+    }
+    const double t1 = MPI_Wtime();
+    MPI_Allreduce(MPI_IN_PLACE, hist.data(), static_cast<int>(hist.size() * 2),
+                  MPI_DOUBLE, MPI_SUM, comm_);
+    const double t2 = MPI_Wtime();
+    histSeconds_ += t1 - t0;
+    allreduceSeconds_ += t2 - t1;
+}
+
+MPIBoostingTrainer::SplitCandidate
+MPIBoostingTrainer::findBestSplit(const GradPair* hist, double G, double H) const {
+    SplitCandidate best;
+    const double minH = std::max(static_cast<double>(config_.minChildWeight), MIN_CHILD_HESSIAN);
+    const int F = static_cast<int>(binOffset_.size()) - 1;
+    for (int f = 0; f < F; ++f) {
+        const GradPair* h = hist + binOffset_[f];
+        const int nb = binOffset_[f + 1] - binOffset_[f];
+        double GL = 0.0, HL = 0.0;
+        // Splitting after the last bin would leave the right child empty
+        for (int b = 0; b + 1 < nb; ++b) {
+            GL += h[b].g;
+            HL += h[b].h;
+            const double GR = G - GL, HR = H - HL;
+            if (HL < minH || HR < minH) continue;
+            const double gain = criterion_.computeSplitGain(GL, HL, GR, HR, G, H, config_.gamma);
+            if (gain > best.gain) best = {f, b, gain, GL, HL};
+        }
+    }
+    return best;
+}
+
+std::unique_ptr<Node> MPIBoostingTrainer::growTree(const std::vector<GradPair>& gh,
+                                                   std::vector<double>& predictions) {
+    struct LevelNode {
+        Node* node;
+        std::vector<int> rows;          // Local rows
+        std::vector<GradPair> hist;     // Global histogram
+        double G = 0.0, H = 0.0;        // Global sums
+    };
+
+    auto root = std::make_unique<Node>();
+    std::vector<LevelNode> level(1);
+    level[0].node = root.get();
+    level[0].rows.resize(localRows_);
+    std::iota(level[0].rows.begin(), level[0].rows.end(), 0);
+    buildHistograms({&level[0].rows}, gh, level[0].hist);
+    // Every row lands in one bin of feature 0
+    for (int b = binOffset_[0]; b < binOffset_[1]; ++b) {
+        level[0].G += level[0].hist[b].g;
+        level[0].H += level[0].hist[b].h;
+    }
+
+    for (int depth = 0; !level.empty(); ++depth) {
+        const int K = static_cast<int>(level.size());
+        std::vector<SplitCandidate> splits(K);
+        if (depth < config_.maxDepth) {
+            #pragma omp parallel for schedule(dynamic) if(K > 1)
+            for (int k = 0; k < K; ++k) {
+                splits[k] = findBestSplit(level[k].hist.data(), level[k].G, level[k].H);
+            }
+        }
+
+        std::vector<LevelNode> next;
+        std::vector<const std::vector<int>*> toBuild;
+        std::vector<int> builtIndex, derivedIndex, parentIndex;
+        for (int k = 0; k < K; ++k) {
+            LevelNode& cur = level[k];
+            const SplitCandidate& s = splits[k];
+            if (s.feature < 0) {
+                const double w = criterion_.computeLeafWeight(cur.G, cur.H);
+                cur.node->makeLeaf(w);
+                for (const int r : cur.rows) predictions[r] += config_.eta * w;
+                continue;
+            }
+
+            cur.node->makeInternal(s.feature, cuts_[s.feature][s.bin]);
+            cur.node->leftChild = std::make_unique<Node>();
+            cur.node->rightChild = std::make_unique<Node>();
+
+            LevelNode left, right;
+            left.node = cur.node->leftChild.get();
+            right.node = cur.node->rightChild.get();
+            left.G = s.leftG;
+            left.H = s.leftH;
+            right.G = cur.G - s.leftG;
+            right.H = cur.H - s.leftH;
+            const std::uint8_t* col = &bins_[static_cast<std::size_t>(s.feature) * localRows_];
+            for (const int r : cur.rows) {
+                (col[r] <= s.bin ? left.rows : right.rows).push_back(r);
+            }
+
+            // The global hessian sums decide which child is built, so every
+            // process makes the same choice
+            const int leftIdx = static_cast<int>(next.size());
+            const bool buildLeft = left.H <= right.H;
+            next.push_back(std::move(left));
+            next.push_back(std::move(right));
+            builtIndex.push_back(buildLeft ? leftIdx : leftIdx + 1);
+            derivedIndex.push_back(buildLeft ? leftIdx + 1 : leftIdx);
+            parentIndex.push_back(k);
+        }
+        if (next.empty()) break;
+
+        for (const int idx : builtIndex) toBuild.push_back(&next[idx].rows);
+        std::vector<GradPair> built;
+        buildHistograms(toBuild, gh, built);
+        for (std::size_t j = 0; j < builtIndex.size(); ++j) {
+            LevelNode& small = next[builtIndex[j]];
+            LevelNode& large = next[derivedIndex[j]];
+            const std::vector<GradPair>& parent = level[parentIndex[j]].hist;
+            small.hist.assign(built.begin() + j * totalBins_, built.begin() + (j + 1) * totalBins_);
+            large.hist.resize(totalBins_);
+            for (int b = 0; b < totalBins_; ++b) {
+                large.hist[b] = {parent[b].g - small.hist[b].g, parent[b].h - small.hist[b].h};
+            }
+        }
+        level = std::move(next);
+    }
+    return root;
+}
+
+double MPIBoostingTrainer::predict(const double* sample, int numFeatures) const {
+    return model_.predict(sample, numFeatures);
+}
+
+void MPIBoostingTrainer::predictBatch(const std::vector<double>& X,
+                                      int numFeatures,
+                                      std::vector<double>& predictions) const {
+    predictions = model_.predictBatch(X, numFeatures);
+}
+
+void MPIBoostingTrainer::evaluate(const std::vector<double>& X,
+                                  int numFeatures,
+                                  const std::vector<double>& y,
+                                  double& mse,
+                                  double& mae) const {
+    std::vector<double> pred;
+    predictBatch(X, numFeatures, pred);
+    double sums[3] = {0.0, 0.0, static_cast<double>(y.size())};
+    for (std::size_t i = 0; i < y.size(); ++i) {
+        const double d = y[i] - pred[i];
+        sums[0] += d * d;
+        sums[1] += std::abs(d);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, sums, 3, MPI_DOUBLE, MPI_SUM, comm_);
+    mse = sums[2] > 0.0 ? sums[0] / sums[2] : 0.0;
+    mae = sums[2] > 0.0 ? sums[1] / sums[2] : 0.0;
+}
@@ -1,7 +1,7 @@
 #include "xgboost/trainer/XGBoostTrainer.hpp"
+#include "functions/random/CounterRng.hpp"
 #include <algorithm>
 #include <numeric>
-#include <random>
 #include <limits>
 #include <cmath>
 #ifdef _OPENMP
@@ -15,22 +15,28 @@ XGBoostTrainer::XGBoostTrainer(const XGBoostConfig& config) : config_(config) {
 }
 
 void XGBoostTrainer::train(const std::vector<double>& data, int rowLength, const std::vector<double>& labels) {
+    // Transpose once; every split scan reads contiguous columns afterwards
+    const FeatureMatrix X(data, rowLength, FeatureMatrix::Layout::ColumnMajor);
+    train(X, labels);
+}
+
+void XGBoostTrainer::train(const FeatureMatrix& X, const std::vector<double>& labels) {
     const size_t n = labels.size();
+    const int rowLength = X.numFeatures();
     
     
-    ColumnData columnData(rowLength, n);
+    ColumnData columnData(X);
     
    
     #pragma omp parallel for schedule(dynamic) if(rowLength > 4)
     for (int f = 0; f < rowLength; ++f) {
         columnData.sortedIndices[f].resize(n);
         std::iota(columnData.sortedIndices[f].begin(), columnData.sortedIndices[f].end(), 0);
-        std::sort(columnData.sortedIndices[f].begin(), columnData.sortedIndices[f].end(),
-                  [&](int a, int b) { return data[a * rowLength + f] < data[b * rowLength + f]; });
+        X.visitColumn(f, [&](const auto* col) {
+            std::sort(columnData.sortedIndices[f].begin(), columnData.sortedIndices[f].end(),
+                      [col](int a, int b) { return col[a] < col[b]; });
+        });
     }
-    
-   
-    columnData.values = data;
 
   
     const double baseScore = computeBaseScore(labels);
@@ -39,6 +45,8 @@ void XGBoostTrainer::train(const std::vector<double>& data, int rowLength, const
     std::vector<double> predictions(n, baseScore);
     std::vector<double> gradients(n), hessians(n);
     std::vector<char> rootMask(n, 1);
+    std::vector<int> subsampleIdx(config_.subsample < 1.0 ? n : 0);
+    std::vector<const Node*> rowLeaf(n);
 
     
     for (int round = 0; round < config_.numRounds; ++round) {
@@ -52,30 +60,27 @@ void XGBoostTrainer::train(const std::vector<double>& data, int rowLength, const
        
         if (config_.subsample < 1.0) {
             const size_t sampleSize = static_cast<size_t>(n * config_.subsample);
-            thread_local std::mt19937 gen(std::random_device{}());
-            thread_local std::vector<int> indices(n);
-            
-            if (indices.size() != n) {
-                indices.resize(n);
-                std::iota(indices.begin(), indices.end(), 0);
-            }
-            
-            std::shuffle(indices.begin(), indices.end(), gen);
+            // Round `round` draws from its own stream: reproducible for a given
+            // seed, and only the first sampleSize positions are shuffled
+            std::iota(subsampleIdx.begin(), subsampleIdx.end(), 0);
+            CounterRng rng(config_.seed, RngPurpose::RowSubsample, static_cast<uint32_t>(round));
+            rng.sampleToFront(subsampleIdx.begin(), subsampleIdx.end(), sampleSize);
             
             std::fill(rootMask.begin(), rootMask.end(), 0);
             for (size_t i = 0; i < sampleSize; ++i) {
-                rootMask[indices[i]] = 1;
+                rootMask[subsampleIdx[i]] = 1;
             }
         } else {
             std::fill(rootMask.begin(), rootMask.end(), 1);
         }
 
        
-        auto tree = trainSingleTree(columnData, gradients, hessians, rootMask);
+        std::fill(rowLeaf.begin(), rowLeaf.end(), nullptr);
+        auto tree = trainSingleTree(columnData, gradients, hessians, rootMask, rowLeaf);
         if (!tree) break;
 
         
-        updatePredictions(data, rowLength, tree.get(), predictions);
+        updatePredictions(X, tree.get(), rowLeaf, predictions);
         model_.addTree(std::move(tree), config_.eta);
 
       
@@ -88,9 +93,10 @@ void XGBoostTrainer::train(const std::vector<double>& data, int rowLength, const
 std::unique_ptr<Node> XGBoostTrainer::trainSingleTree(const ColumnData& columnData,
                                                      const std::vector<double>& gradients,
                                                      const std::vector<double>& hessians,
-                                                     const std::vector<char>& rootMask) const {
+                                                     const std::vector<char>& rootMask,
+                                                     std::vector<const Node*>& rowLeaf) const {
     auto root = std::make_unique<Node>();
-    buildXGBNode(root.get(), columnData, gradients, hessians, rootMask, 0);
+    buildXGBNode(root.get(), columnData, gradients, hessians, rootMask, rowLeaf, 0);
     return root;
 }
 
@@ -99,6 +105,7 @@ void XGBoostTrainer::buildXGBNode(Node* node,
                                   const std::vector<double>& gradients,
                                   const std::vector<double>& hessians,
                                   const std::vector<char>& nodeMask, 
+                                  std::vector<const Node*>& rowLeaf,
                                   int depth) const {
     const size_t n = nodeMask.size();
 
@@ -117,17 +124,25 @@ void XGBoostTrainer::buildXGBNode(Node* node,
     
     node->samples = sampleCount;
     const double leafWeight = xgbCriterion_->computeLeafWeight(G_parent, H_parent);
+    // Masks of sibling nodes are disjoint, so parallel siblings write distinct rows
+    auto makeLeaf = [&]() {
+        node->makeLeaf(leafWeight);
+        #pragma omp parallel for schedule(static) if(n > 1000)
+        for (size_t i = 0; i < n; ++i) {
+            if (nodeMask[i]) rowLeaf[i] = node;
+        }
+    };
 
  
     if (depth >= config_.maxDepth || sampleCount < 2 || H_parent < config_.minChildWeight) {
-        node->makeLeaf(leafWeight);
+        makeLeaf();
         return;
     }
 
     auto [bestFeature, bestThreshold, bestGain] = findBestSplitXGB(columnData, gradients, hessians, nodeMask);
 
     if (bestFeature < 0 || bestGain <= config_.gamma) {
-        node->makeLeaf(leafWeight);
+        makeLeaf();
         return;
     }
 
@@ -137,16 +152,18 @@ void XGBoostTrainer::buildXGBNode(Node* node,
  
     std::vector<char> leftMask(n, 0), rightMask(n, 0);
     
-    #pragma omp parallel for schedule(static) if(n > 1000)
-    for (size_t i = 0; i < n; ++i) {
-        if (!nodeMask[i]) continue;
-        const double val = columnData.values[i * columnData.numFeatures + bestFeature];
-        if (val <= bestThreshold) {
-            leftMask[i] = 1;
-        } else {
-            rightMask[i] = 1;
+    columnData.values.visitColumn(bestFeature, [&](const auto* splitColumn) {
+        #pragma omp parallel for schedule(static) if(n > 1000)
+        for (size_t i = 0; i < n; ++i) {
+            if (!nodeMask[i]) continue;
+            const double val = splitColumn[i];
+            if (val <= bestThreshold) {
+                leftMask[i] = 1;
+            } else {
+                rightMask[i] = 1;
+            }
         }
-    }
+    });
 
     
     node->leftChild = std::make_unique<Node>();
@@ -157,14 +174,14 @@ void XGBoostTrainer::buildXGBNode(Node* node,
         #pragma omp parallel sections
         {
             #pragma omp section
-            buildXGBNode(node->leftChild.get(), columnData, gradients, hessians, leftMask, depth + 1);
+            buildXGBNode(node->leftChild.get(), columnData, gradients, hessians, leftMask, rowLeaf, depth + 1);
             #pragma omp section
-            buildXGBNode(node->rightChild.get(), columnData, gradients, hessians, rightMask, depth + 1);
+            buildXGBNode(node->rightChild.get(), columnData, gradients, hessians, rightMask, rowLeaf, depth + 1);
         }
     } else {
         
-        buildXGBNode(node->leftChild.get(), columnData, gradients, hessians, leftMask, depth + 1);
-        buildXGBNode(node->rightChild.get(), columnData, gradients, hessians, rightMask, depth + 1);
+        buildXGBNode(node->leftChild.get(), columnData, gradients, hessians, leftMask, rowLeaf, depth + 1);
+        buildXGBNode(node->rightChild.get(), columnData, gradients, hessians, rightMask, rowLeaf, depth + 1);
     }
 }
 
@@ -222,35 +239,37 @@ std::tuple<int, double, double> XGBoostTrainer::findBestSplitXGB(
             if (nodeSorted.size() < 2) continue;
 
        
-            double G_left = 0.0, H_left = 0.0;
+            columnData.values.visitColumn(f, [&](const auto* col) {
+                double G_left = 0.0, H_left = 0.0;
             
-            for (size_t i = 0; i + 1 < nodeSorted.size(); ++i) {
-                const int idx = nodeSorted[i];
-                G_left += gradients[idx];
-                H_left += hessians[idx];
+                for (size_t i = 0; i + 1 < nodeSorted.size(); ++i) {
+                    const int idx = nodeSorted[i];
+                    G_left += gradients[idx];
+                    H_left += hessians[idx];
 
-                const int nextIdx = nodeSorted[i + 1];
-                const double currentVal = columnData.values[idx * columnData.numFeatures + f];
-                const double nextVal = columnData.values[nextIdx * columnData.numFeatures + f];
+                    const int nextIdx = nodeSorted[i + 1];
+                    const double currentVal = col[idx];
+                    const double nextVal = col[nextIdx];
 
-                if (std::abs(nextVal - currentVal) < EPS) continue;
+                    if (std::abs(nextVal - currentVal) < EPS) continue;
 
-                const double G_right = G_parent - G_left;
-                const double H_right = H_parent - H_left;
+                    const double G_right = G_parent - G_left;
+                    const double H_right = H_parent - H_left;
 
            
-                if (H_left < config_.minChildWeight || H_right < config_.minChildWeight) continue;
+                    if (H_left < config_.minChildWeight || H_right < config_.minChildWeight) continue;
 
               
-                const double gain = xgbCriterion_->computeSplitGain(
-                    G_left, H_left, G_right, H_right, G_parent, H_parent, config_.gamma);
-
-                if (gain > localBestGain) {
-                    localBestGain = gain;
-                    localBestFeature = f;
-                    localBestThreshold = 0.5 * (currentVal + nextVal);
+                    const double gain = xgbCriterion_->computeSplitGain(
+                        G_left, H_left, G_right, H_right, G_parent, H_parent, config_.gamma);
+
+                    if (gain > localBestGain) {
+                        localBestGain = gain;
+                        localBestFeature = f;
+                        localBestThreshold = 0.5 * (currentVal + nextVal);
+                    }
                 }
-            }
+            });
         }
         
   
@@ -267,18 +286,20 @@ std::tuple<int, double, double> XGBoostTrainer::findBestSplitXGB(
     return {bestFeature, bestThreshold, bestGain};
 }
 
-void XGBoostTrainer::updatePredictions(const std::vector<double>& data, int rowLength,
-                                      const Node* tree, std::vector<double>& predictions) const {
+void XGBoostTrainer::updatePredictions(const FeatureMatrix& X,
+                                      const Node* tree,
+                                      const std::vector<const Node*>& rowLeaf,
+                                      std::vector<double>& predictions) const {
     const size_t n = predictions.size();
     
     #pragma omp parallel for schedule(static, 256) if(n > 1000)
     for (size_t i = 0; i < n; ++i) {
-        const double* sample = &data[i * rowLength];
-        const Node* cur = tree;
+        // Rows the tree was grown on are gathered; only subsampled-out rows walk it
+        const Node* cur = rowLeaf[i] ? rowLeaf[i] : tree;
         
   
         while (cur && !cur->isLeaf) {
-            const double val = sample[cur->getFeatureIndex()];
+            const double val = X(i, cur->getFeatureIndex());
             cur = (val <= cur->getThreshold()) ? cur->getLeft() : cur->getRight();
         }
         